@@ -3,8 +3,26 @@
 
 layout(location = 0) in vec3 vertexPosition_modelspace;
 layout(location = 1) in vec2 vertexUV;
+#ifdef JE_COMPACT_VERTICES
+// Compact meshes (engine defines this for a second copy of the shader). Position already comes out right since
+// the engine folds the dequantization into model, the normal is octahedral.
+layout(location = 2) in vec2 vertexNormalOctahedral;
+
+vec3 decodeNormal() {
+    vec3 n = vec3(vertexNormalOctahedral, 1.0 - abs(vertexNormalOctahedral.x) - abs(vertexNormalOctahedral.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+#else
 layout(location = 2) in vec3 vertexNormal;
 
+vec3 decodeNormal() {
+    return vertexNormal;
+}
+#endif
+
 layout(push_constant) uniform PushConstants { // JE_TRANSLATE
     mat4 model;
     mat4 normal;
@@ -26,7 +44,7 @@ layout(location = 2) out vec3 vnorm;
 void main() {
     gl_Position = (_3dProj * viewMatrix * model) * vec4(vertexPosition_modelspace,1);
     vec4 pos = (model * vec4(vertexPosition_modelspace,1));
-    vec4 normalv4 = (normal * vec4(vertexNormal,1));
+    vec4 normalv4 = (normal * vec4(decodeNormal(),1));
     vpos = pos.xyz;
     uv = vertexUV;
     vnorm = normalv4.xyz;
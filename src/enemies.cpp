@@ -8,6 +8,9 @@
 #include "engine/gfx/modelutil.h"
 #include "engine/engine.h"
 #include "gamephysicslib.h"
+#include "engine/phys/spatialhashutil.h"
+#include "engine/phys/flowfieldutil.h"
+#include "engine/job/timerutil.h"
 #include <random>
 #include "engine/sound/audioutil.h"
 
@@ -30,92 +33,125 @@ Renderable enemy3Renderable;
 Renderable enemy_kill_me_please_renderable;
 Renderable bulletRenderable;
 
-std::vector<Transform> enemyWorldBoxColliders;
-std::vector<Sound> currentGunshotSounds;
+// The only bake of the map boxes, the player collides with it too through getWorldColliders
+JEColliderSet enemyWorldColliders;
+std::vector<JEMeshColliderLoad> enemyWorldMeshColliders;
+
+// Every enemy as of the start of the tick, rebuilt by rebuildEnemyGrid before anything else updates.
+// Cells a bit bigger than the biggest enemy, so separation checks look at a couple cells at most.
+#define ENEMY_GRID_CELL_SIZE 2.0f
+JESpatialHash enemyGrid;
+std::vector<vec3> enemyGridPositions;
+std::vector<float> enemyGridRadii;
+std::vector<std::string> enemyGridNames;
+std::vector<const GameObject*> enemyGridObjects; // Only for telling which one's which, may have been deleted since
+std::vector<uint32_t> enemyGridFound;
+
+// Same size as the enemy grid's cells
+#define ENEMY_FLOW_CELL_SIZE 2.0f
+// Room the biggest enemy needs next to walls, and at least half a cell's diagonal
+#define ENEMY_FLOW_CLEARANCE 1.75f
+// About half a millisecond of searching, so a whole map takes a handful of ticks
+#define ENEMY_FLOW_CELLS_PER_TICK 8192
+// Shortest way to the player from anywhere in the map, shared by the whole wave. Only searched again once the player
+// gets to a new cell.
+JEFlowField enemyFlowField;
+unsigned int gunfire0Buffer;
+unsigned int gunfire1Buffer;
 
 Transform temp_bullet_vals{};
 unsigned long temp_bullet_flags = 0;
 
 // Eject enemies from boxes they spawn inside.
 void ejectFromWorld(Transform* t) {
-    for (auto const& box : enemyWorldBoxColliders) {
-        while (testPoint(t->position, box)) {
-            t->position += vec3(0, 0.001, 0);
-        }
+    for (size_t box = 0; box < enemyWorldColliders.count; box++) {
+        t->position.y += exitDistance(enemyWorldColliders, box, t->position, vec3(0, 1, 0));
     }
 }
 
-void bullet_phys_step(double deltaTime, GameObject* self) {
-    self->transform.pos_vel *= vec3(0.999);
-    self->transform.position += self->transform.pos_vel * vec3(deltaTime);
-    if (pointCollidesWithAnyBoxes(self->transform.position, enemyWorldBoxColliders)) {
-        self->transform.pos_vel = vec3(0); // Essentially mark self for deletion (see runtimeCleanup)
-        return;
+// Every live bullet this tick, swept through the world all at once
+std::vector<GameObject*> bulletObjects;
+std::vector<vec3> bulletOrigins;
+std::vector<vec3> bulletMotions;
+std::vector<float> bulletRadii;
+std::vector<JESweepHit> bulletHits;
+
+void stepBullets(double deltaTime) {
+    bulletObjects.clear();
+    bulletOrigins.clear();
+    bulletMotions.clear();
+    bulletRadii.clear();
+    for (auto &g: *getGameObjects()) {
+        if (g.first.starts_with("bullet") && g.second.transform.pos_vel != vec3(0)) {
+            g.second.transform.pos_vel *= vec3(0.999);
+            bulletObjects.push_back(&g.second);
+            bulletOrigins.push_back(g.second.transform.position);
+            bulletMotions.push_back(g.second.transform.pos_vel * vec3(deltaTime));
+            bulletRadii.push_back(g.second.transform.scale.x);
+        }
+    }
+    // Swept instead of testing where it ends up, fast bullets at low framerates would go straight through thin stuff
+    bulletHits.resize(bulletObjects.size());
+    sweepColliders(enemyWorldColliders, bulletOrigins, bulletMotions, bulletRadii, bulletHits);
+    for (const JEMeshColliderLoad& load : enemyWorldMeshColliders) {
+        const JEMeshCollider* mesh = finishedMeshCollider(load);
+        if (mesh == nullptr) continue;
+        for (size_t i = 0; i < bulletObjects.size(); i++) {
+            float time = sweepSphereMesh(*mesh, {bulletOrigins[i], bulletMotions[i], bulletRadii[i]}).time;
+            if (time < bulletHits[i].time) bulletHits[i].time = time;
+        }
     }
-    if (testSpheres(self->transform.position, self->transform.scale.x*3, cameraAccess()->position, 1.5)) {
-        self->transform.pos_vel = vec3(0); // Essentially mark self for deletion (see runtimeCleanup)
-        (*getHealthPtr()) -= self->flags;
-        if (*getHealthPtr() < 0) *getHealthPtr() = 0;
+
+    Transform* cameraPtr = cameraAccess();
+    for (size_t i = 0; i < bulletObjects.size(); i++) {
+        Transform& bullet = bulletObjects[i]->transform;
+        bool hitWorld = bulletHits[i].time <= 1;
+        bullet.position = bulletOrigins[i] + bulletMotions[i] * vec3(hitWorld ? bulletHits[i].time : 1);
+        if (testSweptSpheres(bulletOrigins[i], bullet.position, bullet.scale.x*3, cameraPtr->position, 1.5)) {
+            bullet.pos_vel = vec3(0); // Essentially mark self for deletion (see runtimeCleanup)
+            (*getHealthPtr()) -= bulletObjects[i]->flags;
+            if (*getHealthPtr() < 0) *getHealthPtr() = 0;
+        } else if (hitWorld) {
+            bullet.pos_vel = vec3(0); // Essentially mark self for deletion (see runtimeCleanup)
+        }
     }
 }
 
 void bulletGameObject(GameObject* self) {
     self->transform = temp_bullet_vals;
     self->renderables.push_back(bulletRenderable);
-    self->onUpdate.push_back(&bullet_phys_step);
     self->flags = temp_bullet_flags;
     bulletCount++;
 }
 
-void enemyMovementAI(double deltaTime, GameObject* self) {
-    if ((self->flags & 0x1000000000000000) == 0) {
-        Transform *cameraPtr = cameraAccess();
-        // Look at player
-        double xdif = self->transform.position.x - cameraPtr->position.x;
-        double zdif = self->transform.position.z - cameraPtr->position.z;
-        self->transform.rotation.y = glm::degrees(atan(xdif / zdif)) + (zdif > 0 ? 90 : 270);
+// Shoots on its next frame, which has the deltaTime bullet speed goes off of
+void enemyReadyToFire(GameObject* self) {
+    self->flags = 0x1000000000000000;
+}
 
-        double horizontal_dist = -sqrt(xdif * xdif + zdif * zdif);
-        double ydif = self->transform.position.y - cameraPtr->position.y;
-        float rot = glm::degrees(atan(ydif / (horizontal_dist)));
-        self->transform.rotation.z = glm::max(glm::min(rot, 45.0f), -45.0f);
+// Anywhere from right away to 10 seconds away at scale 1, smaller enemies fire faster
+void scheduleEnemyShot(GameObject* self) {
+    scheduleAfter(static_cast<float>(rand()%200) * self->transform.scale.x / 20.0f, &enemyReadyToFire, self);
+}
 
+// Every frame, so they move smoothly and don't go through things however rarely they get to think. Shoots once its shot
+// timer goes off.
+void enemyMovementAI(double deltaTime, GameObject* self) {
+    if ((self->flags & 0x1000000000000000) == 0) {
         // Physics ease TODO: More dumbness
         self->transform.pos_vel *= (vec3(1) - self->transform.scale) * vec3(1.7);
 
-        // Horizontal positioning
-        self->transform.pos_vel +=
-                (normalize(vec3(xdif, 0, zdif)) * vec3(8)) / vec3(horizontal_dist > -10 ? 0.25 : -0.25) *
-                vec3(deltaTime);
-
-        // Vertical positioning
-        if (rot != self->transform.rotation.z && horizontal_dist > -8) {
-            if (self->transform.position.y < cameraPtr->position.y - 1) {
-                self->transform.pos_vel.y += deltaTime * 100;
-            } else if (self->transform.position.y > cameraPtr->position.y + 1) {
-                self->transform.pos_vel.y -= deltaTime * 100;
-            }
-        }
-
-        std::vector<Transform> enemyColliders(enemyMax);
-        int i = 0;
-        for (auto const &g: *getGameObjects()) {
-            if (g.first.starts_with("enemy") &&
-                (static_cast<vec3>(g.second.transform.position) != self->transform.position)) {
-                enemyColliders[i] = g.second.transform;
-                i++;
-            }
-        }
+        // Other enemies bumping into this one. Only the cells around it get looked at.
+        querySpatialHash(enemyGrid, self->transform.position, self->transform.scale.x, enemyGridFound);
+        bool touchingEnemy = std::ranges::any_of(enemyGridFound, [self](uint32_t other) { return enemyGridObjects[other] != self; });
 
-        //self->transform.position += self->transform.direction() * vec3(deltaTime);
-        if (pointCollidesWithAnyBoxes   (self->transform.position, enemyWorldBoxColliders) ||
-            sphereCollidesWithAnySpheres(self->transform, enemyColliders)) // This is faster than boxes because of rotation taking so damn long on the CPU
+        if (pointCollidesWithAnyBoxes(self->transform.position, enemyWorldColliders) || touchingEnemy)
             self->transform.pos_vel *= vec3(-1);
         self->transform.position += self->transform.pos_vel * vec3(deltaTime);
     } else {
         // Reset timer
-        self->flags = static_cast<uint64_t>(rand()%200) << 32;
-
+        self->flags = 0;
+        scheduleEnemyShot(self);
 
         // Set up bullet transform
         temp_bullet_vals = Transform{};
@@ -123,14 +159,12 @@ void enemyMovementAI(double deltaTime, GameObject* self) {
         temp_bullet_vals.pos_vel = normalize(cameraAccess()->position-self->transform.position) * vec3(deltaTime) * vec3(3000/self->transform.scale.x);
         temp_bullet_vals.rotation = self->transform.rotation;
         if (self->transform.scale.x > 0.5) {
-            // Play sound
-            currentGunshotSounds.emplace_back(self->transform.position, vec3(0), "./sounds/gunfire0.ogg",  false, 3, 0.1, 2, 2);
-            currentGunshotSounds[currentGunshotSounds.size()-1].play();
+            // Play sound. Big guns win over small ones if there aren't enough voices to go around.
+            playAt(gunfire0Buffer, self->transform.position, 1, 2);
             temp_bullet_vals.scale = vec3(0.15);
         } else {
             // Play sound
-            currentGunshotSounds.emplace_back(self->transform.position, vec3(0), "./sounds/gunfire1.ogg",  false, 3, 0.1, 2, 0.5);
-            currentGunshotSounds[currentGunshotSounds.size()-1].play();
+            playAt(gunfire1Buffer, self->transform.position, 0, 0.5);
             temp_bullet_vals.scale = vec3(0.05);
         }
 
@@ -139,14 +173,38 @@ void enemyMovementAI(double deltaTime, GameObject* self) {
     }
 }
 
-void enemy1GunAI(double deltaTime, GameObject* self) {
-    if (std::bit_cast<float>(static_cast<uint32_t>(self->flags)) > (static_cast<float>((self->flags & 0x000000FF00000000) >> 32)*self->transform.scale.x)/20.0f) {
-        self->flags = 0x1000000000000000;
+// As often as the enemy's update band allows, with all the time since it last ran. Looks at the player and steers.
+void enemySteeringAI(double deltaTime, GameObject* self) {
+    if ((self->flags & 0x1000000000000000) != 0) return;
+    Transform *cameraPtr = cameraAccess();
+    // Look at player
+    double xdif = self->transform.position.x - cameraPtr->position.x;
+    double zdif = self->transform.position.z - cameraPtr->position.z;
+    self->transform.rotation.y = glm::degrees(atan(xdif / zdif)) + (zdif > 0 ? 90 : 270);
+
+    double horizontal_dist = -sqrt(xdif * xdif + zdif * zdif);
+    double ydif = self->transform.position.y - cameraPtr->position.y;
+    float rot = glm::degrees(atan(ydif / (horizontal_dist)));
+    self->transform.rotation.z = glm::max(glm::min(rot, 45.0f), -45.0f);
+
+    // Closing in. Far away it follows the flow field around whatever's in the way, up close (or with no
+    // way through) it's straight at or away from the player.
+    vec3 flowDirection;
+    if (horizontal_dist <= -10 && sampleFlowField(enemyFlowField, self->transform.position, flowDirection)) {
+        self->transform.pos_vel += flowDirection * vec3(32) * vec3(deltaTime);
     } else {
-        self->flags =
-                (self->flags & 0xFFFFFFFF00000000) // Maintain upper half data
-                /*     bit cast to low bits    bit cast the existing data to a float                 add statically casted deltatime  */
-                | std::bit_cast<uint32_t>(std::bit_cast<float>(static_cast<uint32_t>(self->flags)) + static_cast<float>(deltaTime));
+        self->transform.pos_vel +=
+                (normalize(vec3(xdif, 0, zdif)) * vec3(8)) / vec3(horizontal_dist > -10 ? 0.25 : -0.25) *
+                vec3(deltaTime);
+    }
+
+    // Vertical positioning
+    if (rot != self->transform.rotation.z && horizontal_dist > -8) {
+        if (self->transform.position.y < cameraPtr->position.y - 1) {
+            self->transform.pos_vel.y += deltaTime * 100;
+        } else if (self->transform.position.y > cameraPtr->position.y + 1) {
+            self->transform.pos_vel.y -= deltaTime * 100;
+        }
     }
 }
 
@@ -155,18 +213,16 @@ void enemy1Object(GameObject* self){
     self->transform.scale    = vec3(0.5);
     self->renderables.push_back(enemy1Renderable);
     self->onUpdate.push_back(&enemyMovementAI);
-    self->onUpdate.push_back(&enemy1GunAI);
+    self->onScheduledUpdate.push_back(&enemySteeringAI);
     ejectFromWorld(&self->transform);
-    self->flags = static_cast<uint64_t>(rand()%200) << 32;
 }
 void enemyKMSObject(GameObject* self){
     self->transform.position = vec3(15-(rand()%30), (rand()%12)*2 + cameraAccess()->position.y, 15-(rand()%30));
     self->transform.scale    = vec3(0.5);
     self->renderables.push_back(enemy_kill_me_please_renderable);
     self->onUpdate.push_back(&enemyMovementAI);
-    self->onUpdate.push_back(&enemy1GunAI);
+    self->onScheduledUpdate.push_back(&enemySteeringAI);
     ejectFromWorld(&self->transform);
-    self->flags = static_cast<uint64_t>(rand()%200) << 32;
 }
 
 void enemy2Object(GameObject* self){
@@ -174,9 +230,8 @@ void enemy2Object(GameObject* self){
     self->transform.scale    = vec3(0.65);
     self->renderables.push_back(enemy2Renderable);
     self->onUpdate.push_back(&enemyMovementAI);
-    self->onUpdate.push_back(&enemy1GunAI);
+    self->onScheduledUpdate.push_back(&enemySteeringAI);
     ejectFromWorld(&self->transform);
-    self->flags = static_cast<uint64_t>(rand()%200) << 32;
 }
 
 void enemy3Object(GameObject* self){
@@ -184,13 +239,41 @@ void enemy3Object(GameObject* self){
     self->transform.scale    = vec3(0.45);
     self->renderables.push_back(enemy3Renderable);
     self->onUpdate.push_back(&enemyMovementAI);
-    self->onUpdate.push_back(&enemy1GunAI);
+    self->onScheduledUpdate.push_back(&enemySteeringAI);
     ejectFromWorld(&self->transform);
-    self->flags = static_cast<uint64_t>(rand()%200) << 32;
+}
+
+void updateEnemyFlowField(double dt) {
+    setFlowFieldTarget(enemyFlowField, cameraAccess()->position);
+    stepFlowField(enemyFlowField, ENEMY_FLOW_CELLS_PER_TICK);
+}
+
+void rebuildEnemyGrid(double dt) {
+    enemyGridPositions.clear();
+    enemyGridRadii.clear();
+    enemyGridNames.clear();
+    enemyGridObjects.clear();
+    for (auto const &g: *getGameObjects()) {
+        if (g.first.starts_with("enemy")) {
+            enemyGridPositions.push_back(g.second.transform.position);
+            enemyGridRadii.push_back(g.second.transform.scale.x);
+            enemyGridNames.push_back(g.first);
+            enemyGridObjects.push_back(&g.second);
+        }
+    }
+    buildSpatialHash(enemyGrid, enemyGridPositions, enemyGridRadii, ENEMY_GRID_CELL_SIZE);
+}
+
+void findEnemiesNear(vec3 point, float radius, std::vector<std::string>& names) {
+    names.clear();
+    querySpatialHash(enemyGrid, point, radius, enemyGridFound);
+    for (uint32_t enemy : enemyGridFound) {
+        // Might've been killed since the grid was built
+        if (getGameObjects()->contains(enemyGridNames[enemy])) names.push_back(enemyGridNames[enemy]);
+    }
 }
 
 void runtimeCleanup(double dt) {
-    if (currentGunshotSounds.size() > 0 && !currentGunshotSounds[0].isPlaying()) currentGunshotSounds[0].deleteSource();
     std::vector<std::string> cleanNames{};
     const float removeBulletSpeed = 8; // Bullets that fly into the distance usually go under about here after getting into the 200s
     for (auto const &g: *getGameObjects()) {
@@ -204,57 +287,71 @@ void runtimeCleanup(double dt) {
 }
 
 void enemySystemInit(){
-    // Load the ogg file early by creating a Sound
-    Sound preloadAudio = Sound(vec3(0), vec3(0), "./sounds/gunfire0.ogg",  false, 3, 0.1, 2, 0.25);
-    preloadAudio = Sound(vec3(0), vec3(0), "./sounds/gunfire1.ogg",  false, 3, 0.1, 2, 0.25);
-    preloadAudio.stop(); // Force the compiler to care about the Sound object.
-
-    createTexture("enemy1", "./textures/enemy1_tex.png", "./tex_bundle.jbd");
-    createTexture("enemy2", "./textures/enemy2_tex.png", "./tex_bundle.jbd");
-    createTexture("enemy3", "./textures/enemy3_tex.png", "./tex_bundle.jbd");
-    createTexture("bullet", "./textures/bullet_tex.png", "./tex_bundle.jbd");
-    createTexture("bullet_specmis", "./textures/bullet_specmis.png", "./tex_bundle.jbd");
-    createTexture("enemy_specmis", "./textures/enemy_specmis.png", "./tex_bundle.jbd");
-    enemy1Renderable = loadObj("./models/enemy1.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("enemy1"), getTexture("enemy_specmis")})[0];
-    enemy2Renderable = loadObj("./models/enemy1.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("enemy2"), getTexture("enemy_specmis")})[0];
-    enemy3Renderable = loadObj("./models/enemy1.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("enemy3"), getTexture("enemy_specmis")})[0];
-    bulletRenderable = loadObj("./models/enemy1_bullet.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("bullet"), getTexture("bullet_specmis")})[0];
+    gunfire0Buffer = oggToBuffer("./sounds/gunfire0.ogg", "./sound_bundle.jbd");
+    gunfire1Buffer = oggToBuffer("./sounds/gunfire1.ogg", "./sound_bundle.jbd");
+
+    createTextureAsync("enemy1", "./textures/enemy1_tex.png", "./tex_bundle.jbd");
+    createTextureAsync("enemy2", "./textures/enemy2_tex.png", "./tex_bundle.jbd");
+    createTextureAsync("enemy3", "./textures/enemy3_tex.png", "./tex_bundle.jbd");
+    createTextureAsync("bullet", "./textures/bullet_tex.png", "./tex_bundle.jbd");
+    createTextureAsync("bullet_specmis", "./textures/bullet_specmis.png", "./tex_bundle.jbd");
+    createTextureAsync("enemy_specmis", "./textures/enemy_specmis.png", "./tex_bundle.jbd");
+    enemy1Renderable = loadObjAsync("./models/enemy1.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("enemy1"), getTexture("enemy_specmis")});
+    enemy2Renderable = loadObjAsync("./models/enemy1.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("enemy2"), getTexture("enemy_specmis")});
+    enemy3Renderable = loadObjAsync("./models/enemy1.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("enemy3"), getTexture("enemy_specmis")});
+    bulletRenderable = loadObjAsync("./models/enemy1_bullet.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("bullet"), getTexture("bullet_specmis")});
 
     // Welp, accidentally left these notes while streaming development to Gamer girl ultrakill.
     // So much for the funny easter egg.
-    createTexture("enemy_why_are_you_reading_the_ram_dump_laika", "./textures/stop_going_through_game_files_via_this_isnt_ddlc.png", "./tex_bundle.jbd");
-    enemy_kill_me_please_renderable = loadObj("./models/stop_going_through_game_files_via_this_isnt_ddlc.obj",
-                                              getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("enemy_why_are_you_reading_the_ram_dump_laika")})[0];
+    createTextureAsync("enemy_why_are_you_reading_the_ram_dump_laika", "./textures/stop_going_through_game_files_via_this_isnt_ddlc.png", "./tex_bundle.jbd");
+    enemy_kill_me_please_renderable = loadObjAsync("./models/stop_going_through_game_files_via_this_isnt_ddlc.obj",
+                                                   getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("enemy_why_are_you_reading_the_ram_dump_laika")});
 
+    // Enemies think less the farther away they are, and never for more than a millisecond a frame all together.
+    // Close ones still get every frame, they're the ones anyone would notice.
+    setUpdateBands({{15, 1}, {30, 2}, {60, 4}, {INFINITY, 8}});
+    setScheduledUpdateBudget(1.0);
+
+    // Has to be registered before anything that asks it about enemies
+    registerOnUpdate(&updateEnemyFlowField);
+    registerOnUpdate(&rebuildEnemyGrid);
+    registerOnUpdate(&stepBullets);
     registerOnUpdate(&runtimeCleanup);
 }
 
+// Their first shot can't be scheduled from their init functions, they aren't in the map yet
+void putEnemy(const std::string& name, void (*initFunc)(GameObject* g)) {
+    if (getGameObjects()->contains(name)) return;
+    putGameObject(name, GameObject(initFunc));
+    scheduleEnemyShot(&getGameObject(name));
+}
+
 void instantiateRandomEnemyWave(int count){
     enemyMax = count;
     for (int i = 0; i < count; i++){
         int random = rand();
         if (random%7250 == 420) { // 7250 is oddly specific but argued with via over this number
             // Secret uwu enemy
-            putGameObject("enemy_stop_reading_ram_dumps_rose" + std::to_string(i), GameObject(&enemyKMSObject));
+            putEnemy("enemy_stop_reading_ram_dumps_rose" + std::to_string(i), &enemyKMSObject);
         } else {
             switch (random%3) {
                 case (2): {
                     if (enemyMax > 30) { // Natural progression to keep the game interesting
                         // Chunky Boi
-                        putGameObject("enemy2_" + std::to_string(i), GameObject(&enemy2Object));
+                        putEnemy("enemy2_" + std::to_string(i), &enemy2Object);
                         break;
                     }
                 }
                 case (1): {
                     if (enemyMax > 10) {
                         // Little Bitchass
-                        putGameObject("enemy3_" + std::to_string(i), GameObject(&enemy3Object));
+                        putEnemy("enemy3_" + std::to_string(i), &enemy3Object);
                         break;
                     }
                 }
                 default: {
                     // Default
-                    putGameObject("enemy1_" + std::to_string(i), GameObject(&enemy1Object));
+                    putEnemy("enemy1_" + std::to_string(i), &enemy1Object);
                 }
             }
         }
@@ -262,5 +359,20 @@ void instantiateRandomEnemyWave(int count){
 }
 
 void initWorldBoxColliders(std::vector<Transform> boxes){
-    enemyWorldBoxColliders = boxes; // wow what creative code
-}
\ No newline at end of file
+    enemyWorldColliders = bakeColliders(boxes);
+    if (enemyWorldColliders.bvh.nodes.empty()) {
+        enemyFlowField = JEFlowField{};
+        return;
+    }
+    // Whole map, plus room above it for enemies spawning up to 22 over the player
+    const JEBVHNode& map = enemyWorldColliders.bvh.nodes[0];
+    enemyFlowField = buildFlowField(enemyWorldColliders, map.min - vec3(4), map.max + vec3(4, 32, 4), ENEMY_FLOW_CELL_SIZE, ENEMY_FLOW_CLEARANCE);
+}
+
+const JEColliderSet& getWorldColliders(){
+    return enemyWorldColliders;
+}
+
+void initWorldMeshColliders(std::vector<JEMeshColliderLoad> meshes){
+    enemyWorldMeshColliders = std::move(meshes);
+}
@@ -6,9 +6,21 @@
 #define JOSHENGINE_ENEMIES_H
 
 #include "engine/engine.h"
+#include "engine/phys/meshcolliderutil.h"
 
 void enemySystemInit();
 void instantiateRandomEnemyWave(int count);
 void initWorldBoxColliders(std::vector<Transform> boxes);
+/**
+ * The map's box colliders, baked once by initWorldBoxColliders and shared with the player.
+ * @return The baked set, empty before a map loads
+ */
+const JEColliderSet& getWorldColliders();
+void initWorldMeshColliders(std::vector<JEMeshColliderLoad> meshes);
+/**
+ * Enemies whose sphere overlaps this one, as of the start of the tick (minus any killed since).
+ * @param names Cleared, then filled with GameObject names
+ */
+void findEnemiesNear(vec3 point, float radius, std::vector<std::string>& names);
 
 #endif //JOSHENGINE_ENEMIES_H
@@ -8,9 +8,17 @@
 #include <iostream>
 #include <unordered_map>
 #include <queue>
+#include <chrono>
+#include <memory>
+#include <fstream>
+#include <algorithm>
 #include "gfx/modelutil.h"
+#include "gfx/texutil.h"
 #include "debug/debugutil.h"
 #include "jbd/bundleutil.h"
+#include "job/jobutil.h"
+#include "job/timerutil.h"
+#include <stb_image.h>
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/euler_angles.hpp>
@@ -28,6 +36,13 @@ std::vector<void (*)(int button, bool pressed, double dt)> onMouse;
 
 std::unordered_map<std::string, GameObject> gameObjects = {};
 
+std::vector<JEUpdateBand> updateBands;
+double scheduledUpdateBudget = 0; // ms, 0 for no limit
+uint64_t scheduledUpdateFrame = 0;
+uint32_t nextUpdateBucket = 0;
+// Objects with scheduled updates due this frame. Map nodes don't move, so these stay good until something's deleted.
+std::vector<GameObject*> dueScheduledUpdates;
+
 Renderable skybox;
 Transform camera(glm::vec3(0, 0, 5), glm::vec3(180, 0, 0), glm::vec3(1));
 vec2 clippingPlanesPerspective{0.01f, 500.0f};
@@ -36,6 +51,8 @@ bool keys[GLFW_KEY_LAST];
 bool mouseButtons[GLFW_MOUSE_BUTTON_8-GLFW_MOUSE_BUTTON_1];
 
 std::unordered_map<std::string, unsigned int> programs;
+// Shader programs still compiling on job workers, moved into programs the first time someone asks for them.
+std::unordered_map<std::string, std::shared_future<unsigned int>> pendingPrograms;
 std::unordered_map<std::string, unsigned int> textures;
 
 std::vector<void (*)()> imGuiCalls;
@@ -159,6 +176,8 @@ std::unordered_map<std::string, GameObject>* getGameObjects() {
 
 void clearGameObjects() {
     gameObjects = {};
+    dueScheduledUpdates.clear();
+    cancelAllObjectTimers();
     skipUpdate(); // prevent the gameobject update loop from accessing a null reference
 }
 
@@ -172,7 +191,38 @@ void createShader(const std::string& name, const std::string& vertex, const std:
     programs.insert({name, createProgram(vertID, fragID, settings)});
 }
 
+void createShaderAsync(const std::string& name, const std::string& vertex, const std::string& fragment, const JEShaderProgramSettings& settings) {
+    std::shared_ptr<std::promise<unsigned int>> programPromise = std::make_shared<std::promise<unsigned int>>();
+    pendingPrograms.insert({name, programPromise->get_future().share()});
+    submitJob([programPromise, vertex, fragment, settings]() {
+        // Fragment compile goes on its own worker, the vertex one happens here.
+        std::shared_ptr<unsigned int> fragID = std::make_shared<unsigned int>();
+        JEJob fragJob = submitJob([fragID, fragment]() {
+            *fragID = loadShader(fragment, JE_FRAGMENT_SHADER);
+        });
+        try {
+            unsigned int vertID = loadShader(vertex, JE_VERTEX_SHADER);
+            waitForJobs({fragJob});
+            programPromise->set_value(createProgram(vertID, *fragID, settings));
+        } catch (...) {
+            programPromise->set_exception(std::current_exception());
+        }
+    });
+}
+
+void waitForShaders() {
+    for (auto& pending : pendingPrograms) {
+        programs.insert({pending.first, pending.second.get()});
+    }
+    pendingPrograms.clear();
+}
+
 unsigned int getShader(const std::string& name) {
+    if (!programs.contains(name) && pendingPrograms.contains(name)) {
+        // Only blocks if the workers haven't gotten to it yet.
+        programs.insert({name, pendingPrograms.at(name).get()});
+        pendingPrograms.erase(name);
+    }
     return programs.at(name);
 }
 
@@ -195,8 +245,14 @@ unsigned int createTexture(const std::string& name, const std::string& filePath)
 unsigned int createTexture(const std::string& name, const std::string& filePath, const std::string& bundleFilePath) {
     unsigned int id;
     try {
-        std::vector<unsigned char> file = getFileCharVec(filePath, bundleFilePath);
-        id = loadBundledTexture(reinterpret_cast<char *>(&file[0]), file.size(), currentFilterMode);
+        std::vector<std::byte> storage;
+        std::span<const std::byte> file = getBundledFile(filePath, bundleFilePath, storage);
+        auto bytes = reinterpret_cast<const unsigned char*>(file.data());
+        if (isCookedTexture(bytes, file.size())) {
+            id = loadCookedTexture(bytes, file.size(), currentFilterMode);
+        } else {
+            id = loadBundledTexture(bytes, file.size(), currentFilterMode);
+        }
     } catch (std::runtime_error &e) {
         id = textures.at("missing");
         std::cerr << "Failed to create \"" << name << "\" from file at path " << filePath << "! Texture ID will be set to missing." << std::endl;
@@ -205,6 +261,67 @@ unsigned int createTexture(const std::string& name, const std::string& filePath,
     return id;
 }
 
+unsigned int createTextureAsync(const std::string& name, const std::string& filePath, const std::string& bundleFilePath) {
+    // Maps ask for their textures every time they load, only the first one does anything
+    if (textures.contains(name)) return textures.at(name);
+    // Hands out the real ID now, it just draws as missing until a worker has decoded it and renderFrame uploads it.
+    unsigned int id = reserveTexture(textures.at("missing"));
+    textures.insert({name, id});
+    int filter = currentFilterMode;
+    submitJob([id, name, filePath, bundleFilePath, filter]() {
+        int texWidth = 0, texHeight = 0, texChannels;
+        stbi_uc* pixels = nullptr;
+        std::span<const std::byte> cooked;
+        std::vector<std::byte> storage;
+        // The non _thread version is a global, which workers can't share.
+        stbi_set_flip_vertically_on_load_thread(true);
+        try {
+            // Loose files get read in, bundled ones are used straight out of the mapping (or decompressed here on the worker).
+            std::span<const std::byte> file;
+            if (bundleFilePath.empty()) {
+                std::ifstream stream(filePath, std::ios::binary | std::ios::ate);
+                if (!stream.is_open()) throw std::runtime_error("Couldn't open " + filePath);
+                storage.resize(static_cast<size_t>(stream.tellg()));
+                stream.seekg(0);
+                stream.read(reinterpret_cast<char*>(storage.data()), static_cast<std::streamsize>(storage.size()));
+                file = storage;
+            } else {
+                file = getBundledFile(filePath, bundleFilePath, storage);
+            }
+            auto bytes = reinterpret_cast<const unsigned char*>(file.data());
+            if (isCookedTexture(bytes, file.size())) {
+                // Mips are already in there, just check it's sane (and unpack it if the GPU can't do BC) off the main thread.
+                // Goes to flushUploads as is, the only copy it gets is the one into staging.
+                parseCookedTexture(bytes, file.size());
+                if (isBlockCompressionSupported()) {
+                    cooked = file;
+                } else {
+                    std::vector<unsigned char> unpacked = decompressCookedTexture(bytes, file.size());
+                    storage.assign(reinterpret_cast<const std::byte*>(unpacked.data()), reinterpret_cast<const std::byte*>(unpacked.data()) + unpacked.size());
+                    cooked = storage;
+                }
+            } else {
+                pixels = stbi_load_from_memory(bytes, static_cast<int>(file.size()), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+                storage = {}; // Decoded, so the upload doesn't need to hang on to the file
+            }
+        } catch (std::runtime_error &e) {
+            pixels = nullptr;
+            cooked = {};
+        }
+        if (!pixels && cooked.empty()) {
+            std::cerr << "Failed to create \"" << name << "\" from file at path " << filePath << "! Texture ID will be left as missing." << std::endl;
+            return;
+        }
+        // Moving storage doesn't move its bytes, so cooked still points at them
+        queueTextureUpload({id, pixels, texWidth, texHeight, filter, cooked, std::move(storage)});
+    });
+    return id;
+}
+
+unsigned int createTextureAsync(const std::string& name, const std::string& filePath) {
+    return createTextureAsync(name, filePath, "");
+}
+
 bool textureExists(const std::string &name) {
     return textures.count(name);
 }
@@ -303,8 +420,55 @@ void registerOnMouse(void (*function)(int button, bool pressed, double dt)) {
     onMouse.push_back(function);
 }
 
+void setUpdateBands(const std::vector<JEUpdateBand>& bands) {
+    updateBands = bands;
+}
+
+void setScheduledUpdateBudget(double milliseconds) {
+    scheduledUpdateBudget = milliseconds;
+}
+
+bool scheduledUpdateDue(const GameObject& g) {
+    if (g.missedScheduledUpdate || updateBands.empty()) return true;
+    glm::vec3 offset = g.transform.position - camera.position;
+    float distance = glm::length(offset);
+    size_t band = 0;
+    while (band + 1 < updateBands.size() && distance > updateBands[band].maxDistance) band++;
+    // Can't see it, so it can wait a bit longer
+    if (band + 1 < updateBands.size() && glm::dot(offset, camera.direction()) < 0) band++;
+    unsigned int interval = std::max(updateBands[band].interval, 1u);
+    return (scheduledUpdateFrame + g.updateBucket) % interval == 0;
+}
+
+void runScheduledUpdates() {
+    // Whatever missed out last frame first, so nothing gets starved by the budget
+    std::stable_partition(dueScheduledUpdates.begin(), dueScheduledUpdates.end(), [](GameObject* g) { return g != nullptr && g->missedScheduledUpdate; });
+    double start = glfwGetTime();
+    for (size_t i = 0; i < dueScheduledUpdates.size(); i++) {
+        GameObject* g = dueScheduledUpdates[i];
+        if (g == nullptr) continue;
+        if (scheduledUpdateBudget > 0 && (glfwGetTime() - start) * 1000 > scheduledUpdateBudget) {
+            for (; i < dueScheduledUpdates.size(); i++) {
+                if (dueScheduledUpdates[i] != nullptr) dueScheduledUpdates[i]->missedScheduledUpdate = true;
+            }
+            break;
+        }
+        double dt = g->scheduledDeltaTime;
+        g->scheduledDeltaTime = 0;
+        g->missedScheduledUpdate = false;
+        for (auto &gameObjectFunction: g->onScheduledUpdate) {
+            gameObjectFunction(dt, g);
+            if (forceSkipUpdate) break;
+        }
+        if (forceSkipUpdate) break;
+    }
+    dueScheduledUpdates.clear();
+}
+
 void putGameObject(const std::string& name, const GameObject& g) {
-    gameObjects.insert({name, g});
+    auto [inserted, added] = gameObjects.insert({name, g});
+    // Round robin, so a wave spawned all at once doesn't all update on the same frame
+    if (added) inserted->second.updateBucket = nextUpdateBucket++;
 }
 
 GameObject& getGameObject(const std::string& name) {
@@ -312,7 +476,12 @@ GameObject& getGameObject(const std::string& name) {
 }
 
 void deleteGameObject(const std::string& name) {
-    gameObjects.erase(name);
+    auto found = gameObjects.find(name);
+    if (found == gameObjects.end()) return;
+    // Deleted while the update loop's going, don't let the scheduled pass get to it
+    std::replace(dueScheduledUpdates.begin(), dueScheduledUpdates.end(), &found->second, static_cast<GameObject*>(nullptr));
+    cancelObjectTimers(&found->second);
+    gameObjects.erase(found);
 }
 
 int getCurrentWidth() {
@@ -330,7 +499,12 @@ void framebuffer_size_callback(GLFWwindow* windowInstance,[[maybe_unused]] int u
     resizeViewport();
 }
 
+// Used to print time-to-first-frame, which is the number to watch when touching anything startup related.
+std::chrono::steady_clock::time_point initStartTime;
+bool firstFrameDrawn = false;
+
 void init(const char* windowName, int width, int height, JEGraphicsSettings graphicsSettings) {
+    initStartTime = std::chrono::steady_clock::now();
     std::cout << "JoshEngine " << ENGINE_VERSION_STRING << std::endl;
     std::cout << "Starting engine init." << std::endl;
 
@@ -340,6 +514,7 @@ void init(const char* windowName, int width, int height, JEGraphicsSettings grap
     ambient = {glm::max(graphicsSettings.clearColor[0] - 0.5f, 0.1f), glm::max(graphicsSettings.clearColor[1] - 0.5f, 0.1f), glm::max(graphicsSettings.clearColor[2] - 0.5f, 0.1f)};
     clearColor = vec3(graphicsSettings.clearColor[0], graphicsSettings.clearColor[1], graphicsSettings.clearColor[2]);
 
+    initJobs();
     initGFX(&window, windowName, width, height, graphicsSettings);
 
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
@@ -359,7 +534,7 @@ void init(const char* windowName, int width, int height, JEGraphicsSettings grap
 
     if (graphicsSettings.skybox) {
         // Skybox init
-        createShader("skybox",
+        createShaderAsync("skybox",
                      "./shaders/skybox_vertex.glsl",
                      "./shaders/skybox_fragment.glsl",
                 // hacky bullshit. don't depth test, disable depth writes (transparency mode :skull:)
@@ -388,7 +563,11 @@ void init(const char* windowName, int width, int height, JEGraphicsSettings grap
 }
 
 void deinit() {
+    // Lets anything still compiling finish before the device goes away.
+    deinitJobs();
     deinitGFX();
+    deinitAudio();
+    closeBundles();
 }
 
 float fov = 78.0f;
@@ -465,9 +644,18 @@ void mainLoop() {
                     if (forceSkipUpdate) break;
                 }
                 if (forceSkipUpdate) break;
+                if (!g.second.onScheduledUpdate.empty()) {
+                    g.second.scheduledDeltaTime += deltaTime;
+                    if (scheduledUpdateDue(g.second)) dueScheduledUpdates.push_back(&g.second);
+                }
             }
+            if (!forceSkipUpdate) runScheduledUpdates();
+            dueScheduledUpdates.clear();
+            scheduledUpdateFrame++;
         }
 
+        if (runUpdates && !forceSkipUpdate) advanceTimers(deltaTime);
+
         forceSkipUpdate = false;
 
         // Right vector
@@ -544,6 +732,12 @@ void mainLoop() {
         renderFrame(renderables, imGuiCalls);
         ++currentFPSCtr;
 
+        if (!firstFrameDrawn) {
+            firstFrameDrawn = true;
+            std::chrono::duration<double, std::milli> startupTime = std::chrono::steady_clock::now() - initStartTime;
+            std::cout << "Time to first frame: " << startupTime.count() << "ms" << std::endl;
+        }
+
         if (doTimesCheck)
             frameTime = glfwGetTime()*1000 - frameDrawStart;
 
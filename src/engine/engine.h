@@ -100,6 +100,12 @@ public:
     union { //TODO maybe more things
         uint64_t flags = 0;
     };
+    // Like onUpdate, but only run as often as the object's update band allows (see setUpdateBands), with all the time
+    // since they last ran as dt. For AI and anything else that doesn't have to happen every frame far away.
+    std::vector<void (*)(double dt, GameObject* g)> onScheduledUpdate = {};
+    double scheduledDeltaTime = 0;      // Time piled up since onScheduledUpdate last ran
+    uint32_t updateBucket = 0;          // Which frame out of every band interval it runs on, handed out by putGameObject
+    bool missedScheduledUpdate = false; // Due but over budget last frame, goes first next frame
 
     explicit GameObject(void (*initFunc)(GameObject *g)) {
         transform = Transform();
@@ -163,6 +169,24 @@ void registerOnKey(void (*function)(int key, bool pressed, double dt));
  */
 void registerOnMouse(void (*function)(int button, bool pressed, double dt));
 
+// How often GameObjects this far from the camera run their onScheduledUpdate functions.
+struct JEUpdateBand {
+    float maxDistance;     // Up to this far away, past the band before
+    unsigned int interval; // Every this many frames, 1 for every frame
+};
+/**
+ * Set the update bands for onScheduledUpdate. Objects farther than the last band use the last band, and objects behind
+ * the camera use the band after theirs. Objects sharing an interval are spread evenly over its frames.
+ * @param bands Nearest first. Empty (the default) runs every scheduled update every frame.
+ */
+void setUpdateBands(const std::vector<JEUpdateBand>& bands);
+/**
+ * Limit how long scheduled updates get each frame. Anything due after the budget's gone waits for the next frame (with
+ * its time still piling up) and goes first then.
+ * @param milliseconds 0 (the default) for no limit
+ */
+void setScheduledUpdateBudget(double milliseconds);
+
 /**
  * Add a GameObject to the engine's current objects.
  * @param name Name of the GameObject. All GameObject names must be unique, and duplicates will fail to be added with no error message.
@@ -250,6 +274,23 @@ unsigned int createTexture(const std::string& name, const std::string& fileName)
  * @return Texture Descriptor ID
  */
 unsigned int createTexture(const std::string& name, const std::string& filePath, const std::string& bundleFilePath);
+/**
+ * Create texture in GPU memory with a Descriptor ID, without waiting for it.
+ * Reading and decoding happen on job workers and the upload happens at the start of a later frame.
+ * The ID is valid right away and shows the missing texture until then, so it can go straight into a Renderable.
+ * @param name Texture name to be accessed by
+ * @param fileName File name to load texture from
+ * @return Texture Descriptor ID
+ */
+unsigned int createTextureAsync(const std::string& name, const std::string& fileName);
+/**
+ * Create texture in GPU memory with a Descriptor ID, without waiting for it. See the other overload.
+ * @param name Texture name to be accessed by
+ * @param fileName Alias to load texture from in bundle
+ * @param bundleFilePath Bundle to load bytes from
+ * @return Texture Descriptor ID
+ */
+unsigned int createTextureAsync(const std::string& name, const std::string& filePath, const std::string& bundleFilePath);
 /**
  * Get texture Descriptor ID
  * @param name Texture name to retrieve descriptor ID of
@@ -282,6 +323,20 @@ void setTextureFilterMode(JETextureFilter filter);
  * @param settings The shader program's settings and parameters
  */
 void createShader(const std::string& name, const std::string& vertex, const std::string& fragment, const JEShaderProgramSettings& settings);
+/**
+ * Create a shader program on the GPU in the background. Compiling and pipeline creation happen on job workers,
+ * so queue every shader up front and keep loading other things while they build.
+ * getShader will only block if this shader isn't done yet. Compile errors get thrown from getShader/waitForShaders.
+ * @param name Name to refer to the shader program with.
+ * @param vertex Vertex shader file name. Vulkan's supported types are GLSL and SPV.
+ * @param fragment Fragment shader file name. Vulkan's supported types are GLSL and SPV.
+ * @param settings The shader program's settings and parameters
+ */
+void createShaderAsync(const std::string& name, const std::string& vertex, const std::string& fragment, const JEShaderProgramSettings& settings);
+/**
+ * Block until every shader program queued with createShaderAsync is done.
+ */
+void waitForShaders();
 /**
  * Get a shader program's ID. This should be put in a Renderable's shader program parameter.
  * @param name Name of the shader program to look up.
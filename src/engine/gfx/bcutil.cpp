@@ -0,0 +1,445 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#include "bcutil.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+// Straightforward encoders: principal axis endpoints, a least squares touch up for BC1, nearest palette entry indices.
+// Nowhere near what dedicated compressors do, but fast enough to cook a whole bundle and it looks fine on our textures.
+
+size_t bcBlockBytes(JEBlockFormat format) {
+    return format == JE_BLOCK_BC1 ? 8 : 16;
+}
+
+size_t bcImageBytes(JEBlockFormat format, int width, int height) {
+    return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * bcBlockBytes(format);
+}
+
+// Pull out a 4x4 block, repeating the last row/column for blocks hanging off the edge.
+void fetchBlock(const unsigned char* rgba, int width, int height, int blockX, int blockY, unsigned char out[16][4]) {
+    for (int y = 0; y < 4; y++) {
+        int sy = std::min(blockY * 4 + y, height - 1);
+        for (int x = 0; x < 4; x++) {
+            int sx = std::min(blockX * 4 + x, width - 1);
+            memcpy(out[y * 4 + x], &rgba[(static_cast<size_t>(sy) * width + sx) * 4], 4);
+        }
+    }
+}
+
+void storeBlock(unsigned char* rgba, int width, int height, int blockX, int blockY, const unsigned char in[16][4]) {
+    for (int y = 0; y < 4; y++) {
+        int dy = blockY * 4 + y;
+        if (dy >= height) break;
+        for (int x = 0; x < 4; x++) {
+            int dx = blockX * 4 + x;
+            if (dx >= width) break;
+            memcpy(&rgba[(static_cast<size_t>(dy) * width + dx) * 4], in[y * 4 + x], 4);
+        }
+    }
+}
+
+// Finds the axis the block's colors are most spread along (power iteration on the covariance matrix),
+// and the lowest/highest points on it. channels is 3 for BC1, 4 for BC7.
+void principalEndpoints(const unsigned char px[16][4], int channels, float low[4], float high[4]) {
+    float mean[4] = {0, 0, 0, 0};
+    for (int i = 0; i < 16; i++) for (int c = 0; c < channels; c++) mean[c] += px[i][c];
+    for (int c = 0; c < channels; c++) mean[c] /= 16.0f;
+
+    float cov[4][4] = {};
+    for (int i = 0; i < 16; i++) {
+        for (int a = 0; a < channels; a++) {
+            for (int b = 0; b < channels; b++) {
+                cov[a][b] += (px[i][a] - mean[a]) * (px[i][b] - mean[b]);
+            }
+        }
+    }
+
+    float axis[4] = {1, 1, 1, 1};
+    for (int iteration = 0; iteration < 8; iteration++) {
+        float next[4] = {0, 0, 0, 0};
+        for (int a = 0; a < channels; a++) for (int b = 0; b < channels; b++) next[a] += cov[a][b] * axis[b];
+        float length = 0;
+        for (int c = 0; c < channels; c++) length += next[c] * next[c];
+        if (length < 1e-8f) break; // Flat block, any axis works
+        length = std::sqrt(length);
+        for (int c = 0; c < channels; c++) axis[c] = next[c] / length;
+    }
+
+    float minT = 0, maxT = 0;
+    for (int i = 0; i < 16; i++) {
+        float t = 0;
+        for (int c = 0; c < channels; c++) t += (px[i][c] - mean[c]) * axis[c];
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+    for (int c = 0; c < channels; c++) {
+        low[c] = std::clamp(mean[c] + axis[c] * minT, 0.0f, 255.0f);
+        high[c] = std::clamp(mean[c] + axis[c] * maxT, 0.0f, 255.0f);
+    }
+}
+
+int colorError(const unsigned char a[4], const unsigned char b[4], int channels) {
+    int error = 0;
+    for (int c = 0; c < channels; c++) error += (a[c] - b[c]) * (a[c] - b[c]);
+    return error;
+}
+
+// BC1 / BC3 color
+
+uint16_t packRGB565(const float rgb[3]) {
+    auto r = static_cast<uint16_t>(std::lround(std::clamp(rgb[0], 0.0f, 255.0f) * 31.0f / 255.0f));
+    auto g = static_cast<uint16_t>(std::lround(std::clamp(rgb[1], 0.0f, 255.0f) * 63.0f / 255.0f));
+    auto b = static_cast<uint16_t>(std::lround(std::clamp(rgb[2], 0.0f, 255.0f) * 31.0f / 255.0f));
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void unpackRGB565(uint16_t packed, unsigned char out[4]) {
+    unsigned int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+    out[0] = static_cast<unsigned char>((r << 3) | (r >> 2));
+    out[1] = static_cast<unsigned char>((g << 2) | (g >> 4));
+    out[2] = static_cast<unsigned char>((b << 3) | (b >> 2));
+    out[3] = 255;
+}
+
+void colorPalette(uint16_t c0, uint16_t c1, bool fourColor, unsigned char palette[4][4]) {
+    unpackRGB565(c0, palette[0]);
+    unpackRGB565(c1, palette[1]);
+    for (int c = 0; c < 3; c++) {
+        if (fourColor) {
+            palette[2][c] = static_cast<unsigned char>((2 * palette[0][c] + palette[1][c]) / 3);
+            palette[3][c] = static_cast<unsigned char>((palette[0][c] + 2 * palette[1][c]) / 3);
+        } else {
+            palette[2][c] = static_cast<unsigned char>((palette[0][c] + palette[1][c]) / 2);
+            palette[3][c] = 0;
+        }
+    }
+    palette[2][3] = 255;
+    palette[3][3] = fourColor ? 255 : 0;
+}
+
+uint32_t colorIndices(const unsigned char px[16][4], const unsigned char palette[4][4]) {
+    uint32_t indices = 0;
+    for (int i = 0; i < 16; i++) {
+        int best = 0;
+        int bestError = colorError(px[i], palette[0], 3);
+        for (int p = 1; p < 4; p++) {
+            int error = colorError(px[i], palette[p], 3);
+            if (error < bestError) { best = p; bestError = error; }
+        }
+        indices |= static_cast<uint32_t>(best) << (i * 2);
+    }
+    return indices;
+}
+
+void encodeColorBlock(const unsigned char px[16][4], unsigned char* out) {
+    float low[4], high[4];
+    principalEndpoints(px, 3, low, high);
+
+    uint16_t c0 = packRGB565(high);
+    uint16_t c1 = packRGB565(low);
+    unsigned char palette[4][4];
+    uint32_t indices = 0;
+
+    if (c0 != c1) {
+        if (c0 < c1) std::swap(c0, c1); // c0 > c1 picks the 4 color mode
+        colorPalette(c0, c1, true, palette);
+        indices = colorIndices(px, palette);
+
+        // One least squares pass: given which palette entry each pixel chose, solve for the endpoints that fit best.
+        static const float weights[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+        float aa = 0, bb = 0, ab = 0;
+        float ax[3] = {0, 0, 0}, bx[3] = {0, 0, 0};
+        for (int i = 0; i < 16; i++) {
+            float w = weights[(indices >> (i * 2)) & 3];
+            aa += w * w;
+            bb += (1 - w) * (1 - w);
+            ab += w * (1 - w);
+            for (int c = 0; c < 3; c++) {
+                ax[c] += w * px[i][c];
+                bx[c] += (1 - w) * px[i][c];
+            }
+        }
+        float det = aa * bb - ab * ab;
+        if (std::fabs(det) > 1e-6f) {
+            float refinedHigh[3], refinedLow[3];
+            for (int c = 0; c < 3; c++) {
+                refinedHigh[c] = (ax[c] * bb - bx[c] * ab) / det;
+                refinedLow[c] = (bx[c] * aa - ax[c] * ab) / det;
+            }
+            uint16_t r0 = packRGB565(refinedHigh);
+            uint16_t r1 = packRGB565(refinedLow);
+            if (r0 < r1) std::swap(r0, r1);
+            if (r0 != r1) {
+                unsigned char refinedPalette[4][4];
+                colorPalette(r0, r1, true, refinedPalette);
+                uint32_t refinedIndices = colorIndices(px, refinedPalette);
+                int oldError = 0, newError = 0;
+                for (int i = 0; i < 16; i++) {
+                    oldError += colorError(px[i], palette[(indices >> (i * 2)) & 3], 3);
+                    newError += colorError(px[i], refinedPalette[(refinedIndices >> (i * 2)) & 3], 3);
+                }
+                if (newError < oldError) {
+                    c0 = r0;
+                    c1 = r1;
+                    indices = refinedIndices;
+                }
+            }
+        }
+    }
+
+    out[0] = c0 & 0xFF; out[1] = c0 >> 8;
+    out[2] = c1 & 0xFF; out[3] = c1 >> 8;
+    for (int i = 0; i < 4; i++) out[4 + i] = static_cast<unsigned char>(indices >> (i * 8));
+}
+
+void decodeColorBlock(const unsigned char* in, bool alwaysFourColor, unsigned char px[16][4]) {
+    uint16_t c0 = in[0] | (in[1] << 8);
+    uint16_t c1 = in[2] | (in[3] << 8);
+    unsigned char palette[4][4];
+    colorPalette(c0, c1, alwaysFourColor || c0 > c1, palette);
+    uint32_t indices = in[4] | (in[5] << 8) | (in[6] << 16) | (static_cast<uint32_t>(in[7]) << 24);
+    for (int i = 0; i < 16; i++) {
+        memcpy(px[i], palette[(indices >> (i * 2)) & 3], 4);
+    }
+}
+
+// BC4, used for BC3's alpha and both of BC5's channels
+
+void singleChannelPalette(unsigned char a0, unsigned char a1, unsigned char palette[8]) {
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1) {
+        for (int i = 1; i < 7; i++) palette[i + 1] = static_cast<unsigned char>(((7 - i) * a0 + i * a1) / 7);
+    } else {
+        for (int i = 1; i < 5; i++) palette[i + 1] = static_cast<unsigned char>(((5 - i) * a0 + i * a1) / 5);
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+void encodeSingleChannelBlock(const unsigned char px[16][4], int channel, unsigned char* out) {
+    unsigned char a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; i++) {
+        a0 = std::max(a0, px[i][channel]);
+        a1 = std::min(a1, px[i][channel]);
+    }
+    out[0] = a0;
+    out[1] = a1;
+
+    uint64_t indices = 0;
+    if (a0 != a1) {
+        unsigned char palette[8];
+        singleChannelPalette(a0, a1, palette);
+        for (int i = 0; i < 16; i++) {
+            int best = 0;
+            int bestError = 256;
+            for (int p = 0; p < 8; p++) {
+                int error = std::abs(px[i][channel] - palette[p]);
+                if (error < bestError) { best = p; bestError = error; }
+            }
+            indices |= static_cast<uint64_t>(best) << (i * 3);
+        }
+    }
+    for (int i = 0; i < 6; i++) out[2 + i] = static_cast<unsigned char>(indices >> (i * 8));
+}
+
+void decodeSingleChannelBlock(const unsigned char* in, int channel, unsigned char px[16][4]) {
+    unsigned char palette[8];
+    singleChannelPalette(in[0], in[1], palette);
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; i++) indices |= static_cast<uint64_t>(in[2 + i]) << (i * 8);
+    for (int i = 0; i < 16; i++) {
+        px[i][channel] = palette[(indices >> (i * 3)) & 7];
+    }
+}
+
+// BC7, mode 6 only: one subset, RGBA endpoints with 7 bits + a shared-per-endpoint p-bit, 4 bit indices.
+
+const int bc7Weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+struct BitWriter {
+    unsigned char* bytes;
+    int position = 0;
+
+    void write(uint32_t value, int bits) {
+        for (int i = 0; i < bits; i++, position++) {
+            if ((value >> i) & 1) bytes[position >> 3] |= static_cast<unsigned char>(1 << (position & 7));
+        }
+    }
+};
+
+struct BitReader {
+    const unsigned char* bytes;
+    int position = 0;
+
+    uint32_t read(int bits) {
+        uint32_t value = 0;
+        for (int i = 0; i < bits; i++, position++) {
+            value |= static_cast<uint32_t>((bytes[position >> 3] >> (position & 7)) & 1) << i;
+        }
+        return value;
+    }
+};
+
+void bc7Palette(const unsigned char e0[4], const unsigned char e1[4], unsigned char palette[16][4]) {
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 4; c++) {
+            palette[i][c] = static_cast<unsigned char>(((64 - bc7Weights4[i]) * e0[c] + bc7Weights4[i] * e1[c] + 32) >> 6);
+        }
+    }
+}
+
+void encodeBC7Block(const unsigned char px[16][4], unsigned char* out) {
+    float low[4], high[4];
+    principalEndpoints(px, 4, low, high);
+
+    int bestError = INT32_MAX;
+    unsigned char bestQuantized[2][4]{};
+    int bestPBits[2]{};
+    int bestIndices[16]{};
+
+    // The p-bit is the low bit of every channel of an endpoint, so just try all four combinations.
+    for (int pBits = 0; pBits < 4; pBits++) {
+        int p[2] = {pBits & 1, pBits >> 1};
+        unsigned char quantized[2][4];
+        unsigned char endpoints[2][4];
+        for (int c = 0; c < 4; c++) {
+            const float source[2] = {low[c], high[c]};
+            for (int e = 0; e < 2; e++) {
+                int q = std::clamp(static_cast<int>(std::lround((source[e] - p[e]) / 2.0f)), 0, 127);
+                quantized[e][c] = static_cast<unsigned char>(q);
+                endpoints[e][c] = static_cast<unsigned char>((q << 1) | p[e]);
+            }
+        }
+
+        unsigned char palette[16][4];
+        bc7Palette(endpoints[0], endpoints[1], palette);
+        int indices[16];
+        int error = 0;
+        for (int i = 0; i < 16; i++) {
+            int best = 0;
+            int bestPixelError = colorError(px[i], palette[0], 4);
+            for (int w = 1; w < 16; w++) {
+                int pixelError = colorError(px[i], palette[w], 4);
+                if (pixelError < bestPixelError) { best = w; bestPixelError = pixelError; }
+            }
+            indices[i] = best;
+            error += bestPixelError;
+        }
+
+        if (error < bestError) {
+            bestError = error;
+            memcpy(bestQuantized, quantized, sizeof(quantized));
+            bestPBits[0] = p[0];
+            bestPBits[1] = p[1];
+            memcpy(bestIndices, indices, sizeof(indices));
+        }
+    }
+
+    // The first index only gets 3 bits, its top bit is implied 0. Swap the endpoints around if it isn't.
+    if (bestIndices[0] & 8) {
+        std::swap(bestQuantized[0], bestQuantized[1]);
+        std::swap(bestPBits[0], bestPBits[1]);
+        for (int& index : bestIndices) index = 15 - index;
+    }
+
+    memset(out, 0, 16);
+    BitWriter writer{out};
+    writer.write(1 << 6, 7); // Mode 6
+    for (int c = 0; c < 4; c++) {
+        writer.write(bestQuantized[0][c], 7);
+        writer.write(bestQuantized[1][c], 7);
+    }
+    writer.write(bestPBits[0], 1);
+    writer.write(bestPBits[1], 1);
+    writer.write(bestIndices[0], 3);
+    for (int i = 1; i < 16; i++) writer.write(bestIndices[i], 4);
+}
+
+void decodeBC7Block(const unsigned char* in, unsigned char px[16][4]) {
+    if ((in[0] & 0x7F) != 0x40) {
+        throw std::runtime_error("BC7 block isn't mode 6, which is the only one we can decode!");
+    }
+    BitReader reader{in, 7};
+    unsigned char endpoints[2][4];
+    for (int c = 0; c < 4; c++) {
+        endpoints[0][c] = static_cast<unsigned char>(reader.read(7) << 1);
+        endpoints[1][c] = static_cast<unsigned char>(reader.read(7) << 1);
+    }
+    uint32_t p0 = reader.read(1), p1 = reader.read(1);
+    for (int c = 0; c < 4; c++) {
+        endpoints[0][c] |= p0;
+        endpoints[1][c] |= p1;
+    }
+    unsigned char palette[16][4];
+    bc7Palette(endpoints[0], endpoints[1], palette);
+    for (int i = 0; i < 16; i++) {
+        memcpy(px[i], palette[reader.read(i == 0 ? 3 : 4)], 4);
+    }
+}
+
+std::vector<unsigned char> bcEncode(JEBlockFormat format, const unsigned char* rgba, int width, int height) {
+    std::vector<unsigned char> blocks(bcImageBytes(format, width, height));
+    size_t blockBytes = bcBlockBytes(format);
+    unsigned char* out = blocks.data();
+    unsigned char px[16][4];
+
+    for (int by = 0; by < (height + 3) / 4; by++) {
+        for (int bx = 0; bx < (width + 3) / 4; bx++, out += blockBytes) {
+            fetchBlock(rgba, width, height, bx, by, px);
+            switch (format) {
+                case JE_BLOCK_BC1:
+                    encodeColorBlock(px, out);
+                    break;
+                case JE_BLOCK_BC3:
+                    encodeSingleChannelBlock(px, 3, out);
+                    encodeColorBlock(px, out + 8);
+                    break;
+                case JE_BLOCK_BC5:
+                    encodeSingleChannelBlock(px, 0, out);
+                    encodeSingleChannelBlock(px, 1, out + 8);
+                    break;
+                case JE_BLOCK_BC7:
+                    encodeBC7Block(px, out);
+                    break;
+            }
+        }
+    }
+    return blocks;
+}
+
+std::vector<unsigned char> bcDecode(JEBlockFormat format, const unsigned char* blocks, int width, int height) {
+    std::vector<unsigned char> rgba(static_cast<size_t>(width) * height * 4);
+    size_t blockBytes = bcBlockBytes(format);
+    const unsigned char* in = blocks;
+    unsigned char px[16][4];
+
+    for (int by = 0; by < (height + 3) / 4; by++) {
+        for (int bx = 0; bx < (width + 3) / 4; bx++, in += blockBytes) {
+            switch (format) {
+                case JE_BLOCK_BC1:
+                    decodeColorBlock(in, false, px);
+                    break;
+                case JE_BLOCK_BC3:
+                    decodeColorBlock(in + 8, true, px);
+                    decodeSingleChannelBlock(in, 3, px);
+                    break;
+                case JE_BLOCK_BC5:
+                    for (auto& p : px) { p[2] = 0; p[3] = 255; }
+                    decodeSingleChannelBlock(in, 0, px);
+                    decodeSingleChannelBlock(in + 8, 1, px);
+                    break;
+                case JE_BLOCK_BC7:
+                    decodeBC7Block(in, px);
+                    break;
+            }
+            storeBlock(rgba.data(), width, height, bx, by, px);
+        }
+    }
+    return rgba;
+}
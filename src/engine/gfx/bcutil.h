@@ -0,0 +1,43 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#ifndef JOSHENGINE_BCUTIL_H
+#define JOSHENGINE_BCUTIL_H
+
+#include <vector>
+#include <cstddef>
+
+// Block compressed texture formats. Every one of them works on 4x4 pixel blocks.
+enum JEBlockFormat {
+    JE_BLOCK_BC1 = 1, // RGB, 8 bytes a block. Opaque albedo.
+    JE_BLOCK_BC3 = 3, // RGB + separate alpha, 16 bytes a block. Albedo with real transparency.
+    JE_BLOCK_BC5 = 5, // Two independent channels (RG), 16 bytes a block. Spec/emissive maps.
+    JE_BLOCK_BC7 = 7  // RGBA, 16 bytes a block. Best looking albedo, slowest to encode.
+};
+
+/**
+ * @return Bytes per 4x4 block.
+ */
+size_t bcBlockBytes(JEBlockFormat format);
+/**
+ * @return Bytes for a whole width x height image. Partial blocks on the edges count as full blocks.
+ */
+size_t bcImageBytes(JEBlockFormat format, int width, int height);
+/**
+ * Compress an RGBA8 image. Meant for cooking assets offline, not for load time.
+ * BC5 only keeps R and G. BC1 ignores alpha.
+ * @param format Format to encode into
+ * @param rgba width * height * 4 bytes
+ * @return bcImageBytes(format, width, height) bytes of blocks, row by row
+ */
+std::vector<unsigned char> bcEncode(JEBlockFormat format, const unsigned char* rgba, int width, int height);
+/**
+ * Decompress back into RGBA8, for GPUs without textureCompressionBC.
+ * BC7 only supports mode 6, which is the only mode bcEncode writes. Anything else throws.
+ * BC5 comes back as (R, G, 0, 255).
+ * @return width * height * 4 bytes
+ */
+std::vector<unsigned char> bcDecode(JEBlockFormat format, const unsigned char* blocks, int width, int height);
+
+#endif //JOSHENGINE_BCUTIL_H
@@ -0,0 +1,613 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#include "meshutil.h"
+#include "../job/jobutil.h"
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <charconv>
+#include <cmath>
+
+// OBJ parsing happens in two passes. First the file gets cut into chunks on line boundaries and every chunk is tokenized
+// in parallel, in place, into its own attribute lists and face corners. Then the chunks get stitched together in order,
+// corners are resolved to actual values and vertices welded into each Model.
+
+#define OBJ_CHUNK_BYTES (256 * 1024)
+
+// One corner of a triangle. Indices are 1 based like the file, 0 means it wasn't given.
+// Relative (negative) indices can't be resolved until we know how many of that attribute came before this chunk,
+// so they're stored as an index local to the chunk (which can go below 1, into earlier chunks) with their bit in relative set.
+struct JEObjCorner {
+    int64_t index[3]; // Position, UV, normal
+    uint8_t relative;
+};
+
+struct JEObjChunk {
+    std::vector<float> attributes[3]; // Positions (xyz), UVs (xy), normals (xyz)
+    std::vector<JEObjCorner> corners; // 3 per triangle
+    std::vector<size_t> groupBreaks;  // corners.size() every time an o/g/usemtl shows up
+    bool unsupported = false;
+    std::string firstUnknownToken;
+};
+
+constexpr size_t objAttributeWidth[3] = {3, 2, 3};
+
+bool isObjSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+const char* skipObjSpace(const char* p, const char* end) {
+    while (p < end && isObjSpace(*p)) p++;
+    return p;
+}
+
+const char* parseObjFloat(const char* p, const char* end, float& out) {
+    p = skipObjSpace(p, end);
+    if (p < end && *p == '+') p++; // from_chars doesn't take a leading +
+    auto [next, error] = std::from_chars(p, end, out);
+    if (error != std::errc()) throw std::runtime_error("OBJ has a number that doesn't parse!");
+    return next;
+}
+
+// One "v/t/n" style corner
+const char* parseObjCorner(const char* p, const char* end, const JEObjChunk& chunk, JEObjCorner& corner) {
+    corner = {{0, 0, 0}, 0};
+    for (int attribute = 0; attribute < 3; attribute++) {
+        if (attribute > 0) {
+            if (p >= end || *p != '/') break;
+            p++;
+            if (p < end && *p == '/') continue; // v//n, no UV
+        }
+        int64_t value;
+        auto [next, error] = std::from_chars(p, end, value);
+        if (error != std::errc() || value == 0) throw std::runtime_error("OBJ has a face index that doesn't parse!");
+        p = next;
+        if (value < 0) {
+            // -1 is the latest one, which locally is the current count
+            value = static_cast<int64_t>(chunk.attributes[attribute].size() / objAttributeWidth[attribute]) + 1 + value;
+            corner.relative |= 1 << attribute;
+        }
+        corner.index[attribute] = value;
+    }
+    return p;
+}
+
+void tokenizeObjChunk(const char* p, const char* end, JEObjChunk& chunk) {
+    std::vector<JEObjCorner> polygon;
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (lineEnd == nullptr) lineEnd = end;
+        const char* linePtr = skipObjSpace(p, lineEnd);
+        p = lineEnd + 1;
+
+        const char* keywordEnd = linePtr;
+        while (keywordEnd < lineEnd && !isObjSpace(*keywordEnd)) keywordEnd++;
+        std::string_view keyword(linePtr, keywordEnd - linePtr);
+        if (keyword.empty() || keyword[0] == '#') continue; // Blank line or comment
+
+        int attribute = keyword == "v" ? 0 : keyword == "vt" ? 1 : keyword == "vn" ? 2 : -1;
+        if (attribute >= 0) {
+            const char* q = keywordEnd;
+            for (size_t i = 0; i < objAttributeWidth[attribute]; i++) {
+                float value;
+                q = parseObjFloat(q, lineEnd, value);
+                chunk.attributes[attribute].push_back(value);
+            }
+        } else if (keyword == "f") {
+            polygon.clear();
+            const char* q = skipObjSpace(keywordEnd, lineEnd);
+            while (q < lineEnd) {
+                JEObjCorner corner{};
+                q = skipObjSpace(parseObjCorner(q, lineEnd, chunk, corner), lineEnd);
+                polygon.push_back(corner);
+            }
+            // Fan anything bigger than a triangle
+            for (size_t i = 2; i < polygon.size(); i++) {
+                chunk.corners.push_back(polygon[0]);
+                chunk.corners.push_back(polygon[i-1]);
+                chunk.corners.push_back(polygon[i]);
+            }
+        } else if (keyword == "usemtl" || keyword == "o" || keyword == "g") {
+            chunk.groupBreaks.push_back(chunk.corners.size());
+        } else if (keyword == "s" || keyword == "mtllib") {
+            // smooth shading and material libraries (ignore these)
+        } else if (keyword == "vp" || keyword == "l") {
+            chunk.unsupported = true;
+            return;
+        } else if (chunk.firstUnknownToken.empty()) {
+            chunk.firstUnknownToken = keyword;
+        }
+    }
+}
+
+// Open addressing table of unique vertices for one Model. Keys are the raw bits of all 8 floats, with -0 folded into 0 so it
+// welds the same way comparing with == did.
+struct JEVertexWelder {
+    std::vector<uint32_t> slots;
+    size_t mask;
+    Model& model;
+
+    JEVertexWelder(Model& m, size_t expectedVertices) : model(m) {
+        size_t capacity = 16;
+        while (capacity < expectedVertices * 2) capacity *= 2;
+        slots.assign(capacity, UINT32_MAX);
+        mask = capacity - 1;
+    }
+
+    static uint32_t bits(float f) {
+        if (f == 0.0f) f = 0.0f;
+        uint32_t b;
+        memcpy(&b, &f, sizeof(b));
+        return b;
+    }
+
+    [[nodiscard]] bool matches(uint32_t vertex, const uint32_t* key) const {
+        for (int c = 0; c < 3; c++) if (bits(model.vertices[vertex*3+c]) != key[c]) return false;
+        for (int c = 0; c < 2; c++) if (bits(model.uvs[vertex*2+c]) != key[3+c]) return false;
+        for (int c = 0; c < 3; c++) if (bits(model.normals[vertex*3+c]) != key[5+c]) return false;
+        return true;
+    }
+
+    void add(const float* position, const float* uv, const float* normal) {
+        uint32_t key[8] = {bits(position[0]), bits(position[1]), bits(position[2]), bits(uv[0]), bits(uv[1]), bits(normal[0]), bits(normal[1]), bits(normal[2])};
+        uint64_t hash = 0xCBF29CE484222325;
+        for (uint32_t k : key) hash = (hash ^ k) * 0x100000001B3;
+        hash ^= hash >> 29;
+
+        for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            if (slots[slot] == UINT32_MAX) {
+                auto vertex = static_cast<uint32_t>(model.vertices.size() / 3);
+                slots[slot] = vertex;
+                model.vertices.insert(model.vertices.end(), position, position + 3);
+                model.uvs.insert(model.uvs.end(), uv, uv + 2);
+                model.normals.insert(model.normals.end(), normal, normal + 3);
+                model.indices.push_back(vertex);
+                return;
+            }
+            if (matches(slots[slot], key)) {
+                model.indices.push_back(slots[slot]);
+                return;
+            }
+        }
+    }
+};
+
+// Pure CPU side of loading an OBJ, no GPU calls, so it's safe to run on a job worker.
+std::vector<Model> parseObj(std::span<const std::byte> fileContents) {
+    const char* text = reinterpret_cast<const char*>(fileContents.data());
+    const char* textEnd = text + fileContents.size();
+
+    std::vector<const char*> chunkStarts = {text};
+    for (size_t split = OBJ_CHUNK_BYTES; split < fileContents.size(); split += OBJ_CHUNK_BYTES) {
+        const char* from = std::max(text + split, chunkStarts.back());
+        const char* lineEnd = from < textEnd ? static_cast<const char*>(memchr(from, '\n', textEnd - from)) : nullptr;
+        if (lineEnd == nullptr || lineEnd + 1 >= textEnd) break;
+        chunkStarts.push_back(lineEnd + 1);
+    }
+    chunkStarts.push_back(textEnd);
+
+    std::vector<JEObjChunk> chunks(chunkStarts.size() - 1);
+    parallelFor(chunks.size(), [&](size_t i) {
+        tokenizeObjChunk(chunkStarts[i], chunkStarts[i+1], chunks[i]);
+    }, 1);
+
+    // Stupid solution to everything starting at 1: slot 0 is the default when a corner leaves something out.
+    std::vector<float> attributes[3] = {{0, 0, 0}, {0, 0}, {0, 1, 0}};
+    std::vector<size_t> chunkBases[3];
+    for (auto& chunk : chunks) {
+        if (chunk.unsupported) {
+            std::cerr << "OBJ uses unsupported parameter space vertex or line element! Cancelling load." << std::endl;
+            return {};
+        }
+        if (!chunk.firstUnknownToken.empty()) {
+            std::cerr << "Unrecognized token \"" << chunk.firstUnknownToken << "\"" << std::endl;
+        }
+        for (int a = 0; a < 3; a++) {
+            chunkBases[a].push_back(attributes[a].size() / objAttributeWidth[a] - 1);
+            attributes[a].insert(attributes[a].end(), chunk.attributes[a].begin(), chunk.attributes[a].end());
+            chunk.attributes[a] = {};
+        }
+    }
+
+    std::vector<Model> modelList;
+    std::vector<const JEObjCorner*> groupCorners;
+    std::vector<size_t> groupChunks;
+    auto finishGroup = [&]() {
+        if (groupCorners.empty()) return;
+        Model model;
+        JEVertexWelder welder(model, groupCorners.size());
+        for (size_t i = 0; i < groupCorners.size(); i++) {
+            const float* values[3];
+            for (int a = 0; a < 3; a++) {
+                int64_t index = groupCorners[i]->index[a];
+                if (groupCorners[i]->relative & (1 << a)) index += static_cast<int64_t>(chunkBases[a][groupChunks[i]]);
+                auto count = static_cast<int64_t>(attributes[a].size() / objAttributeWidth[a]);
+                if (index < 0 || index >= count) throw std::runtime_error("OBJ has a face index out of range!");
+                values[a] = &attributes[a][index * objAttributeWidth[a]];
+            }
+            welder.add(values[0], values[1], values[2]);
+        }
+        modelList.push_back(std::move(model));
+        groupCorners.clear();
+        groupChunks.clear();
+    };
+
+    for (size_t c = 0; c < chunks.size(); c++) {
+        size_t nextBreak = 0;
+        for (size_t i = 0; i <= chunks[c].corners.size(); i++) {
+            while (nextBreak < chunks[c].groupBreaks.size() && chunks[c].groupBreaks[nextBreak] == i) {
+                finishGroup();
+                nextBreak++;
+            }
+            if (i == chunks[c].corners.size()) break;
+            groupCorners.push_back(&chunks[c].corners[i]);
+            groupChunks.push_back(c);
+        }
+    }
+    finishGroup();
+    return modelList;
+}
+
+JEVertexCacheStats measureVertexCache(const Model& model, unsigned int cacheSize) {
+    JEVertexCacheStats stats;
+    stats.triangles = model.indices.size() / 3;
+    stats.vertices = model.vertices.size() / 3;
+    // When every vertex went into the FIFO, so it's still in there if fewer than cacheSize went in since.
+    std::vector<size_t> insertedAt(stats.vertices, 0);
+    for (unsigned int index : model.indices) {
+        if (insertedAt[index] == 0 || stats.transforms + 1 - insertedAt[index] > cacheSize) {
+            stats.transforms++;
+            insertedAt[index] = stats.transforms;
+        }
+    }
+    return stats;
+}
+
+// Tipsify, from Sander, Nehab and Barczak's "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw".
+// Fans out around one vertex at a time, picking the next one that's still in the cache and has the fewest triangles left.
+// Returns the new triangle order, and where each cluster (a run that started from a cold cache) begins in it.
+std::vector<uint32_t> tipsify(const std::vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize, std::vector<size_t>& clusterStarts) {
+    size_t triangleCount = indices.size() / 3;
+
+    // Vertex -> triangles using it, as one flat list
+    std::vector<uint32_t> liveTriangles(vertexCount, 0);
+    for (unsigned int index : indices) liveTriangles[index]++;
+    std::vector<uint32_t> adjacencyStart(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++) adjacencyStart[v+1] = adjacencyStart[v] + liveTriangles[v];
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<uint32_t> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+    for (size_t i = 0; i < indices.size(); i++) adjacency[fill[indices[i]]++] = i / 3;
+
+    std::vector<size_t> cacheTime(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEnd;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> order;
+    order.reserve(triangleCount);
+    size_t time = cacheSize + 1;
+    size_t cursor = 0;
+
+    auto skipDeadEnd = [&]() -> int64_t {
+        while (!deadEnd.empty()) {
+            uint32_t v = deadEnd.back();
+            deadEnd.pop_back();
+            if (liveTriangles[v] > 0) return v;
+        }
+        for (; cursor < vertexCount; cursor++) {
+            if (liveTriangles[cursor] > 0) return static_cast<int64_t>(cursor);
+        }
+        return -1;
+    };
+
+    int64_t fan = vertexCount > 0 ? 0 : -1;
+    if (fan == 0 && liveTriangles[0] == 0) fan = skipDeadEnd();
+    clusterStarts.push_back(0);
+    while (fan >= 0) {
+        candidates.clear();
+        for (uint32_t a = adjacencyStart[fan]; a < adjacencyStart[fan+1]; a++) {
+            uint32_t t = adjacency[a];
+            if (emitted[t]) continue;
+            for (int k = 0; k < 3; k++) {
+                unsigned int v = indices[t*3+k];
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                liveTriangles[v]--;
+                if (time - cacheTime[v] > cacheSize) {
+                    cacheTime[v] = time;
+                    time++;
+                }
+            }
+            emitted[t] = true;
+            order.push_back(t);
+        }
+
+        // Next fanning vertex: one of this fan's that'll still be cached after its remaining triangles go out, oldest first
+        int64_t next = -1;
+        int64_t best = -1;
+        for (uint32_t v : candidates) {
+            if (liveTriangles[v] == 0) continue;
+            int64_t priority = 0;
+            if (time - cacheTime[v] + 2 * liveTriangles[v] <= cacheSize) priority = static_cast<int64_t>(time - cacheTime[v]);
+            if (priority > best) {
+                best = priority;
+                next = v;
+            }
+        }
+        if (next == -1) {
+            next = skipDeadEnd();
+            if (next >= 0 && order.size() < triangleCount) clusterStarts.push_back(order.size());
+        }
+        fan = next;
+    }
+    return order;
+}
+
+void optimizeModel(Model& model) {
+    size_t vertexCount = model.vertices.size() / 3;
+    size_t triangleCount = model.indices.size() / 3;
+    if (triangleCount == 0) return;
+
+    std::vector<size_t> clusterStarts;
+    std::vector<uint32_t> order = tipsify(model.indices, vertexCount, JE_VERTEX_CACHE_SIZE, clusterStarts);
+    clusterStarts.push_back(order.size());
+
+    // Overdraw: clusters facing away from the middle of the mesh are the ones most likely to be in front of something.
+    auto position = [&](unsigned int v) { return &model.vertices[v*3]; };
+    double meshCenter[3] = {0, 0, 0};
+    for (size_t v = 0; v < vertexCount; v++) for (int c = 0; c < 3; c++) meshCenter[c] += position(v)[c];
+    for (double& c : meshCenter) c /= static_cast<double>(std::max<size_t>(vertexCount, 1));
+
+    struct Cluster { size_t start, end; double outwardness; };
+    std::vector<Cluster> clusters;
+    for (size_t c = 0; c + 1 < clusterStarts.size(); c++) {
+        double centroid[3] = {0, 0, 0}, normal[3] = {0, 0, 0}, area = 0;
+        for (size_t i = clusterStarts[c]; i < clusterStarts[c+1]; i++) {
+            const float* p0 = position(model.indices[order[i]*3]);
+            const float* p1 = position(model.indices[order[i]*3+1]);
+            const float* p2 = position(model.indices[order[i]*3+2]);
+            double e1[3] = {p1[0]-p0[0], p1[1]-p0[1], p1[2]-p0[2]};
+            double e2[3] = {p2[0]-p0[0], p2[1]-p0[1], p2[2]-p0[2]};
+            // Unnormalized, so bigger triangles count for more
+            double n[3] = {e1[1]*e2[2] - e1[2]*e2[1], e1[2]*e2[0] - e1[0]*e2[2], e1[0]*e2[1] - e1[1]*e2[0]};
+            double triangleArea = std::sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+            for (int k = 0; k < 3; k++) {
+                normal[k] += n[k];
+                centroid[k] += (p0[k] + p1[k] + p2[k]) / 3.0 * triangleArea;
+            }
+            area += triangleArea;
+        }
+        double normalLength = std::sqrt(normal[0]*normal[0] + normal[1]*normal[1] + normal[2]*normal[2]);
+        double outwardness = 0;
+        if (area > 0 && normalLength > 0) {
+            for (int k = 0; k < 3; k++) outwardness += (centroid[k] / area - meshCenter[k]) * normal[k] / normalLength;
+        }
+        clusters.push_back({clusterStarts[c], clusterStarts[c+1], outwardness});
+    }
+    std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) { return a.outwardness > b.outwardness; });
+
+    std::vector<unsigned int> indices;
+    indices.reserve(model.indices.size());
+    for (const Cluster& cluster : clusters) {
+        for (size_t i = cluster.start; i < cluster.end; i++) {
+            for (int k = 0; k < 3; k++) indices.push_back(model.indices[order[i]*3+k]);
+        }
+    }
+
+    // Vertex fetch: renumber vertices by first use. Anything never used gets dropped.
+    std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+    Model reordered;
+    for (unsigned int& index : indices) {
+        if (remap[index] == UINT32_MAX) {
+            remap[index] = reordered.vertices.size() / 3;
+            reordered.vertices.insert(reordered.vertices.end(), &model.vertices[index*3], &model.vertices[index*3] + 3);
+            reordered.uvs.insert(reordered.uvs.end(), &model.uvs[index*2], &model.uvs[index*2] + 2);
+            reordered.normals.insert(reordered.normals.end(), &model.normals[index*3], &model.normals[index*3] + 3);
+        }
+        index = remap[index];
+    }
+    reordered.indices = std::move(indices);
+    model = std::move(reordered);
+}
+
+// Round to nearest even, same as a GPU would. Out of range goes to infinity, tiny values to subnormals or zero.
+uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t exponent = (bits >> 23) & 0xFF;
+    uint32_t mantissa = bits & 0x7FFFFF;
+    if (exponent == 0xFF) return static_cast<uint16_t>(sign | 0x7C00 | (mantissa ? 0x200 : 0)); // Inf/NaN
+
+    int32_t halfExponent = static_cast<int32_t>(exponent) - 127 + 15;
+    if (halfExponent >= 31) return static_cast<uint16_t>(sign | 0x7C00);
+    uint32_t shift = 13;
+    if (halfExponent <= 0) {
+        if (halfExponent < -10) return static_cast<uint16_t>(sign);
+        mantissa |= 0x800000;
+        shift = 14 - halfExponent;
+        halfExponent = 0;
+    }
+    uint32_t half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> shift);
+    uint32_t rest = mantissa & ((1u << shift) - 1);
+    uint32_t halfway = 1u << (shift - 1);
+    // Carrying out of the mantissa bumps the exponent, which is also the right answer (up to infinity).
+    if (rest > halfway || (rest == halfway && (half & 1))) half++;
+    return static_cast<uint16_t>(sign | half);
+}
+
+// Octahedral: project onto |x|+|y|+|z| = 1 and fold the bottom half over the top, so two numbers cover the sphere evenly.
+void encodeOctahedral(const float normal[3], int16_t out[2]) {
+    float l1 = std::abs(normal[0]) + std::abs(normal[1]) + std::abs(normal[2]);
+    float x = l1 > 0 ? normal[0] / l1 : 0;
+    float y = l1 > 0 ? normal[1] / l1 : 0;
+    if (l1 > 0 && normal[2] < 0) {
+        float foldedX = (1 - std::abs(y)) * (x >= 0 ? 1.0f : -1.0f);
+        y = (1 - std::abs(x)) * (y >= 0 ? 1.0f : -1.0f);
+        x = foldedX;
+    }
+    out[0] = static_cast<int16_t>(std::lround(std::clamp(x, -1.0f, 1.0f) * 32767.0f));
+    out[1] = static_cast<int16_t>(std::lround(std::clamp(y, -1.0f, 1.0f) * 32767.0f));
+}
+
+std::vector<uint16_t> shortenIndices(std::span<const unsigned int> indices) {
+    std::vector<uint16_t> shortened(indices.size());
+    for (size_t i = 0; i < indices.size(); i++) shortened[i] = static_cast<uint16_t>(indices[i]);
+    return shortened;
+}
+
+std::vector<std::byte> cookMesh(const std::vector<Model>& models, JECookedVertexFormat vertexFormat) {
+    struct CookedVertex {
+        float position[3];
+        float uv[2];
+        float normal[3];
+    };
+    static_assert(sizeof(CookedVertex) == 32, "Has to match JEInterleavedVertex_VK");
+    static_assert(sizeof(JECompactVertex) == 16, "Has to match JECompactVertex_VK");
+
+    JECookedMeshHeader header;
+    header.vertexFormat = vertexFormat;
+    std::vector<JECookedSubmesh> submeshes;
+    std::vector<CookedVertex> vertices;
+    std::vector<uint32_t> indices;
+
+    for (int c = 0; c < 3; c++) {
+        header.boundsMin[c] = std::numeric_limits<float>::max();
+        header.boundsMax[c] = std::numeric_limits<float>::lowest();
+    }
+
+    for (const Model& m : models) {
+        if (m.indices.empty()) continue;
+        JECookedSubmesh submesh{static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(m.indices.size()), {}, {}};
+        for (int c = 0; c < 3; c++) {
+            submesh.boundsMin[c] = std::numeric_limits<float>::max();
+            submesh.boundsMax[c] = std::numeric_limits<float>::lowest();
+        }
+
+        auto base = static_cast<uint32_t>(vertices.size());
+        for (size_t i = 0; i < m.vertices.size()/3; i++) {
+            vertices.push_back({
+                {m.vertices[3*i],  m.vertices[(3*i)+1], m.vertices[(3*i)+2]},
+                {m.uvs[2*i],       m.uvs[(2*i)+1]},
+                {m.normals[3*i],   m.normals[(3*i)+1],  m.normals[(3*i)+2]}
+            });
+            for (int c = 0; c < 3; c++) {
+                submesh.boundsMin[c] = std::min(submesh.boundsMin[c], m.vertices[3*i+c]);
+                submesh.boundsMax[c] = std::max(submesh.boundsMax[c], m.vertices[3*i+c]);
+            }
+        }
+        for (unsigned int index : m.indices) indices.push_back(base + index);
+        for (int c = 0; c < 3; c++) {
+            header.boundsMin[c] = std::min(header.boundsMin[c], submesh.boundsMin[c]);
+            header.boundsMax[c] = std::max(header.boundsMax[c], submesh.boundsMax[c]);
+        }
+        submeshes.push_back(submesh);
+    }
+    if (submeshes.empty()) {
+        throw std::runtime_error("Mesh has nothing in it to cook!");
+    }
+
+    // Vertex and index data as they'll sit in the file
+    std::span<const std::byte> vertexBytes = std::as_bytes(std::span(vertices));
+    std::vector<JECompactVertex> compactVertices;
+    if (vertexFormat == JE_VERTEX_COMPACT16) {
+        compactVertices.resize(vertices.size());
+        for (size_t i = 0; i < vertices.size(); i++) {
+            for (int c = 0; c < 3; c++) {
+                float extent = header.boundsMax[c] - header.boundsMin[c];
+                float t = extent > 0 ? (vertices[i].position[c] - header.boundsMin[c]) / extent : 0;
+                compactVertices[i].position[c] = static_cast<uint16_t>(std::lround(std::clamp(t, 0.0f, 1.0f) * 65535.0f));
+            }
+            compactVertices[i].position[3] = 0;
+            compactVertices[i].uv[0] = floatToHalf(vertices[i].uv[0]);
+            compactVertices[i].uv[1] = floatToHalf(vertices[i].uv[1]);
+            encodeOctahedral(vertices[i].normal, compactVertices[i].normal);
+        }
+        vertexBytes = std::as_bytes(std::span(compactVertices));
+    } else if (vertexFormat != JE_VERTEX_FLOAT32) {
+        throw std::runtime_error("Can't cook meshes to vertex format " + std::to_string(vertexFormat) + "!");
+    }
+    std::span<const std::byte> indexBytes = std::as_bytes(std::span(indices));
+    std::vector<uint16_t> shortIndices;
+    if (vertices.size() <= JE_MAX_SHORT_INDEX_VERTICES) {
+        shortIndices = shortenIndices(indices);
+        indexBytes = std::as_bytes(std::span(shortIndices));
+    }
+
+    auto align = [](uint64_t offset) { return (offset + JE_COOKED_MESH_ALIGN - 1) & ~static_cast<uint64_t>(JE_COOKED_MESH_ALIGN - 1); };
+    header.vertexStride = vertexBytes.size() / vertices.size();
+    header.indexSize = indexBytes.size() / indices.size();
+    header.submeshCount = submeshes.size();
+    header.vertexCount = vertices.size();
+    header.indexCount = indices.size();
+    header.submeshOffset = align(sizeof(JECookedMeshHeader));
+    header.vertexOffset = align(header.submeshOffset + sizeof(JECookedSubmesh) * submeshes.size());
+    header.indexOffset = align(header.vertexOffset + vertexBytes.size());
+
+    std::vector<std::byte> file(align(header.indexOffset + indexBytes.size()));
+    memcpy(file.data(), &header, sizeof(header));
+    memcpy(file.data() + header.submeshOffset, submeshes.data(), sizeof(JECookedSubmesh) * submeshes.size());
+    memcpy(file.data() + header.vertexOffset, vertexBytes.data(), vertexBytes.size());
+    memcpy(file.data() + header.indexOffset, indexBytes.data(), indexBytes.size());
+    return file;
+}
+
+bool isCookedMesh(std::span<const std::byte> bytes) {
+    if (bytes.size() < sizeof(JECookedMeshHeader)) return false;
+    uint32_t magic;
+    memcpy(&magic, bytes.data(), sizeof(magic));
+    return magic == JE_COOKED_MESH_MAGIC;
+}
+
+JECookedMesh parseCookedMesh(std::span<const std::byte> bytes) {
+    if (!isCookedMesh(bytes)) {
+        throw std::runtime_error("Not a cooked mesh!");
+    }
+    JECookedMesh mesh{};
+    memcpy(&mesh.header, bytes.data(), sizeof(mesh.header));
+    const JECookedMeshHeader& h = mesh.header;
+    if (h.version != JE_COOKED_MESH_VERSION) {
+        throw std::runtime_error("Cooked mesh is version " + std::to_string(h.version) + ", expected " + std::to_string(JE_COOKED_MESH_VERSION) + "!");
+    }
+
+    // Everything in 64 bit with the counts capped first, so none of the size math below can overflow.
+    uint64_t size = bytes.size();
+    auto fits = [size](uint64_t offset, uint64_t length) { return offset <= size && length <= size - offset; };
+    bool knownFormat = (h.vertexFormat == JE_VERTEX_FLOAT32 && h.vertexStride == 32) || (h.vertexFormat == JE_VERTEX_COMPACT16 && h.vertexStride == sizeof(JECompactVertex));
+    if (!knownFormat || (h.indexSize != 4 && h.indexSize != 2) || h.submeshCount == 0 ||
+        h.vertexCount > size || h.indexCount > size || h.indexCount % 3 != 0 ||
+        !fits(h.submeshOffset, static_cast<uint64_t>(h.submeshCount) * sizeof(JECookedSubmesh)) ||
+        !fits(h.vertexOffset, h.vertexCount * h.vertexStride) ||
+        !fits(h.indexOffset, h.indexCount * h.indexSize)) {
+        throw std::runtime_error("Cooked mesh header is broken!");
+    }
+
+    mesh.submeshes.resize(h.submeshCount);
+    memcpy(mesh.submeshes.data(), bytes.data() + h.submeshOffset, sizeof(JECookedSubmesh) * h.submeshCount);
+    for (const auto& submesh : mesh.submeshes) {
+        if (submesh.firstIndex > h.indexCount || submesh.indexCount > h.indexCount - submesh.firstIndex) {
+            throw std::runtime_error("Cooked mesh submesh table is broken!");
+        }
+    }
+    mesh.vertices = bytes.subspan(h.vertexOffset, h.vertexCount * h.vertexStride);
+    mesh.indices = bytes.subspan(h.indexOffset, h.indexCount * h.indexSize);
+
+    // An index past the end would have the GPU reading outside the vertex buffer.
+    for (size_t i = 0; i < h.indexCount; i++) {
+        uint32_t index = 0;
+        if (h.indexSize == 2) {
+            uint16_t shortIndex;
+            memcpy(&shortIndex, mesh.indices.data() + i * sizeof(uint16_t), sizeof(shortIndex));
+            index = shortIndex;
+        } else {
+            memcpy(&index, mesh.indices.data() + i * sizeof(uint32_t), sizeof(index));
+        }
+        if (index >= h.vertexCount) throw std::runtime_error("Cooked mesh has an index out of range!");
+    }
+    return mesh;
+}
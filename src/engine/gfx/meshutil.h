@@ -0,0 +1,139 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#ifndef JOSHENGINE_MESHUTIL_H
+#define JOSHENGINE_MESHUTIL_H
+
+#include <vector>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+
+struct Model {
+    std::vector<float> vertices{};
+    std::vector<float> uvs{};
+    std::vector<float> normals{};
+    std::vector<unsigned int> indices{};
+};
+
+// Cooked meshes (.jmesh) are already in the layout the GPU wants, so loading one is a copy into staging and nothing else.
+//
+// Layout, all little endian:
+//   JECookedMeshHeader
+//   JECookedSubmesh[submeshCount]   at submeshOffset, one per OBJ object/group/material
+//   vertices                        at vertexOffset, vertexCount * vertexStride bytes
+//   indices                         at indexOffset, indexCount * indexSize bytes, already offset into the shared vertices
+// Every section starts on a JE_COOKED_MESH_ALIGN boundary. Indices are 16 bit whenever the vertex count allows.
+#define JE_COOKED_MESH_MAGIC 0x48534D4A // "JMSH"
+#define JE_COOKED_MESH_VERSION 1
+#define JE_COOKED_MESH_ALIGN 16
+
+// Anything with at most this many vertices gets 16 bit indices.
+#define JE_MAX_SHORT_INDEX_VERTICES 65536
+
+enum JECookedVertexFormat : uint32_t {
+    JE_VERTEX_FLOAT32 = 0, // float3 position, float2 UV, float3 normal. Same as JEInterleavedVertex_VK.
+    JE_VERTEX_COMPACT16 = 1 // JECompactVertex. Half the size, needs a vertex shader with a JE_COMPACT_VERTICES path.
+};
+
+// unorm16 position inside the mesh's bounds (boundsMin + position * (boundsMax - boundsMin), w unused),
+// half float UV, octahedral snorm16 normal. Same as JECompactVertex_VK.
+struct JECompactVertex {
+    uint16_t position[4];
+    uint16_t uv[2];
+    int16_t normal[2];
+};
+
+struct JECookedMeshHeader {
+    uint32_t magic = JE_COOKED_MESH_MAGIC;
+    uint32_t version = JE_COOKED_MESH_VERSION;
+    uint32_t vertexFormat = JE_VERTEX_FLOAT32;
+    uint32_t vertexStride = 0;
+    uint32_t indexSize = 4;
+    uint32_t submeshCount = 0;
+    uint64_t vertexCount = 0;
+    uint64_t indexCount = 0;
+    uint64_t submeshOffset = 0;
+    uint64_t vertexOffset = 0;
+    uint64_t indexOffset = 0;
+    float boundsMin[3]{};
+    float boundsMax[3]{};
+};
+
+struct JECookedSubmesh {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    float boundsMin[3];
+    float boundsMax[3];
+};
+
+// Parsed view of a cooked mesh. vertices/indices point into whatever buffer was parsed.
+struct JECookedMesh {
+    JECookedMeshHeader header;
+    std::vector<JECookedSubmesh> submeshes;
+    std::span<const std::byte> vertices;
+    std::span<const std::byte> indices;
+};
+
+/**
+ * Parse an OBJ into one Model per object/group/material, with duplicate vertices removed.
+ * Pure CPU, safe to run on a job worker. Throws if a number in the file doesn't parse.
+ */
+std::vector<Model> parseObj(std::span<const std::byte> fileContents);
+
+// Post-transform vertex cache size optimizeModel aims for and measureVertexCache simulates. Real hardware varies,
+// 16 entry FIFO is the usual middle ground and anything tuned for it holds up on bigger caches.
+#define JE_VERTEX_CACHE_SIZE 16
+
+// How many times the vertex shader would run for an index buffer, simulated with a FIFO cache.
+struct JEVertexCacheStats {
+    size_t transforms = 0; // Cache misses
+    size_t triangles = 0;
+    size_t vertices = 0;
+
+    JEVertexCacheStats& operator+=(const JEVertexCacheStats& other) {
+        transforms += other.transforms;
+        triangles += other.triangles;
+        vertices += other.vertices;
+        return *this;
+    }
+
+    // Average cache miss ratio: transforms per triangle. 0.5 is about the best any real mesh gets, 3 is the worst.
+    [[nodiscard]] float acmr() const { return triangles ? static_cast<float>(transforms) / triangles : 0; }
+    // Average transformed vertex ratio: transforms per unique vertex. 1 is perfect.
+    [[nodiscard]] float atvr() const { return vertices ? static_cast<float>(transforms) / vertices : 0; }
+};
+
+/**
+ * Simulate drawing a model's indices through a FIFO post-transform cache.
+ */
+JEVertexCacheStats measureVertexCache(const Model& model, unsigned int cacheSize = JE_VERTEX_CACHE_SIZE);
+/**
+ * Reorder a model for the GPU. Doesn't change what it looks like, only the order things are in:
+ * 1. Triangles for the vertex cache (Tipsify), which also splits them into clusters at every point the cache gets cold
+ * 2. Those clusters, most outward facing first, so the front of the mesh tends to draw before the back (less overdraw)
+ * 3. Vertices in the order the indices first use them, so vertex fetch walks memory forwards
+ * Linear time, meant for cooking.
+ */
+void optimizeModel(Model& model);
+/**
+ * Narrow 32 bit indices to 16 bit. Only for meshes with at most JE_MAX_SHORT_INDEX_VERTICES vertices.
+ */
+std::vector<uint16_t> shortenIndices(std::span<const unsigned int> indices);
+/**
+ * Cook parsed models into a .jmesh. Every model becomes a submesh of one shared vertex/index buffer.
+ * @param vertexFormat JE_VERTEX_COMPACT16 only draws with shaders that support it, see JECompactVertex.
+ * @return The whole file
+ */
+std::vector<std::byte> cookMesh(const std::vector<Model>& models, JECookedVertexFormat vertexFormat = JE_VERTEX_FLOAT32);
+/**
+ * @return Whether these bytes start like a cooked mesh. Cheap, for picking a loader.
+ */
+bool isCookedMesh(std::span<const std::byte> bytes);
+/**
+ * Read and bounds check a cooked mesh. Throws std::runtime_error if it's broken.
+ */
+JECookedMesh parseCookedMesh(std::span<const std::byte> bytes);
+
+#endif //JOSHENGINE_MESHUTIL_H
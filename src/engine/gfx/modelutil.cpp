@@ -6,9 +6,12 @@
 #include <iostream>
 #include <utility>
 #include <unordered_map>
+#include <cstring>
 #include "../jbd/bundleutil.h"
 #include "renderable.h"
 #include "modelutil.h"
+#include "vk/gfx_vk.h"
+#include "../job/jobutil.h"
 
 Renderable quadBase;
 
@@ -32,216 +35,29 @@ Renderable createQuad(unsigned int shader, std::vector<unsigned int> desc, bool
     return copy;
 }
 
-struct repackVertexObject {
-    glm::vec3 pos;
-    glm::vec2 uvs;
-    glm::vec3 nml;
-
-    [[nodiscard]] bool equals(repackVertexObject r) const {
-        return r.pos == pos && r.uvs == uvs && r.nml == nml;
-    }
-};
-
-Model repackModel(Model r) {
-    std::vector<repackVertexObject> repackList = {};
-    std::vector<unsigned int> indices = {};
-
-    // Generate unique lists
-    for (int i = 0; i < r.vertices.size()/3; i++) {
-        // new vertex object with current properties
-        repackVertexObject currentVertexObject = {
-                {r.vertices[i*3], r.vertices[(i*3)+1], r.vertices[(i*3)+2]},
-                {r.uvs[i*2], r.uvs[(i*2)+1]},
-                {r.normals[i*3], r.normals[(i*3)+1], r.normals[(i*3)+2]}};
-
-        // assume not duplicate
-        bool add = true;
-        for (int j = 0; j < repackList.size(); j++) {
-            if (currentVertexObject.equals(repackList[j++])) {
-                // if this is a duplicate, don't add it to the list and push the current index in repack
-                add = false;
-                // There's probably a reason j-1 works.
-                // I don't know what that reason is in any way shape or form.
-                // I typed it in to see what would happen. It fixed it.
-                // It might have to do with OBJ's indices starting at 1.
-                // Nobody but God himself knows.
-                // Don't touch this line. Please.
-                indices.push_back(j-1);
-                break;
-            }
-        }
-        if (add) {
-            indices.push_back(repackList.size());
-            repackList.push_back(currentVertexObject);
-        }
-    }
-
-    std::vector<float> vertices;
-    std::vector<float> colors;
-    std::vector<float> uvs;
-    std::vector<float> normals;
-
-    for (auto vert : repackList) {
-        vertices.push_back(vert.pos.x);
-        vertices.push_back(vert.pos.y);
-        vertices.push_back(vert.pos.z);
-
-        uvs.push_back(vert.uvs.x);
-        uvs.push_back(vert.uvs.y);
-
-        normals.push_back(vert.nml.x);
-        normals.push_back(vert.nml.y);
-        normals.push_back(vert.nml.z);
-    }
+std::unordered_map<std::string, std::vector<Renderable>> objMap;
 
-    return {vertices, uvs, normals, indices};
+// Cooked meshes are already in GPU layout, so they go up as is.
+Renderable loadCookedMesh(std::span<const std::byte> fileContents, unsigned int shaderProgram, const std::vector<unsigned int>& desc, const bool manualDepthSort) {
+    JECookedMesh mesh = parseCookedMesh(fileContents);
+
+    Renderable r;
+    r.flags = static_cast<unsigned char>(0b1 | (manualDepthSort ? 0b10 : 0));
+    r.shaderProgram = shaderProgram;
+    r.descriptorIDs = desc;
+    r.vboID = createVBO(mesh);
+    r.indicesSize = mesh.header.indexCount;
+    return r;
 }
 
-std::vector<std::string> splitStr(const std::string& in, char del) {
-    std::string store;
-
-    std::stringstream stream(in);
-
-    std::vector<std::string> v;
-
-    while (getline(stream, store, del)) {
-        v.push_back(store);
+std::vector<Renderable> loadObj(std::span<const std::byte> fileContents, unsigned int shaderProgram, const std::vector<unsigned int>& desc, const bool manualDepthSort) {
+    if (isCookedMesh(fileContents)) {
+        return {loadCookedMesh(fileContents, shaderProgram, desc, manualDepthSort)};
     }
-
-    std::vector<std::string> v2;
-    for (const auto& a : v) {
-        if (!a.empty()) {
-            v2.push_back(a);
-        }
-    }
-
-    return v2;
-}
-
-std::unordered_map<std::string, std::vector<Renderable>> objMap;
-
-std::vector<Renderable> loadObj(const std::vector<unsigned char>& fileContents, unsigned int shaderProgram, const std::vector<unsigned int>& desc, const bool manualDepthSort) {
     std::vector<Renderable> renderableList;
-
-    std::string currentLine;
-    Model currentRenderable;
-
-    // Stupid solution to everything starting at 1.
-    std::vector<glm::vec3> modelVertices = {{0, 0, 0}};
-    std::vector<glm::vec2> modelUVs = {{0, 0}};
-    std::vector<glm::vec3> modelNormals = {{0, 1, 0}};
-
-    for (char currentChar : fileContents) {
-        if (currentChar != '\n') currentLine += currentChar;
-        else {
-            std::vector<std::string> split = splitStr(currentLine, ' ');
-            currentLine = "";
-
-            if (!split.empty() && split[split.size()-1].ends_with("\r")) { // Fucking windows.
-                split[split.size()-1] = split[split.size()-1].substr(0, split[split.size()-1].length()-1);
-            }
-
-            if (split.empty() || split[0] == "#" || split[0].empty()) {
-                continue; // This line of the file is a comment
-            }
-
-            // God I wish a switch/case worked here...
-            if        (split[0] == "v")  {
-                // vertex position
-                modelVertices.emplace_back(std::stof(split[1]), std::stof(split[2]), std::stof(split[3]));
-            } else if (split[0] == "vt") {
-                // vertex texture coordinate
-                modelUVs.emplace_back(std::stof(split[1]), std::stof(split[2]));
-            } else if (split[0] == "vn") {
-                // vertex normal
-                modelNormals.emplace_back(std::stof(split[1]), std::stof(split[2]), std::stof(split[3]));
-            } else if (split[0] == "f")  {
-                // face
-                for (int i = 1; i <= 3; i++) {
-                    // for each index combo
-                    if (split[i].find("//") != std::string::npos) {
-                        // formatted as v//n
-                        std::vector<std::string> vertexSplit = splitStr(split[i], '/');
-                        unsigned int vertexIndex = std::stoi(vertexSplit[0]);
-                        unsigned int normalIndex = std::stoi(vertexSplit[1]);
-
-                        currentRenderable.indices.push_back(currentRenderable.vertices.size()/3);
-
-                        currentRenderable.vertices.push_back(modelVertices[vertexIndex].x);
-                        currentRenderable.vertices.push_back(modelVertices[vertexIndex].y);
-                        currentRenderable.vertices.push_back(modelVertices[vertexIndex].z);
-
-                        currentRenderable.uvs.push_back(modelUVs[0].x);
-                        currentRenderable.uvs.push_back(modelUVs[0].y);
-
-                        currentRenderable.normals.push_back(modelNormals[normalIndex].x);
-                        currentRenderable.normals.push_back(modelNormals[normalIndex].y);
-                        currentRenderable.normals.push_back(modelNormals[normalIndex].z);
-
-                    } else if (split[i].find('/') != std::string::npos) {
-                        // formatted as either v/t or v/t/n
-                        std::vector<std::string> vertexSplit = splitStr(split[i], '/');
-                        unsigned int vertexIndex = std::stoi(vertexSplit[0]);
-                        unsigned int texcrdIndex = std::stoi(vertexSplit[1]);
-                        unsigned int normalIndex = 0;
-                        if (vertexSplit.size() == 3) {
-                            normalIndex = std::stoi(vertexSplit[2]);
-                        }
-
-
-                        currentRenderable.indices.push_back(currentRenderable.vertices.size()/3);
-
-                        currentRenderable.vertices.push_back(modelVertices[vertexIndex].x);
-                        currentRenderable.vertices.push_back(modelVertices[vertexIndex].y);
-                        currentRenderable.vertices.push_back(modelVertices[vertexIndex].z);
-
-                        currentRenderable.uvs.push_back(modelUVs[texcrdIndex].x);
-                        currentRenderable.uvs.push_back(modelUVs[texcrdIndex].y);
-
-                        currentRenderable.normals.push_back(modelNormals[normalIndex].x);
-                        currentRenderable.normals.push_back(modelNormals[normalIndex].y);
-                        currentRenderable.normals.push_back(modelNormals[normalIndex].z);
-
-                    } else {
-                        // formatted as v
-                        unsigned int index = std::stoi(split[i]);
-
-                        currentRenderable.indices.push_back(currentRenderable.vertices.size()/3);
-
-                        currentRenderable.vertices.push_back(modelVertices[index].x);
-                        currentRenderable.vertices.push_back(modelVertices[index].y);
-                        currentRenderable.vertices.push_back(modelVertices[index].z);
-
-                        currentRenderable.uvs.push_back(modelUVs[0].x);
-                        currentRenderable.uvs.push_back(modelUVs[0].y);
-
-                        currentRenderable.normals.push_back(modelNormals[0].x);
-                        currentRenderable.normals.push_back(modelNormals[0].y);
-                        currentRenderable.normals.push_back(modelNormals[0].z);
-
-                    }
-                }
-            } else if ((split[0] == "s") || (split[0] == "mtllib")) {
-                // smooth shaded enabled (ignore this case)
-                // load material (ignore this case)
-            } else if (split[0] == "usemtl" || split[0] == "o" || split[0] == "g") {
-                // use specific material
-                if (!currentRenderable.vertices.empty()) {
-                    Model repacked = repackModel(currentRenderable);
-                    renderableList.emplace_back(repacked.vertices, repacked.uvs, repacked.normals, repacked.indices, shaderProgram, desc, manualDepthSort);
-                }
-                currentRenderable = {};
-            }
-            else if (split[0] == "vp" || split[0] == "l") {
-                std::cerr << "OBJ uses unsupported parameter space vertex or line element! Cancelling load." << std::endl;
-                return {};
-            } else {
-                std::cerr << "Unrecognized token \"" << split[0] << "\""<< std::endl;
-            }
-        }
+    for (const Model& m : parseObj(fileContents)) {
+        renderableList.emplace_back(m.vertices, m.uvs, m.normals, m.indices, shaderProgram, desc, manualDepthSort);
     }
-    Model repacked = repackModel(currentRenderable);
-    renderableList.emplace_back(repacked.vertices, repacked.uvs, repacked.normals, repacked.indices, shaderProgram, desc, manualDepthSort);
     return renderableList;
 }
 
@@ -299,12 +115,86 @@ std::vector<Renderable> loadBundledObj(const std::string& path, const std::strin
         return copied;
     }
 
-    std::vector<unsigned char> fileContents = getFileCharVec(path, bundleFileName);
-    std::vector<Renderable> renderableList = loadObj(fileContents, shaderProgram, desc, manualDepthSort);
+    std::vector<std::byte> storage;
+    std::vector<Renderable> renderableList = loadObj(getBundledFile(path, bundleFileName, storage), shaderProgram, desc, manualDepthSort);
     objMap.insert({path, renderableList});
     return renderableList;
 }
 
 std::vector<Renderable> loadObj(const std::string& path, unsigned int shaderProgram, const std::vector<unsigned int>& desc, const bool manualDepthSort) {
     return loadBundledObj(path, "./obj_bundle.jbd", shaderProgram, desc, manualDepthSort);
+}
+
+// Bundle + path -> reserved VBO. The same file only ever gets parsed and uploaded once no matter how many things use it.
+std::unordered_map<std::string, unsigned int> asyncObjMap;
+
+Renderable loadBundledObjAsync(const std::string& path, const std::string& bundleFileName, unsigned int shaderProgram, const std::vector<unsigned int>& desc, const bool manualDepthSort) {
+    Renderable r;
+    r.flags = static_cast<unsigned char>(0b1 | (manualDepthSort ? 0b10 : 0));
+    r.shaderProgram = shaderProgram;
+    r.descriptorIDs = desc;
+
+    // Null separated, neither half can have one in it
+    std::string key = bundleFileName + '\0' + path;
+    if (asyncObjMap.contains(key)) {
+        r.vboID = asyncObjMap.at(key);
+        return r;
+    }
+
+    r.vboID = reserveVBO();
+    asyncObjMap.insert({key, r.vboID});
+
+    unsigned int vboID = r.vboID;
+    submitJob([vboID, path, bundleFileName]() {
+        JEMeshUpload_VK upload{vboID, {}, {}};
+        try {
+            std::vector<std::byte> storage;
+            std::span<const std::byte> file = getBundledFile(path, bundleFileName, storage);
+            if (isCookedMesh(file)) {
+                // Already GPU layout. Goes straight from the mapping (or storage, if it was compressed) to staging.
+                JECookedMesh mesh = parseCookedMesh(file);
+                upload.cookedVertices = mesh.vertices;
+                upload.cookedIndices = mesh.indices;
+                upload.vertexFormat = static_cast<JECookedVertexFormat>(mesh.header.vertexFormat);
+                upload.indexSize = mesh.header.indexSize;
+                if (upload.vertexFormat == JE_VERTEX_COMPACT16) upload.dequantize = getDequantizeMatrix(mesh.header);
+                upload.storage = std::move(storage);
+                queueMeshUpload(std::move(upload));
+                return;
+            }
+            // Every object/material group shares the same shader and descriptors, so they all go in one VBO.
+            for (const Model& m : parseObj(file)) {
+                auto base = static_cast<unsigned int>(upload.vertices.size());
+                for (size_t i = 0; i < m.vertices.size()/3; i++) {
+                    upload.vertices.push_back({
+                        {m.vertices[3*i],  m.vertices[(3*i)+1], m.vertices[(3*i)+2]},
+                        {m.uvs[(2*i)],     m.uvs[(2*i)+1]},
+                        {m.normals[(3*i)], m.normals[(3*i)+1],  m.normals[(3*i)+2]}
+                    });
+                }
+                for (unsigned int index : m.indices) {
+                    upload.indices.push_back(base + index);
+                }
+            }
+            if (upload.vertices.size() <= JE_MAX_SHORT_INDEX_VERTICES) {
+                // Narrowed here instead of on the render thread. storage is free since this isn't from a mapping.
+                std::vector<uint16_t> shortIndices = shortenIndices(upload.indices);
+                upload.storage.resize(shortIndices.size() * sizeof(uint16_t));
+                memcpy(upload.storage.data(), shortIndices.data(), upload.storage.size());
+                upload.cookedIndices = upload.storage;
+                upload.indexSize = sizeof(uint16_t);
+                upload.indices.clear();
+            }
+        } catch (std::exception &e) {
+            // Missing from the bundle, or a number in the file std::stof didn't like
+            std::cerr << "Failed to load OBJ \"" << path << "\"! It will stay empty." << std::endl;
+            return;
+        }
+        queueMeshUpload(std::move(upload));
+    });
+    return r;
+}
+
+Renderable loadObjAsync(const std::string& path, unsigned int shaderProgram, const std::vector<unsigned int>& desc, const bool manualDepthSort) {
+    return loadBundledObjAsync(path, "./obj_bundle.jbd", shaderProgram, desc, manualDepthSort);
 }
\ No newline at end of file
@@ -5,15 +5,16 @@
 #ifndef JOSHENGINE_MODELUTIL
 #define JOSHENGINE_MODELUTIL
 
-struct Model {
-    std::vector<float> vertices{};
-    std::vector<float> uvs{};
-    std::vector<float> normals{};
-    std::vector<unsigned int> indices{};
-};
+#include "meshutil.h"
 
 Renderable createQuad(unsigned int shader, std::vector<unsigned int> desc, bool manualDepthSort = false);
 std::vector<Renderable> loadObj(const std::string& path, unsigned int shaderProgram, const std::vector<unsigned int>& desc, bool manualDepthSort = false);
 std::vector<Renderable> loadBundledObj(const std::string& path, const std::string& bundleFileName,  unsigned int shaderProgram, const std::vector<unsigned int>& desc, const bool manualDepthSort = false);
+// Paths can point at either an OBJ or a cooked .jmesh (jbdpack --cook-meshes keeps the .obj path), cooked ones skip parsing.
+// A cooked mesh always comes back as a single Renderable.
+// Async versions return right away with an enabled Renderable that draws nothing until a job worker has parsed the file
+// and renderFrame has uploaded it. Every group in the file ends up merged into that one Renderable.
+Renderable loadObjAsync(const std::string& path, unsigned int shaderProgram, const std::vector<unsigned int>& desc, bool manualDepthSort = false);
+Renderable loadBundledObjAsync(const std::string& path, const std::string& bundleFileName, unsigned int shaderProgram, const std::vector<unsigned int>& desc, bool manualDepthSort = false);
 
 #endif //JOSHENGINE_MODELUTIL
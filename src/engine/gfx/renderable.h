@@ -47,6 +47,43 @@ struct JEInterleavedVertex_VK {
         return attributeDescriptions;
     }
 };
+
+// JE_VERTEX_COMPACT16 from meshutil. Position comes out in 0-1 across the mesh's bounds (renderFrame folds the
+// dequantization into the model matrix) and the normal as two octahedral numbers the vertex shader has to unpack.
+struct JECompactVertex_VK {
+    uint16_t position[4];
+    uint16_t uvCoords[2];
+    int16_t normal[2];
+
+    static VkVertexInputBindingDescription getBindingDescription() {
+        VkVertexInputBindingDescription bindingDescription{};
+        bindingDescription.binding = 0;
+        bindingDescription.stride = sizeof(JECompactVertex_VK);
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+        return bindingDescription;
+    }
+
+    static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions() {
+        std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions{};
+        attributeDescriptions[0].binding = 0;
+        attributeDescriptions[0].location = 0;
+        attributeDescriptions[0].format = VK_FORMAT_R16G16B16A16_UNORM; // vec3, w is padding
+        attributeDescriptions[0].offset = offsetof(JECompactVertex_VK, position);
+
+        attributeDescriptions[1].binding = 0;
+        attributeDescriptions[1].location = 1;
+        attributeDescriptions[1].format = VK_FORMAT_R16G16_SFLOAT; // vec2
+        attributeDescriptions[1].offset = offsetof(JECompactVertex_VK, uvCoords);
+
+        attributeDescriptions[2].binding = 0;
+        attributeDescriptions[2].location = 2;
+        attributeDescriptions[2].format = VK_FORMAT_R16G16_SNORM; // vec2, octahedral
+        attributeDescriptions[2].offset = offsetof(JECompactVertex_VK, normal);
+
+        return attributeDescriptions;
+    }
+};
 #endif
 
 class Renderable {
@@ -0,0 +1,259 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#include "texutil.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+float srgbToLinear(float c) {
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+float linearToSrgb(float c) {
+    return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+}
+
+unsigned char toByte(float c) {
+    return static_cast<unsigned char>(std::lround(std::clamp(c, 0.0f, 1.0f) * 255.0f));
+}
+
+// Zeroth order modified Bessel function of the first kind, for the Kaiser window.
+double bessel0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+struct JEFilterTap {
+    int source;
+    float weight;
+};
+
+// Which source texels (and how much of each) make up every destination texel along one axis.
+// Taps wrap around the edges since every texture sampler is VK_SAMPLER_ADDRESS_MODE_REPEAT.
+std::vector<std::vector<JEFilterTap>> filterWeights(int sourceSize, int destinationSize, bool kaiser) {
+    std::vector<std::vector<JEFilterTap>> weights(destinationSize);
+    double scale = static_cast<double>(sourceSize) / destinationSize;
+    const double radius = 2.0; // In destination texels
+    const double beta = 4.0;
+    const double pi = 3.14159265358979323846;
+
+    for (int i = 0; i < destinationSize; i++) {
+        double total = 0;
+        if (kaiser) {
+            double center = (i + 0.5) * scale;
+            int first = static_cast<int>(std::floor(center - radius * scale));
+            int last = static_cast<int>(std::ceil(center + radius * scale));
+            for (int j = first; j <= last; j++) {
+                double x = (j + 0.5 - center) / scale;
+                if (std::fabs(x) >= radius) continue;
+                double sinc = x == 0 ? 1.0 : std::sin(pi * x) / (pi * x);
+                double window = bessel0(beta * std::sqrt(1.0 - (x / radius) * (x / radius))) / bessel0(beta);
+                weights[i].push_back({((j % sourceSize) + sourceSize) % sourceSize, static_cast<float>(sinc * window)});
+                total += sinc * window;
+            }
+        } else {
+            // Exact box: how much of each source texel falls inside this destination texel.
+            double low = i * scale, high = (i + 1) * scale;
+            for (int j = static_cast<int>(std::floor(low)); j < static_cast<int>(std::ceil(high)); j++) {
+                double coverage = std::min(high, j + 1.0) - std::max(low, static_cast<double>(j));
+                if (coverage <= 0) continue;
+                weights[i].push_back({std::min(j, sourceSize - 1), static_cast<float>(coverage)});
+                total += coverage;
+            }
+        }
+        for (auto& tap : weights[i]) tap.weight = static_cast<float>(tap.weight / total);
+    }
+    return weights;
+}
+
+// Separable resample of a linear float RGBA image.
+std::vector<float> downsample(const std::vector<float>& source, int width, int height, int newWidth, int newHeight, bool kaiser) {
+    std::vector<std::vector<JEFilterTap>> horizontal = filterWeights(width, newWidth, kaiser);
+    std::vector<std::vector<JEFilterTap>> vertical = filterWeights(height, newHeight, kaiser);
+
+    std::vector<float> rows(static_cast<size_t>(newWidth) * height * 4, 0.0f);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < newWidth; x++) {
+            float* out = &rows[(static_cast<size_t>(y) * newWidth + x) * 4];
+            for (const auto& tap : horizontal[x]) {
+                const float* in = &source[(static_cast<size_t>(y) * width + tap.source) * 4];
+                for (int c = 0; c < 4; c++) out[c] += in[c] * tap.weight;
+            }
+        }
+    }
+
+    std::vector<float> result(static_cast<size_t>(newWidth) * newHeight * 4, 0.0f);
+    for (int y = 0; y < newHeight; y++) {
+        for (int x = 0; x < newWidth; x++) {
+            float* out = &result[(static_cast<size_t>(y) * newWidth + x) * 4];
+            for (const auto& tap : vertical[y]) {
+                const float* in = &rows[(static_cast<size_t>(tap.source) * newWidth + x) * 4];
+                for (int c = 0; c < 4; c++) out[c] += in[c] * tap.weight;
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<std::vector<unsigned char>> buildMipChain(const unsigned char* rgba, int width, int height, bool srgb, bool kaiser) {
+    float toLinear[256];
+    for (int i = 0; i < 256; i++) toLinear[i] = srgb ? srgbToLinear(i / 255.0f) : i / 255.0f;
+
+    std::vector<std::vector<unsigned char>> levels;
+    levels.emplace_back(rgba, rgba + static_cast<size_t>(width) * height * 4);
+
+    // Every level is made from the last one in float, so nothing gets rounded to 8 bits more than once.
+    std::vector<float> current(static_cast<size_t>(width) * height * 4);
+    for (size_t i = 0; i < current.size(); i++) {
+        current[i] = (i & 3) == 3 ? rgba[i] / 255.0f : toLinear[rgba[i]];
+    }
+
+    while (width > 1 || height > 1) {
+        int newWidth = std::max(width / 2, 1);
+        int newHeight = std::max(height / 2, 1);
+        current = downsample(current, width, height, newWidth, newHeight, kaiser);
+        width = newWidth;
+        height = newHeight;
+
+        std::vector<unsigned char> level(current.size());
+        for (size_t i = 0; i < current.size(); i++) {
+            level[i] = (i & 3) == 3 || !srgb ? toByte(current[i]) : toByte(linearToSrgb(std::clamp(current[i], 0.0f, 1.0f)));
+        }
+        levels.push_back(std::move(level));
+    }
+    return levels;
+}
+
+JEBlockFormat cookedToBlockFormat(JECookedFormat format) {
+    switch (format) {
+        case JE_COOKED_BC1: return JE_BLOCK_BC1;
+        case JE_COOKED_BC3: return JE_BLOCK_BC3;
+        case JE_COOKED_BC5: return JE_BLOCK_BC5;
+        case JE_COOKED_BC7: return JE_BLOCK_BC7;
+        default: throw std::runtime_error("Cooked texture format isn't block compressed!");
+    }
+}
+
+bool isBlockCompressed(JECookedFormat format) {
+    return format != JE_COOKED_RGBA8_SRGB && format != JE_COOKED_RGBA8_UNORM;
+}
+
+size_t cookedLevelBytes(JECookedFormat format, uint32_t width, uint32_t height) {
+    if (isBlockCompressed(format)) return bcImageBytes(cookedToBlockFormat(format), static_cast<int>(width), static_cast<int>(height));
+    return static_cast<size_t>(width) * height * 4;
+}
+
+std::vector<unsigned char> writeCookedTexture(JECookedFormat format, int width, int height, const std::vector<std::vector<unsigned char>>& levels) {
+    JECookedTextureHeader header{};
+    header.format = format;
+    header.width = width;
+    header.height = height;
+    header.mipCount = levels.size();
+
+    auto align = [](size_t offset) { return (offset + JE_COOKED_TEXTURE_ALIGN - 1) & ~static_cast<size_t>(JE_COOKED_TEXTURE_ALIGN - 1); };
+
+    std::vector<JECookedMip> mips;
+    size_t offset = align(sizeof(JECookedTextureHeader) + sizeof(JECookedMip) * levels.size());
+    for (const auto& level : levels) {
+        mips.push_back({offset, level.size()});
+        offset = align(offset + level.size());
+    }
+
+    std::vector<unsigned char> file(offset, 0);
+    memcpy(file.data(), &header, sizeof(header));
+    memcpy(file.data() + sizeof(header), mips.data(), sizeof(JECookedMip) * mips.size());
+    for (size_t i = 0; i < levels.size(); i++) {
+        memcpy(file.data() + mips[i].offset, levels[i].data(), levels[i].size());
+    }
+    return file;
+}
+
+std::vector<unsigned char> cookTexture(const unsigned char* rgba, int width, int height, JECookedFormat format, bool kaiser) {
+    bool linear = format == JE_COOKED_BC5 || format == JE_COOKED_RGBA8_UNORM;
+    std::vector<std::vector<unsigned char>> levels;
+    if (linear) {
+        // These get sampled from a UNORM image, but the source was made to be sampled as sRGB. Convert it now.
+        std::vector<unsigned char> converted(rgba, rgba + static_cast<size_t>(width) * height * 4);
+        for (size_t i = 0; i < converted.size(); i++) {
+            if ((i & 3) != 3) converted[i] = toByte(srgbToLinear(converted[i] / 255.0f));
+        }
+        levels = buildMipChain(converted.data(), width, height, false, kaiser);
+    } else {
+        levels = buildMipChain(rgba, width, height, true, kaiser);
+    }
+
+    if (isBlockCompressed(format)) {
+        int levelWidth = width, levelHeight = height;
+        for (auto& level : levels) {
+            level = bcEncode(cookedToBlockFormat(format), level.data(), levelWidth, levelHeight);
+            levelWidth = std::max(levelWidth / 2, 1);
+            levelHeight = std::max(levelHeight / 2, 1);
+        }
+    }
+
+    return writeCookedTexture(format, width, height, levels);
+}
+
+bool isCookedTexture(const unsigned char* bytes, size_t length) {
+    if (length < sizeof(JECookedTextureHeader)) return false;
+    uint32_t magic;
+    memcpy(&magic, bytes, sizeof(magic));
+    return magic == JE_COOKED_TEXTURE_MAGIC;
+}
+
+JECookedTexture parseCookedTexture(const unsigned char* bytes, size_t length) {
+    if (!isCookedTexture(bytes, length)) {
+        throw std::runtime_error("Not a cooked texture!");
+    }
+    JECookedTextureHeader header;
+    memcpy(&header, bytes, sizeof(header));
+    if (header.version != JE_COOKED_TEXTURE_VERSION) {
+        throw std::runtime_error("Cooked texture is version " + std::to_string(header.version) + ", expected " + std::to_string(JE_COOKED_TEXTURE_VERSION) + "!");
+    }
+    if (header.format > JE_COOKED_BC7 || header.width == 0 || header.height == 0 || header.mipCount == 0 || header.mipCount > 32 ||
+        length < sizeof(header) + sizeof(JECookedMip) * header.mipCount) {
+        throw std::runtime_error("Cooked texture header is broken!");
+    }
+
+    JECookedTexture texture{static_cast<JECookedFormat>(header.format), header.width, header.height, std::vector<JECookedMip>(header.mipCount)};
+    memcpy(texture.mips.data(), bytes + sizeof(header), sizeof(JECookedMip) * header.mipCount);
+
+    // Levels have to come after the table and in order without overlapping, uploads work out sizes by subtracting offsets
+    uint64_t levelsStart = sizeof(header) + sizeof(JECookedMip) * header.mipCount;
+    uint32_t levelWidth = header.width, levelHeight = header.height;
+    for (const auto& mip : texture.mips) {
+        if (mip.offset < levelsStart || mip.offset > length || mip.size > length - mip.offset ||
+            mip.size != cookedLevelBytes(texture.format, levelWidth, levelHeight)) {
+            throw std::runtime_error("Cooked texture mip table is broken!");
+        }
+        levelsStart = mip.offset + mip.size;
+        levelWidth = std::max(levelWidth / 2, 1u);
+        levelHeight = std::max(levelHeight / 2, 1u);
+    }
+    return texture;
+}
+
+std::vector<unsigned char> decompressCookedTexture(const unsigned char* bytes, size_t length) {
+    JECookedTexture texture = parseCookedTexture(bytes, length);
+    if (!isBlockCompressed(texture.format)) return {bytes, bytes + length};
+
+    std::vector<std::vector<unsigned char>> levels;
+    int levelWidth = static_cast<int>(texture.width), levelHeight = static_cast<int>(texture.height);
+    for (const auto& mip : texture.mips) {
+        levels.push_back(bcDecode(cookedToBlockFormat(texture.format), bytes + mip.offset, levelWidth, levelHeight));
+        levelWidth = std::max(levelWidth / 2, 1);
+        levelHeight = std::max(levelHeight / 2, 1);
+    }
+    // BC5 was cooked linear, keep it that way
+    JECookedFormat format = texture.format == JE_COOKED_BC5 ? JE_COOKED_RGBA8_UNORM : JE_COOKED_RGBA8_SRGB;
+    return writeCookedTexture(format, static_cast<int>(texture.width), static_cast<int>(texture.height), levels);
+}
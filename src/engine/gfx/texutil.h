@@ -0,0 +1,84 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#ifndef JOSHENGINE_TEXUTIL_H
+#define JOSHENGINE_TEXUTIL_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "bcutil.h"
+
+// Cooked textures (.jtex) are ready to go straight to the GPU: the pixels are already in their final format and
+// every mip level is already there, so loading one is a memcpy into staging and a single copy command.
+//
+// Layout, all little endian:
+//   JECookedTextureHeader
+//   JECookedMip[mipCount]    offset/size of every level from the start of the file, level 0 is full size
+//   level data               each level starts on a JE_COOKED_TEXTURE_ALIGN boundary
+#define JE_COOKED_TEXTURE_MAGIC 0x5845544A // "JTEX"
+#define JE_COOKED_TEXTURE_VERSION 1
+#define JE_COOKED_TEXTURE_ALIGN 16
+
+enum JECookedFormat : uint32_t {
+    JE_COOKED_RGBA8_SRGB = 0,
+    JE_COOKED_RGBA8_UNORM = 1,
+    JE_COOKED_BC1 = 2,
+    JE_COOKED_BC3 = 3,
+    JE_COOKED_BC5 = 4,
+    JE_COOKED_BC7 = 5
+};
+
+struct JECookedTextureHeader {
+    uint32_t magic = JE_COOKED_TEXTURE_MAGIC;
+    uint32_t version = JE_COOKED_TEXTURE_VERSION;
+    uint32_t format = JE_COOKED_RGBA8_SRGB;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t mipCount = 0;
+};
+
+struct JECookedMip {
+    uint64_t offset;
+    uint64_t size;
+};
+
+// Parsed view of a cooked texture. The mip offsets point into whatever buffer was parsed, nothing gets copied.
+struct JECookedTexture {
+    JECookedFormat format;
+    uint32_t width;
+    uint32_t height;
+    std::vector<JECookedMip> mips;
+};
+
+/**
+ * Generate a full mip chain (down to 1x1) on the CPU.
+ * Color channels are filtered in linear space when srgb is set, so dark and bright texels average out properly.
+ * @param rgba width * height * 4 bytes, level 0
+ * @param srgb Whether RGB is sRGB encoded (albedo) or already linear (spec/emissive). Alpha is always linear.
+ * @param kaiser Kaiser windowed sinc instead of a box filter. Sharper mips, a bit slower to cook.
+ * @return Every level including level 0, each one half the size of the last (rounded down, minimum 1).
+ */
+std::vector<std::vector<unsigned char>> buildMipChain(const unsigned char* rgba, int width, int height, bool srgb, bool kaiser);
+/**
+ * Cook an RGBA8 image into a .jtex: mips, then compression if format asks for it.
+ * BC5 output is written linear (there's no sRGB BC5), so it samples the same as the sRGB RGBA8 it replaces.
+ * @return The whole file
+ */
+std::vector<unsigned char> cookTexture(const unsigned char* rgba, int width, int height, JECookedFormat format, bool kaiser = true);
+/**
+ * @return Whether these bytes start like a cooked texture. Cheap, for picking a loader.
+ */
+bool isCookedTexture(const unsigned char* bytes, size_t length);
+/**
+ * Read and bounds check a cooked texture's header and mip table. Throws std::runtime_error if it's broken.
+ */
+JECookedTexture parseCookedTexture(const unsigned char* bytes, size_t length);
+/**
+ * Turn a block compressed cooked texture into an RGBA8 one, for GPUs without textureCompressionBC.
+ * RGBA8 input comes back unchanged.
+ */
+std::vector<unsigned char> decompressCookedTexture(const unsigned char* bytes, size_t length);
+
+#endif //JOSHENGINE_TEXUTIL_H
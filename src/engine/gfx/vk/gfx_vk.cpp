@@ -20,12 +20,17 @@
 #include <sstream>
 #include <string>
 #include "../spirv/spirv-helper.h"
+#include "../bcutil.h"
+#include "../texutil.h"
 #include <queue>
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 #include "../imgui/imgui_impl_glfw.h"
 #include "../imgui/imgui_impl_vulkan.h"
 #include <optional>
+#include <unordered_map>
+#include <mutex>
+#include <future>
 
 GLFWwindow** windowPtr;
 JEGraphicsSettings settings;
@@ -49,13 +54,68 @@ std::vector<VkImageView> swapchainImageViews;
 
 // This is a system to get the same "ID" concept working as with OpenGL.
 std::vector<VkShaderModule> shaderModuleVector;
+// Module ID -> the same vertex shader compiled with JE_COMPACT_VERTICES defined, or -1 if it hasn't been needed yet.
+std::vector<int> compactShaderModules;
+// Module ID -> its GLSL with JE_COMPACT_VERTICES defined, empty if it has no such path. Only compiled once a compact
+// mesh actually gets drawn with it, see getCompactPipeline.
+std::vector<std::string> compactShaderSources;
+// Shader modules are kept alive until deinit, so the same file + stage never gets compiled twice.
+// Futures so that two jobs asking for the same module at once compile it once and the second one just waits.
+std::unordered_map<std::string, std::shared_future<unsigned int>> shaderModuleCache;
 
 VkRenderPass renderPass;
 
 // Same idea as the ID concept but with Pipelines roughly equating to Shader Programs
 std::vector<VkPipeline> pipelineVector;
+// Same IDs, the pipeline for JE_VERTEX_COMPACT16 meshes. VK_NULL_HANDLE until one gets drawn with it, and for good if
+// the vertex shader can't read them.
+std::vector<VkPipeline> compactPipelineVector;
+// One entry per pipeline ID, but the handles are shared between pipelines with identical descriptor inputs.
+// The cache below owns them, so destroy from there and not from this vector.
 std::vector<VkPipelineLayout> pipelineLayoutVector;
 
+struct JEPipelineKey_VK {
+    unsigned int vertexModule;
+    unsigned int fragmentModule;
+    bool testDepth;
+    bool transparencySupported;
+    bool doubleSided;
+    bool depthAlwaysPass;
+    uint32_t shaderInputs;
+    uint8_t shaderInputCount;
+
+    bool operator==(const JEPipelineKey_VK& other) const = default;
+};
+
+struct JEPipelineKeyHash_VK {
+    size_t operator()(const JEPipelineKey_VK& k) const {
+        // FNV-1a over the fields, good enough for the handful of pipelines a game makes
+        uint64_t hash = 0xcbf29ce484222325;
+        auto mix = [&hash](uint64_t v) { hash ^= v; hash *= 0x100000001b3; };
+        mix(k.vertexModule);
+        mix(k.fragmentModule);
+        mix(k.testDepth | (k.transparencySupported << 1) | (k.doubleSided << 2) | (k.depthAlwaysPass << 3));
+        mix(k.shaderInputs);
+        mix(k.shaderInputCount);
+        return static_cast<size_t>(hash);
+    }
+};
+
+std::unordered_map<JEPipelineKey_VK, unsigned int, JEPipelineKeyHash_VK> pipelineDedupMap;
+// Pipeline ID -> what it was made from, so its compact version can be made later on
+std::vector<JEPipelineKey_VK> pipelineKeyVector;
+// Keyed by (shaderInputCount << 32 | used shaderInputs bits), since that's all a layout depends on.
+std::unordered_map<uint64_t, VkPipelineLayout> pipelineLayoutCache;
+
+// Driver-side compile cache, persisted between runs in PIPELINE_CACHE_FILE.
+VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+
+// loadShader and createProgram can run on job workers (see createShaderAsync).
+// This guards everything above, and renderFrame holds it while it reads pipelineVector.
+// Actual compilation and vkCreateGraphicsPipelines happen outside the lock, except for compact pipelines, which
+// renderFrame builds under it the first time it needs one (see getCompactPipeline).
+std::mutex pipelineMutex;
+
 std::vector<VkFramebuffer> swapchainFramebuffers;
 
 VkCommandPool commandPool;
@@ -73,6 +133,13 @@ std::vector<VkBuffer> vertexBuffers;
 std::vector<JEAllocation_VK> vertexBufferMemoryRefs;
 std::vector<VkBuffer> indexBuffers;
 std::vector<JEAllocation_VK> indexBufferMemoryRefs;
+// Lives here instead of only in Renderable so a VBO reserved for an async load can be filled in later.
+// Anything with 0 indices (not loaded yet, or failed) just gets skipped by renderFrame.
+std::vector<uint32_t> vboIndexCounts;
+std::vector<VkIndexType> vboIndexTypes;
+std::vector<JECookedVertexFormat> vboVertexFormats;
+// Identity unless the VBO is compact, then it goes in front of the model matrix.
+std::vector<glm::mat4> vboDequantizeMatrices;
 
 VkDescriptorSetLayout uniformDescriptorSetLayout;
 VkDescriptorSetLayout textureDescriptorSetLayout;
@@ -91,6 +158,14 @@ std::vector<VkSampler> textureSamplers;
 
 std::vector<JEDescriptorSet_VK> descriptorSets;
 
+// textureCompressionBC, checked and enabled in createLogicalDevice.
+bool blockCompressionSupported = false;
+
+// Finished async decodes waiting for the main thread to put them on the GPU. See flushUploads.
+std::vector<JETextureUpload_VK> queuedTextureUploads;
+std::vector<JEMeshUpload_VK> queuedMeshUploads;
+std::mutex uploadQueueMutex;
+
 VkDescriptorPool imGuiDescriptorPool;
 
 VkSampleCountFlagBits msaaSamples = VK_SAMPLE_COUNT_1_BIT;
@@ -658,8 +733,14 @@ void createLogicalDevice() {
         queueCreateInfos.push_back(queueCreateInfo);
     }
 
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+
     VkPhysicalDeviceFeatures deviceFeatures{};
     deviceFeatures.samplerAnisotropy = VK_TRUE;
+    // Optional, anything block compressed gets decompressed on the CPU if this isn't there.
+    deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+    blockCompressionSupported = supportedFeatures.textureCompressionBC == VK_TRUE;
 
     VkDeviceCreateInfo deviceCreateInfo{};
     deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -1160,9 +1241,7 @@ bool hasStencilComponent(VkFormat format) {
 }
 
 
-void transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, unsigned int arrayLayers, unsigned int mipLevels) {
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-
+void recordImageLayoutTransition(VkCommandBuffer commandBuffer, VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, unsigned int arrayLayers, unsigned int mipLevels) {
     VkImageMemoryBarrier barrier{};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     barrier.oldLayout = oldLayout;
@@ -1219,7 +1298,11 @@ void transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayo
             0, nullptr,
             1, &barrier
     );
+}
 
+void transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, unsigned int arrayLayers, unsigned int mipLevels) {
+    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+    recordImageLayoutTransition(commandBuffer, image, format, oldLayout, newLayout, arrayLayers, mipLevels);
     endSingleTimeCommands(commandBuffer);
 }
 
@@ -1288,6 +1371,65 @@ void createTextureSampler(unsigned int id, unsigned int mipLevels, unsigned int
     }
 }
 
+void createPipelineCache() {
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+    std::vector<char> cacheData;
+    std::ifstream file(PIPELINE_CACHE_FILE, std::ios::ate | std::ios::binary);
+    if (file.is_open()) {
+        cacheData.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(cacheData.data(), static_cast<std::streamsize>(cacheData.size()));
+        file.close();
+    }
+
+    // Drivers are supposed to reject mismatched data themselves, but some of them crash instead.
+    // Check the header ourselves and just start from an empty cache if it's from another device/driver.
+    if (cacheData.size() >= sizeof(VkPipelineCacheHeaderVersionOne)) {
+        VkPipelineCacheHeaderVersionOne header{};
+        memcpy(&header, cacheData.data(), sizeof(VkPipelineCacheHeaderVersionOne));
+        if (header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+            header.vendorID != properties.vendorID ||
+            header.deviceID != properties.deviceID ||
+            memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+            std::cout << "Vulkan: Pipeline cache is from a different device or driver, ignoring it." << std::endl;
+            cacheData.clear();
+        }
+    } else {
+        cacheData.clear();
+    }
+
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = cacheData.size();
+    cacheInfo.pInitialData = cacheData.empty() ? nullptr : cacheData.data();
+
+    if (vkCreatePipelineCache(logicalDevice, &cacheInfo, nullptr, &pipelineCache) != VK_SUCCESS) {
+        // Not fatal, pipelines just won't be cached.
+        std::cerr << "Vulkan: Failed to create pipeline cache!" << std::endl;
+        pipelineCache = VK_NULL_HANDLE;
+    }
+}
+
+void savePipelineCache() {
+    if (pipelineCache == VK_NULL_HANDLE) return;
+
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(logicalDevice, pipelineCache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0) return;
+
+    std::vector<char> cacheData(dataSize);
+    if (vkGetPipelineCacheData(logicalDevice, pipelineCache, &dataSize, cacheData.data()) != VK_SUCCESS) return;
+
+    std::ofstream file(PIPELINE_CACHE_FILE, std::ios::binary | std::ios::trunc);
+    if (!file.good()) {
+        std::cerr << "Vulkan: Couldn't write pipeline cache to " << PIPELINE_CACHE_FILE << "!" << std::endl;
+        return;
+    }
+    file.write(cacheData.data(), static_cast<std::streamsize>(dataSize));
+    file.close();
+}
+
 // stupid fking minuscule premature optimization bullshit
 // there is no *actual* performance difference but im hopeless
 // stuff that should hardly tax the engine (2.2m triangles at 720p) absolutely murders EVERYTHING
@@ -1303,11 +1445,16 @@ void initGFX(GLFWwindow **window, const char* windowName, int width, int height,
     windowPtr = window;
     settings = graphicsSettings;
 
+    // GLSLtoSPV initializes and finalizes glslang every call. Holding a reference for the whole run means
+    // those calls never actually tear it down, which is what makes compiling on multiple threads safe.
+    glslang::InitializeProcess();
+
     initGLFW(windowName, width, height);
     createInstance(windowName);
     createSurface();
     choosePhysicalDevice();
     createLogicalDevice();
+    createPipelineCache();
     createSwapchain();
     createImageViews();
     createRenderPass();
@@ -1341,7 +1488,7 @@ void initGFX(GLFWwindow **window, const char* windowName, int width, int height,
     init_info.Device = logicalDevice;
     init_info.QueueFamily = indices.graphicsFamily.value();
     init_info.Queue = graphicsQueue;
-    init_info.PipelineCache = VK_NULL_HANDLE;
+    init_info.PipelineCache = pipelineCache;
     init_info.DescriptorPool = imGuiDescriptorPool;
     init_info.RenderPass = renderPass;
     init_info.Subpass = 0;
@@ -1487,17 +1634,16 @@ unsigned int loadCubemap(std::vector<std::string> faces) {
     return descriptorID;
 }
 
-void generateMipmaps(VkImage image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels) {
-    // Check if image format supports linear blitting
+void checkLinearBlitSupport(VkFormat imageFormat) {
     VkFormatProperties formatProperties;
     vkGetPhysicalDeviceFormatProperties(physicalDevice, imageFormat, &formatProperties);
 
     if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)) {
         throw std::runtime_error("Vulkan: Texture image format does not support linear blit!");
     }
+}
 
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-
+void recordMipmaps(VkCommandBuffer commandBuffer, VkImage image, int32_t texWidth, int32_t texHeight, uint32_t mipLevels) {
     VkImageMemoryBarrier barrier{};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     barrier.image = image;
@@ -1570,7 +1716,13 @@ void generateMipmaps(VkImage image, VkFormat imageFormat, int32_t texWidth, int3
                          0, nullptr,
                          0, nullptr,
                          1, &barrier);
+}
+
+void generateMipmaps(VkImage image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels) {
+    checkLinearBlitSupport(imageFormat);
 
+    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+    recordMipmaps(commandBuffer, image, texWidth, texHeight, mipLevels);
     endSingleTimeCommands(commandBuffer);
 }
 
@@ -1634,16 +1786,351 @@ unsigned int loadTexture(const std::string& fileName, const int& samplerFilter)
     return loadSTBI2DTexture(pixels, texWidth, texHeight, texChannels, samplerFilter);
 }
 
-unsigned int loadBundledTexture(char* fileFirstBytePtr, size_t fileLength, const int& samplerFilter) {
+unsigned int loadBundledTexture(const unsigned char* fileFirstBytePtr, size_t fileLength, const int& samplerFilter) {
     stbi_set_flip_vertically_on_load(true);
     int texWidth, texHeight, texChannels;
-    stbi_uc* pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc *>(fileFirstBytePtr), fileLength, &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+    stbi_uc* pixels = stbi_load_from_memory(fileFirstBytePtr, static_cast<int>(fileLength), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
     if (!pixels) {
         throw std::runtime_error("Vulkan: Failed to load image from bundle!");
     }
     return loadSTBI2DTexture(pixels, texWidth, texHeight, texChannels, samplerFilter);
 }
 
+// Offsets into the shared staging buffer. Rounded up so every copy source stays nicely aligned.
+VkDeviceSize stagingAlign(VkDeviceSize offset) {
+    return (offset + 15) & ~static_cast<VkDeviceSize>(15);
+}
+
+VkFormat blockFormatToVk(JEBlockFormat format) {
+    switch (format) {
+        case JE_BLOCK_BC1: return VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+        case JE_BLOCK_BC3: return VK_FORMAT_BC3_SRGB_BLOCK;
+        case JE_BLOCK_BC5: return VK_FORMAT_BC5_UNORM_BLOCK; // No sRGB version of this one, spec/emissive gets cooked linear
+        case JE_BLOCK_BC7: return VK_FORMAT_BC7_SRGB_BLOCK;
+    }
+    throw std::runtime_error("Vulkan: Unknown block compression format!");
+}
+
+struct JEMipLevel_VK {
+    const unsigned char* data;
+    size_t size;
+};
+
+// Uploads levels that are already in their final format. One staging buffer, one copy command, no blits.
+unsigned int uploadMipLevels(VkFormat imageFormat, int texWidth, int texHeight, const std::vector<JEMipLevel_VK>& levels, const int& samplerFilter) {
+    if (levels.empty()) {
+        throw std::runtime_error("Vulkan: Texture has no mip levels!");
+    }
+
+    unsigned int internalID = textureImages.size();
+    unsigned int descriptorID = descriptorSets.size();
+
+    textureImages.push_back({});
+    textureMemoryRefs.push_back({});
+    textureImageViews.push_back({});
+    textureSamplers.push_back({});
+    descriptorSets.emplace_back();
+    textureDescriptorPools.push_back({});
+    textureMipLevels.push_back(levels.size());
+
+    std::vector<VkDeviceSize> offsets;
+    VkDeviceSize stagingSize = 0;
+    for (const auto& level : levels) {
+        offsets.push_back(stagingSize);
+        stagingSize = stagingAlign(stagingSize + level.size);
+    }
+
+    VkBuffer stagingBuffer;
+    VkDeviceMemory stagingBufferMemory;
+    createBuffer(stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+
+    void* data;
+    vkMapMemory(logicalDevice, stagingBufferMemory, 0, stagingSize, 0, &data);
+    for (size_t i = 0; i < levels.size(); i++) {
+        memcpy(static_cast<unsigned char*>(data) + offsets[i], levels[i].data, levels[i].size);
+    }
+    vkUnmapMemory(logicalDevice, stagingBufferMemory);
+
+    createImage(texWidth, texHeight, VK_IMAGE_TYPE_2D, imageFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImages[internalID], textureMemoryRefs[internalID], textureMipLevels[internalID], VK_SAMPLE_COUNT_1_BIT);
+
+    std::vector<VkBufferImageCopy> regions(levels.size());
+    for (size_t i = 0; i < levels.size(); i++) {
+        regions[i].bufferOffset = offsets[i];
+        regions[i].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        regions[i].imageSubresource.mipLevel = i;
+        regions[i].imageSubresource.baseArrayLayer = 0;
+        regions[i].imageSubresource.layerCount = 1;
+        regions[i].imageOffset = {0, 0, 0};
+        regions[i].imageExtent = {static_cast<uint32_t>(std::max(texWidth >> i, 1)), static_cast<uint32_t>(std::max(texHeight >> i, 1)), 1};
+    }
+
+    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+    recordImageLayoutTransition(commandBuffer, textureImages[internalID], imageFormat, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, textureMipLevels[internalID]);
+    vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, textureImages[internalID], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions.size(), regions.data());
+    recordImageLayoutTransition(commandBuffer, textureImages[internalID], imageFormat, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 1, textureMipLevels[internalID]);
+    endSingleTimeCommands(commandBuffer);
+
+    vkDestroyBuffer(logicalDevice, stagingBuffer, nullptr);
+    vkFreeMemory(logicalDevice, stagingBufferMemory, nullptr);
+
+    textureImageViews[internalID] = createImageView(textureImages[internalID], imageFormat, VK_IMAGE_ASPECT_COLOR_BIT, textureMipLevels[internalID]);
+
+    createTextureSampler(internalID, textureMipLevels[internalID], samplerFilter);
+
+    createTextureDescriptorPool(&textureDescriptorPools[internalID], static_cast<VkDescriptorPoolCreateFlagBits>(0));
+
+    createTextureDescriptorSet(internalID, &textureImageViews[internalID], descriptorID);
+
+    return descriptorID;
+}
+
+unsigned int loadBlockCompressedTexture(JEBlockFormat format, int texWidth, int texHeight, const std::vector<std::vector<unsigned char>>& mips, const int& samplerFilter) {
+    VkFormat imageFormat;
+    std::vector<std::vector<unsigned char>> decompressed;
+    const std::vector<std::vector<unsigned char>>* source = &mips;
+    if (blockCompressionSupported) {
+        imageFormat = blockFormatToVk(format);
+    } else {
+        // Fallback for GPUs without BC, same mips just 4-8x bigger.
+        imageFormat = format == JE_BLOCK_BC5 ? VK_FORMAT_R8G8B8A8_UNORM : VK_FORMAT_R8G8B8A8_SRGB;
+        for (size_t i = 0; i < mips.size(); i++) {
+            decompressed.push_back(bcDecode(format, mips[i].data(), std::max(texWidth >> i, 1), std::max(texHeight >> i, 1)));
+        }
+        source = &decompressed;
+    }
+
+    std::vector<JEMipLevel_VK> levels;
+    for (const auto& level : *source) levels.push_back({level.data(), level.size()});
+    return uploadMipLevels(imageFormat, texWidth, texHeight, levels, samplerFilter);
+}
+
+VkFormat cookedFormatToVk(JECookedFormat format) {
+    switch (format) {
+        case JE_COOKED_RGBA8_SRGB: return VK_FORMAT_R8G8B8A8_SRGB;
+        case JE_COOKED_RGBA8_UNORM: return VK_FORMAT_R8G8B8A8_UNORM;
+        case JE_COOKED_BC1: return blockFormatToVk(JE_BLOCK_BC1);
+        case JE_COOKED_BC3: return blockFormatToVk(JE_BLOCK_BC3);
+        case JE_COOKED_BC5: return blockFormatToVk(JE_BLOCK_BC5);
+        case JE_COOKED_BC7: return blockFormatToVk(JE_BLOCK_BC7);
+    }
+    throw std::runtime_error("Vulkan: Unknown cooked texture format!");
+}
+
+unsigned int loadCookedTexture(const unsigned char* bytes, size_t length, const int& samplerFilter) {
+    JECookedTexture texture = parseCookedTexture(bytes, length);
+    if (texture.format >= JE_COOKED_BC1 && !blockCompressionSupported) {
+        std::vector<unsigned char> decompressed = decompressCookedTexture(bytes, length);
+        return loadCookedTexture(decompressed.data(), decompressed.size(), samplerFilter);
+    }
+
+    // Straight out of the file into staging, the mips were all made when it was cooked.
+    std::vector<JEMipLevel_VK> levels;
+    for (const auto& mip : texture.mips) levels.push_back({bytes + mip.offset, mip.size});
+    return uploadMipLevels(cookedFormatToVk(texture.format), static_cast<int>(texture.width), static_cast<int>(texture.height), levels, samplerFilter);
+}
+
+bool isBlockCompressionSupported() {
+    return blockCompressionSupported;
+}
+
+unsigned int reserveTexture(unsigned int placeholderID) {
+    unsigned int descriptorID = descriptorSets.size();
+    // Borrow the placeholder's set until the real one is uploaded. It isn't ours, so nothing to free later.
+    descriptorSets.push_back(descriptorSets[placeholderID]);
+    return descriptorID;
+}
+
+unsigned int reserveVBO() {
+    unsigned int id = vertexBuffers.size();
+    // Null handles are fine here, vkDestroyBuffer ignores them and renderFrame skips anything with no indices.
+    vertexBuffers.push_back(VK_NULL_HANDLE);
+    vertexBufferMemoryRefs.push_back({});
+    indexBuffers.push_back(VK_NULL_HANDLE);
+    indexBufferMemoryRefs.push_back({});
+    vboIndexCounts.push_back(0);
+    vboIndexTypes.push_back(VK_INDEX_TYPE_UINT32);
+    vboVertexFormats.push_back(JE_VERTEX_FLOAT32);
+    vboDequantizeMatrices.push_back(glm::mat4(1.0f));
+    return id;
+}
+
+void queueTextureUpload(JETextureUpload_VK upload) {
+    std::lock_guard<std::mutex> lock(uploadQueueMutex);
+    queuedTextureUploads.push_back(std::move(upload));
+}
+
+void queueMeshUpload(JEMeshUpload_VK upload) {
+    std::lock_guard<std::mutex> lock(uploadQueueMutex);
+    queuedMeshUploads.push_back(std::move(upload));
+}
+
+void flushUploads() {
+    std::vector<JETextureUpload_VK> textureUploads;
+    std::vector<JEMeshUpload_VK> meshUploads;
+    {
+        std::lock_guard<std::mutex> lock(uploadQueueMutex);
+        textureUploads.swap(queuedTextureUploads);
+        meshUploads.swap(queuedMeshUploads);
+    }
+    // Parsed meshes get looked at the same way as cooked ones from here on.
+    // (Workers may have already narrowed a parsed mesh's indices into storage.)
+    for (auto& m : meshUploads) {
+        if (m.cookedVertices.empty()) m.cookedVertices = std::as_bytes(std::span(m.vertices));
+        if (m.cookedIndices.empty()) m.cookedIndices = std::as_bytes(std::span(m.indices));
+    }
+    // Empty meshes (failed parse) have nothing to upload and keep drawing as nothing.
+    std::erase_if(meshUploads, [](const JEMeshUpload_VK& m) { return m.cookedVertices.empty() || m.cookedIndices.empty(); });
+    if (textureUploads.empty() && meshUploads.empty()) return;
+
+    // Cooked textures come with their mips, everything else gets them blitted here.
+    // Workers already validated the cooked ones and decompressed them if the GPU can't do BC.
+    std::vector<JECookedTexture> cookedTextures(textureUploads.size());
+    std::vector<VkFormat> textureFormats(textureUploads.size(), VK_FORMAT_R8G8B8A8_SRGB);
+    for (size_t i = 0; i < textureUploads.size(); i++) {
+        if (textureUploads[i].cooked.empty()) {
+            checkLinearBlitSupport(VK_FORMAT_R8G8B8A8_SRGB);
+            continue;
+        }
+        cookedTextures[i] = parseCookedTexture(reinterpret_cast<const unsigned char*>(textureUploads[i].cooked.data()), textureUploads[i].cooked.size());
+        textureFormats[i] = cookedFormatToVk(cookedTextures[i].format);
+        textureUploads[i].width = static_cast<int>(cookedTextures[i].width);
+        textureUploads[i].height = static_cast<int>(cookedTextures[i].height);
+    }
+
+    // Everything this frame goes through one staging buffer and one submit instead of one (or three) per asset.
+    VkDeviceSize stagingSize = 0;
+    std::vector<VkDeviceSize> textureOffsets;
+    std::vector<VkDeviceSize> meshOffsets;
+    for (size_t i = 0; i < textureUploads.size(); i++) {
+        textureOffsets.push_back(stagingSize);
+        if (textureUploads[i].cooked.empty()) {
+            stagingSize = stagingAlign(stagingSize + static_cast<VkDeviceSize>(textureUploads[i].width) * textureUploads[i].height * 4);
+        } else {
+            // All the levels in a row, same alignment as the file so one offset covers them all.
+            const JECookedMip& lastMip = cookedTextures[i].mips.back();
+            stagingSize = stagingAlign(stagingSize + (lastMip.offset + lastMip.size - cookedTextures[i].mips[0].offset));
+        }
+    }
+    for (const auto& m : meshUploads) {
+        meshOffsets.push_back(stagingSize);
+        stagingSize = stagingAlign(stagingSize + m.cookedVertices.size());
+        stagingSize = stagingAlign(stagingSize + m.cookedIndices.size());
+    }
+
+    VkBuffer stagingBuffer;
+    VkDeviceMemory stagingBufferMemory;
+    createBuffer(stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+
+    void* data;
+    vkMapMemory(logicalDevice, stagingBufferMemory, 0, stagingSize, 0, &data);
+    auto* staging = static_cast<unsigned char*>(data);
+    for (size_t i = 0; i < textureUploads.size(); i++) {
+        if (textureUploads[i].cooked.empty()) {
+            memcpy(staging + textureOffsets[i], textureUploads[i].pixels, static_cast<size_t>(textureUploads[i].width) * textureUploads[i].height * 4);
+            stbi_image_free(textureUploads[i].pixels);
+        } else {
+            const JECookedMip& lastMip = cookedTextures[i].mips.back();
+            memcpy(staging + textureOffsets[i], textureUploads[i].cooked.data() + cookedTextures[i].mips[0].offset, lastMip.offset + lastMip.size - cookedTextures[i].mips[0].offset);
+        }
+    }
+    for (size_t i = 0; i < meshUploads.size(); i++) {
+        size_t vertexBytes = meshUploads[i].cookedVertices.size();
+        memcpy(staging + meshOffsets[i], meshUploads[i].cookedVertices.data(), vertexBytes);
+        memcpy(staging + stagingAlign(meshOffsets[i] + vertexBytes), meshUploads[i].cookedIndices.data(), meshUploads[i].cookedIndices.size());
+    }
+    vkUnmapMemory(logicalDevice, stagingBufferMemory);
+
+    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+
+    std::vector<unsigned int> internalIDs;
+    for (size_t i = 0; i < textureUploads.size(); i++) {
+        const JETextureUpload_VK& t = textureUploads[i];
+        unsigned int internalID = textureImages.size();
+        internalIDs.push_back(internalID);
+
+        textureImages.push_back({});
+        textureMemoryRefs.push_back({});
+        textureImageViews.push_back({});
+        textureSamplers.push_back({});
+        textureDescriptorPools.push_back({});
+        if (t.cooked.empty()) {
+            textureMipLevels.push_back(static_cast<uint32_t>(std::floor(std::log2(std::max(t.width, t.height)))) + 1);
+        } else {
+            textureMipLevels.push_back(cookedTextures[i].mips.size());
+        }
+
+        createImage(t.width, t.height, VK_IMAGE_TYPE_2D, textureFormats[i], VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImages[internalID], textureMemoryRefs[internalID], textureMipLevels[internalID], VK_SAMPLE_COUNT_1_BIT);
+
+        recordImageLayoutTransition(commandBuffer, textureImages[internalID], textureFormats[i], VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, textureMipLevels[internalID]);
+
+        if (!t.cooked.empty()) {
+            std::vector<VkBufferImageCopy> regions(cookedTextures[i].mips.size());
+            for (size_t level = 0; level < regions.size(); level++) {
+                regions[level].bufferOffset = textureOffsets[i] + (cookedTextures[i].mips[level].offset - cookedTextures[i].mips[0].offset);
+                regions[level].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                regions[level].imageSubresource.mipLevel = level;
+                regions[level].imageSubresource.baseArrayLayer = 0;
+                regions[level].imageSubresource.layerCount = 1;
+                regions[level].imageOffset = {0, 0, 0};
+                regions[level].imageExtent = {static_cast<uint32_t>(std::max(t.width >> level, 1)), static_cast<uint32_t>(std::max(t.height >> level, 1)), 1};
+            }
+            vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, textureImages[internalID], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions.size(), regions.data());
+            recordImageLayoutTransition(commandBuffer, textureImages[internalID], textureFormats[i], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 1, textureMipLevels[internalID]);
+            continue;
+        }
+
+        VkBufferImageCopy region{};
+        region.bufferOffset = textureOffsets[i];
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = {0, 0, 0};
+        region.imageExtent = {static_cast<uint32_t>(t.width), static_cast<uint32_t>(t.height), 1};
+        vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, textureImages[internalID], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+        recordMipmaps(commandBuffer, textureImages[internalID], t.width, t.height, textureMipLevels[internalID]);
+    }
+
+    for (size_t i = 0; i < meshUploads.size(); i++) {
+        const JEMeshUpload_VK& m = meshUploads[i];
+        VkDeviceSize vertexBytes = m.cookedVertices.size();
+        VkDeviceSize indexBytes = m.cookedIndices.size();
+
+        createBuffer(vertexBytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vertexBuffers[m.vboID], vertexBufferMemoryRefs[m.vboID], false);
+        createBuffer(indexBytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, indexBuffers[m.vboID], indexBufferMemoryRefs[m.vboID], false);
+
+        VkBufferCopy copyRegion{};
+        copyRegion.srcOffset = meshOffsets[i];
+        copyRegion.size = vertexBytes;
+        vkCmdCopyBuffer(commandBuffer, stagingBuffer, vertexBuffers[m.vboID], 1, &copyRegion);
+        copyRegion.srcOffset = stagingAlign(meshOffsets[i] + vertexBytes);
+        copyRegion.size = indexBytes;
+        vkCmdCopyBuffer(commandBuffer, stagingBuffer, indexBuffers[m.vboID], 1, &copyRegion);
+    }
+
+    endSingleTimeCommands(commandBuffer);
+
+    vkDestroyBuffer(logicalDevice, stagingBuffer, nullptr);
+    vkFreeMemory(logicalDevice, stagingBufferMemory, nullptr);
+
+    for (size_t i = 0; i < textureUploads.size(); i++) {
+        unsigned int internalID = internalIDs[i];
+        textureImageViews[internalID] = createImageView(textureImages[internalID], textureFormats[i], VK_IMAGE_ASPECT_COLOR_BIT, textureMipLevels[internalID]);
+        createTextureSampler(internalID, textureMipLevels[internalID], textureUploads[i].samplerFilter);
+        createTextureDescriptorPool(&textureDescriptorPools[internalID], static_cast<VkDescriptorPoolCreateFlagBits>(0));
+        // Swaps the placeholder out. Frames already in flight recorded the old handle, which stays valid.
+        createTextureDescriptorSet(internalID, &textureImageViews[internalID], textureUploads[i].descriptorID);
+    }
+
+    for (const auto& m : meshUploads) {
+        vboIndexCounts[m.vboID] = m.cookedIndices.size() / m.indexSize;
+        vboIndexTypes[m.vboID] = m.indexSize == 2 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+        vboVertexFormats[m.vboID] = m.vertexFormat;
+        vboDequantizeMatrices[m.vboID] = m.dequantize;
+    }
+}
+
 static std::vector<char> readFile(const std::string& filename) {
     std::ifstream file(filename, std::ios::ate | std::ios::binary);
 
@@ -1666,10 +2153,7 @@ inline bool ends_with(std::string const& value, std::string const & ending)
     return std::equal(ending.rbegin(), ending.rend(), value.rbegin());
 }
 
-unsigned int loadShader(const std::string& file_path, int target) {
-    unsigned int id = shaderModuleVector.size();
-    shaderModuleVector.push_back({});
-
+unsigned int compileShaderModule(const std::string& file_path, int target) {
     VkShaderModuleCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
 
@@ -1684,6 +2168,8 @@ unsigned int loadShader(const std::string& file_path, int target) {
     // For the sake of "hope it works" because I don't want to go actually manually compile SPIR-V,
     // I'm leaving this outside of the if statement too.
     std::vector<char> code;
+    // Vertex shaders with an #ifdef JE_COMPACT_VERTICES path keep a copy with it defined, for getCompactPipeline.
+    std::string compactSource;
 
     if (ends_with(file_path, ".spv")) {
         std::cout << "Loading " << file_path << " (compiled SPIR-V bytecode)..." << std::endl;
@@ -1705,23 +2191,97 @@ unsigned int loadShader(const std::string& file_path, int target) {
         }
         createInfo.codeSize = spirv_comp.size() * sizeof(uint32_t);
         createInfo.pCode = reinterpret_cast<const uint32_t*>(spirv_comp.data());
+
+        size_t versionLine = fileContents.find("#version");
+        if (target == JE_VERTEX_SHADER && versionLine != std::string::npos && fileContents.find("JE_COMPACT_VERTICES") != std::string::npos) {
+            // Has to go after #version, nothing is allowed before that.
+            compactSource = fileContents;
+            size_t lineEnd = compactSource.find('\n', versionLine);
+            compactSource.insert(lineEnd == std::string::npos ? compactSource.size() : lineEnd + 1, "\n#define JE_COMPACT_VERTICES\n");
+        }
     }
 
-    if (vkCreateShaderModule(logicalDevice, &createInfo, nullptr, &shaderModuleVector[id]) != VK_SUCCESS) {
+    VkShaderModule shaderModule;
+    if (vkCreateShaderModule(logicalDevice, &createInfo, nullptr, &shaderModule) != VK_SUCCESS) {
         throw std::runtime_error("Vulkan: Failed to create shader module for " + file_path + "!");
     }
 
+    std::lock_guard<std::mutex> lock(pipelineMutex);
+    unsigned int id = shaderModuleVector.size();
+    shaderModuleVector.push_back(shaderModule);
+    compactShaderModules.push_back(-1);
+    compactShaderSources.push_back(std::move(compactSource));
     return id;
 }
 
-unsigned int createProgram(unsigned int VertexShaderID, unsigned int FragmentShaderID, const JEShaderProgramSettings& shaderProgramSettings) {
-    unsigned int pipelineID = pipelineLayoutVector.size();
-    pipelineLayoutVector.push_back({});
-    pipelineVector.push_back({});
+unsigned int loadShader(const std::string& file_path, int target) {
+    std::string cacheKey = std::to_string(target) + ":" + file_path;
+    std::promise<unsigned int> modulePromise;
+    std::shared_future<unsigned int> existing;
+    {
+        std::lock_guard<std::mutex> lock(pipelineMutex);
+        if (shaderModuleCache.contains(cacheKey)) {
+            existing = shaderModuleCache.at(cacheKey);
+        } else {
+            shaderModuleCache.insert({cacheKey, modulePromise.get_future().share()});
+        }
+    }
+    // Already compiled or being compiled by someone else, wait outside the lock.
+    if (existing.valid()) return existing.get();
+
+    try {
+        unsigned int id = compileShaderModule(file_path, target);
+        modulePromise.set_value(id);
+        return id;
+    } catch (...) {
+        // Whoever is waiting on this module gets the same error.
+        modulePromise.set_exception(std::current_exception());
+        throw;
+    }
+}
+
+// Caller must hold pipelineMutex.
+VkPipelineLayout getPipelineLayout(const JEShaderProgramSettings& shaderProgramSettings) {
+    uint64_t inputMask = shaderProgramSettings.shaderInputCount >= 32 ? 0xFFFFFFFF : ((1ull << shaderProgramSettings.shaderInputCount) - 1);
+    uint64_t layoutKey = (static_cast<uint64_t>(shaderProgramSettings.shaderInputCount) << 32) | (shaderProgramSettings.shaderInputs & inputMask);
+    if (pipelineLayoutCache.contains(layoutKey)) {
+        return pipelineLayoutCache.at(layoutKey);
+    }
+
+    VkPushConstantRange push_constant;
+    push_constant.offset = 0;
+    push_constant.size = sizeof(JEPushConstants_VK);
+    push_constant.stageFlags = VK_SHADER_STAGE_ALL_GRAPHICS;
 
-    VkShaderModule vertex = shaderModuleVector[VertexShaderID];
-    VkShaderModule fragment = shaderModuleVector[FragmentShaderID];
+    std::vector<VkDescriptorSetLayout> dsls = {};
+    for (int i = 0; i < shaderProgramSettings.shaderInputCount; i++) {
+        //  select single bit from shader inputs
+        if (((shaderProgramSettings.shaderInputs >> i) & 0b1) == 1) {
+            // texture
+            dsls.push_back(textureDescriptorSetLayout);
+        } else {
+            // uniform
+            dsls.push_back(uniformDescriptorSetLayout);
+        }
+    }
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = dsls.size();
+    pipelineLayoutInfo.pSetLayouts = dsls.data();
+    pipelineLayoutInfo.pPushConstantRanges = &push_constant;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+
+    VkPipelineLayout layout;
+    if (vkCreatePipelineLayout(logicalDevice, &pipelineLayoutInfo, nullptr, &layout) != VK_SUCCESS) {
+        throw std::runtime_error("Vulkan: Failed to create pipeline layout!");
+    }
+
+    pipelineLayoutCache.insert({layoutKey, layout});
+    return layout;
+}
 
+// Everything about making a pipeline but the bookkeeping. compact takes JE_VERTEX_COMPACT16 vertices instead of floats.
+VkPipeline buildPipeline(VkShaderModule vertex, VkShaderModule fragment, VkPipelineLayout pipelineLayout, const JEShaderProgramSettings& settings, bool compact) {
     VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
     vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
@@ -1749,8 +2309,8 @@ unsigned int createProgram(unsigned int VertexShaderID, unsigned int FragmentSha
     VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
 
-    auto bindingDescription = JEInterleavedVertex_VK::getBindingDescription();
-    auto attributeDescriptions = JEInterleavedVertex_VK::getAttributeDescriptions();
+    auto bindingDescription = compact ? JECompactVertex_VK::getBindingDescription() : JEInterleavedVertex_VK::getBindingDescription();
+    auto attributeDescriptions = compact ? JECompactVertex_VK::getAttributeDescriptions() : JEInterleavedVertex_VK::getAttributeDescriptions();
 
     vertexInputInfo.vertexBindingDescriptionCount = 1;
     vertexInputInfo.vertexAttributeDescriptionCount = attributeDescriptions.size();
@@ -1787,7 +2347,7 @@ unsigned int createProgram(unsigned int VertexShaderID, unsigned int FragmentSha
     rasterizer.rasterizerDiscardEnable = VK_FALSE;
     rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
     rasterizer.lineWidth = 1.0f;
-    rasterizer.cullMode = shaderProgramSettings.doubleSided ? VK_CULL_MODE_NONE : VK_CULL_MODE_BACK_BIT;
+    rasterizer.cullMode = settings.doubleSided ? VK_CULL_MODE_NONE : VK_CULL_MODE_BACK_BIT;
     rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
 
     rasterizer.depthBiasEnable = VK_FALSE;
@@ -1799,7 +2359,7 @@ unsigned int createProgram(unsigned int VertexShaderID, unsigned int FragmentSha
 
     VkPipelineColorBlendAttachmentState colorBlendAttachment{};
     colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    if (shaderProgramSettings.transparencySupported) {
+    if (settings.transparencySupported) {
         colorBlendAttachment.blendEnable = VK_TRUE;
         colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
         colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
@@ -1817,16 +2377,11 @@ unsigned int createProgram(unsigned int VertexShaderID, unsigned int FragmentSha
     colorBlending.attachmentCount = 1;
     colorBlending.pAttachments = &colorBlendAttachment;
 
-    VkPushConstantRange push_constant;
-    push_constant.offset = 0;
-    push_constant.size = sizeof(JEPushConstants_VK);
-    push_constant.stageFlags = VK_SHADER_STAGE_ALL_GRAPHICS;
-
     VkPipelineDepthStencilStateCreateInfo depthStencil{};
     depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-    depthStencil.depthTestEnable = shaderProgramSettings.testDepth;
-    depthStencil.depthWriteEnable = shaderProgramSettings.transparencySupported ? VK_FALSE : VK_TRUE;
-    depthStencil.depthCompareOp = shaderProgramSettings.depthAlwaysPass ? VK_COMPARE_OP_ALWAYS : VK_COMPARE_OP_LESS_OR_EQUAL;
+    depthStencil.depthTestEnable = settings.testDepth;
+    depthStencil.depthWriteEnable = settings.transparencySupported ? VK_FALSE : VK_TRUE;
+    depthStencil.depthCompareOp = settings.depthAlwaysPass ? VK_COMPARE_OP_ALWAYS : VK_COMPARE_OP_LESS_OR_EQUAL;
     depthStencil.depthBoundsTestEnable = VK_FALSE;
     depthStencil.minDepthBounds = 0.0f;
     depthStencil.maxDepthBounds = 1.0f;
@@ -1834,29 +2389,6 @@ unsigned int createProgram(unsigned int VertexShaderID, unsigned int FragmentSha
     depthStencil.front = {};
     depthStencil.back = {};
 
-
-    std::vector<VkDescriptorSetLayout> dsls = {};
-    for (int i = 0; i < shaderProgramSettings.shaderInputCount; i++) {
-        //  select single bit from shader inputs
-        if (((shaderProgramSettings.shaderInputs >> i) & 0b1) == 1) {
-            // texture
-            dsls.push_back(textureDescriptorSetLayout);
-        } else {
-            // uniform
-            dsls.push_back(uniformDescriptorSetLayout);
-        }
-    }
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = dsls.size();
-    pipelineLayoutInfo.pSetLayouts = dsls.data();
-    pipelineLayoutInfo.pPushConstantRanges = &push_constant;
-    pipelineLayoutInfo.pushConstantRangeCount = 1;
-
-    if (vkCreatePipelineLayout(logicalDevice, &pipelineLayoutInfo, nullptr, &pipelineLayoutVector[pipelineID]) != VK_SUCCESS) {
-        throw std::runtime_error("Vulkan: Failed to create pipeline layout!");
-    }
-
     VkGraphicsPipelineCreateInfo pipelineInfo{};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
     pipelineInfo.stageCount = 2;
@@ -1871,23 +2403,102 @@ unsigned int createProgram(unsigned int VertexShaderID, unsigned int FragmentSha
     pipelineInfo.pColorBlendState = &colorBlending;
     pipelineInfo.pDynamicState = &dynamicState;
 
-    pipelineInfo.layout = pipelineLayoutVector[pipelineID];
+    pipelineInfo.layout = pipelineLayout;
 
     pipelineInfo.renderPass = renderPass;
     pipelineInfo.subpass = 0;
 
-    if (vkCreateGraphicsPipelines(logicalDevice, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipelineVector[pipelineID]) != VK_SUCCESS) {
-        throw std::runtime_error("Vulkan: Failed to create graphics pipeline!");
+    VkPipeline pipeline;
+    if (vkCreateGraphicsPipelines(logicalDevice, pipelineCache, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS) {
+        throw std::runtime_error(compact ? "Vulkan: Failed to create compact vertex graphics pipeline!" : "Vulkan: Failed to create graphics pipeline!");
     }
+    return pipeline;
+}
+
+unsigned int createProgram(unsigned int VertexShaderID, unsigned int FragmentShaderID, const JEShaderProgramSettings& shaderProgramSettings) {
+    JEPipelineKey_VK key = {
+            VertexShaderID,
+            FragmentShaderID,
+            shaderProgramSettings.testDepth,
+            shaderProgramSettings.transparencySupported,
+            shaderProgramSettings.doubleSided,
+            shaderProgramSettings.depthAlwaysPass,
+            shaderProgramSettings.shaderInputs,
+            shaderProgramSettings.shaderInputCount
+    };
+    VkShaderModule vertex;
+    VkShaderModule fragment;
+    VkPipelineLayout pipelineLayout;
+    {
+        std::lock_guard<std::mutex> lock(pipelineMutex);
+        if (pipelineDedupMap.contains(key)) {
+            // Exact same shaders and state, no reason to make the driver build it again.
+            return pipelineDedupMap.at(key);
+        }
+        vertex = shaderModuleVector[VertexShaderID];
+        fragment = shaderModuleVector[FragmentShaderID];
+        pipelineLayout = getPipelineLayout(shaderProgramSettings);
+    }
+
+    VkPipeline pipeline = buildPipeline(vertex, fragment, pipelineLayout, shaderProgramSettings, false);
 
-    vkDestroyShaderModule(logicalDevice, fragment, nullptr);
-    vkDestroyShaderModule(logicalDevice, vertex, nullptr);
+    // Shader modules stay alive in shaderModuleCache for other programs to reuse, they get destroyed in deinitGFX.
+    // IDs are only handed out once the pipeline exists, so renderFrame never sees a half built one.
+    unsigned int pipelineID;
+    {
+        std::lock_guard<std::mutex> lock(pipelineMutex);
+        if (pipelineDedupMap.contains(key)) {
+            // Someone built the same thing on another thread while we were busy.
+            vkDestroyPipeline(logicalDevice, pipeline, nullptr);
+            return pipelineDedupMap.at(key);
+        }
+        pipelineID = pipelineVector.size();
+        pipelineVector.push_back(pipeline);
+        compactPipelineVector.push_back(VK_NULL_HANDLE);
+        pipelineKeyVector.push_back(key);
+        pipelineLayoutVector.push_back(pipelineLayout);
+        pipelineDedupMap.insert({key, pipelineID});
+    }
 
     std::cout << "Successfully created new pipeline." << std::endl;
 
     return pipelineID;
 }
 
+// Caller must hold pipelineMutex. Compiles the JE_COMPACT_VERTICES vertex shader and builds the pipeline the first time
+// a program draws a compact mesh, so programs that never do don't pay for either.
+// @return VK_NULL_HANDLE if the program's vertex shader has no JE_COMPACT_VERTICES path
+VkPipeline getCompactPipeline(unsigned int programID) {
+    if (compactPipelineVector[programID] != VK_NULL_HANDLE) return compactPipelineVector[programID];
+    const JEPipelineKey_VK& key = pipelineKeyVector[programID];
+    if (compactShaderSources[key.vertexModule].empty()) return VK_NULL_HANDLE;
+
+    if (compactShaderModules[key.vertexModule] == -1) {
+        std::vector<unsigned int> spirv;
+        if (!SpirvHelper::GLSLtoSPV(VK_SHADER_STAGE_VERTEX_BIT, &compactShaderSources[key.vertexModule][0], &spirv)) {
+            throw std::runtime_error("Vulkan: Could not compile a vertex shader to SPIR-V with JE_COMPACT_VERTICES!");
+        }
+        VkShaderModuleCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        createInfo.codeSize = spirv.size() * sizeof(uint32_t);
+        createInfo.pCode = spirv.data();
+        VkShaderModule compactModule;
+        if (vkCreateShaderModule(logicalDevice, &createInfo, nullptr, &compactModule) != VK_SUCCESS) {
+            throw std::runtime_error("Vulkan: Failed to create compact vertex shader module!");
+        }
+        compactShaderModules[key.vertexModule] = static_cast<int>(shaderModuleVector.size());
+        shaderModuleVector.push_back(compactModule);
+        compactShaderModules.push_back(-1);
+        compactShaderSources.emplace_back();
+    }
+
+    JEShaderProgramSettings settings{key.testDepth, key.transparencySupported, key.doubleSided, key.depthAlwaysPass, key.shaderInputs, key.shaderInputCount};
+    compactPipelineVector[programID] = buildPipeline(shaderModuleVector[compactShaderModules[key.vertexModule]], shaderModuleVector[key.fragmentModule],
+                                                     pipelineLayoutVector[programID], settings, true);
+    std::cout << "Successfully created compact vertex pipeline." << std::endl;
+    return compactPipelineVector[programID];
+}
+
 void cleanupSwapchain() {
     int width = 0, height = 0;
     glfwGetFramebufferSize(*windowPtr, &width, &height);
@@ -1929,14 +2540,13 @@ void recreateSwapchain() {
     createSwapchainFramebuffers();
 }
 
-unsigned int createVBO(std::vector<JEInterleavedVertex_VK> *interleavedVertices, std::vector<unsigned int> *indices) {
-    unsigned int id = vertexBuffers.size();
-    vertexBuffers.push_back({});
-    vertexBufferMemoryRefs.push_back({});
-    indexBuffers.push_back({});
-    indexBufferMemoryRefs.push_back({});
+static_assert(sizeof(JECompactVertex_VK) == sizeof(JECompactVertex), "Cooked compact vertices have to upload as is");
 
-    VkDeviceSize bufferSize = sizeof(JEInterleavedVertex_VK) * interleavedVertices->size();
+// Everything createVBO takes ends up here as raw bytes, already in the format the GPU will read.
+unsigned int createVBO(std::span<const std::byte> vertices, std::span<const std::byte> indices, uint32_t indexSize, JECookedVertexFormat vertexFormat, const glm::mat4& dequantize) {
+    unsigned int id = reserveVBO();
+
+    VkDeviceSize bufferSize = vertices.size();
     VkBuffer stagingBuffer;
     VkDeviceMemory stagingBufferMemory;
     createBuffer(bufferSize,
@@ -1947,7 +2557,7 @@ unsigned int createVBO(std::vector<JEInterleavedVertex_VK> *interleavedVertices,
 
     void* data;
     vkMapMemory(logicalDevice, stagingBufferMemory, 0, bufferSize, 0, &data);
-    memcpy(data, interleavedVertices->data(), (size_t) bufferSize);
+    memcpy(data, vertices.data(), (size_t) bufferSize);
     vkUnmapMemory(logicalDevice, stagingBufferMemory);
 
     createBuffer(bufferSize,
@@ -1963,7 +2573,7 @@ unsigned int createVBO(std::vector<JEInterleavedVertex_VK> *interleavedVertices,
     vkFreeMemory(logicalDevice, stagingBufferMemory, nullptr);
 
     // Index buffers
-    bufferSize = sizeof(unsigned int) * indices->size();
+    bufferSize = indices.size();
 
     createBuffer(bufferSize,
                  VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
@@ -1972,7 +2582,7 @@ unsigned int createVBO(std::vector<JEInterleavedVertex_VK> *interleavedVertices,
                  stagingBufferMemory);
 
     vkMapMemory(logicalDevice, stagingBufferMemory, 0, bufferSize, 0, &data);
-    memcpy(data, indices->data(), (size_t) bufferSize);
+    memcpy(data, indices.data(), (size_t) bufferSize);
     vkUnmapMemory(logicalDevice, stagingBufferMemory);
 
     createBuffer(bufferSize,
@@ -1987,9 +2597,39 @@ unsigned int createVBO(std::vector<JEInterleavedVertex_VK> *interleavedVertices,
     vkDestroyBuffer(logicalDevice, stagingBuffer, nullptr);
     vkFreeMemory(logicalDevice, stagingBufferMemory, nullptr);
 
+    vboIndexCounts[id] = indices.size() / indexSize;
+    vboIndexTypes[id] = indexSize == 2 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    vboVertexFormats[id] = vertexFormat;
+    vboDequantizeMatrices[id] = dequantize;
+
     return id;
 }
 
+unsigned int createVBO(std::vector<JEInterleavedVertex_VK> *interleavedVertices, std::vector<unsigned int> *indices) {
+    std::span<const std::byte> vertexBytes = std::as_bytes(std::span(*interleavedVertices));
+    if (interleavedVertices->size() <= JE_MAX_SHORT_INDEX_VERTICES) {
+        std::vector<uint16_t> shortIndices = shortenIndices(*indices);
+        return createVBO(vertexBytes, std::as_bytes(std::span(shortIndices)), sizeof(uint16_t), JE_VERTEX_FLOAT32, glm::mat4(1.0f));
+    }
+    return createVBO(vertexBytes, std::as_bytes(std::span(*indices)), sizeof(unsigned int), JE_VERTEX_FLOAT32, glm::mat4(1.0f));
+}
+
+unsigned int createVBO(const JECookedMesh& mesh) {
+    auto vertexFormat = static_cast<JECookedVertexFormat>(mesh.header.vertexFormat);
+    glm::mat4 dequantize = vertexFormat == JE_VERTEX_COMPACT16 ? getDequantizeMatrix(mesh.header) : glm::mat4(1.0f);
+    return createVBO(mesh.vertices, mesh.indices, mesh.header.indexSize, vertexFormat, dequantize);
+}
+
+glm::mat4 getDequantizeMatrix(const JECookedMeshHeader& header) {
+    // Scale 0-1 up to the size of the bounds, then move it to where they start.
+    glm::mat4 dequantize(1.0f);
+    for (int c = 0; c < 3; c++) {
+        dequantize[c][c] = header.boundsMax[c] - header.boundsMin[c];
+        dequantize[3][c] = header.boundsMin[c];
+    }
+    return dequantize;
+}
+
 void updateUniformBuffer(unsigned int id, void* ptr, size_t size, bool updateAll) {
     if (!updateAll) memcpy(uniformBuffersMapped[descriptorSets[id].idRef-1][currentFrame], ptr, size);
     else for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) { memcpy(uniformBuffersMapped[descriptorSets[id].idRef-1][i], ptr, size); }
@@ -2000,6 +2640,9 @@ VkDeviceSize offsets[] = {0};
 void renderFrame(const std::vector<Renderable*>& renderables, const std::vector<void (*)()>& imGuiCalls) {
     vkWaitForFences(logicalDevice, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
 
+    // Anything that finished loading on a job worker since last frame goes up now, all in one batch.
+    flushUploads();
+
     uint32_t imageIndex;
     VkResult result = vkAcquireNextImageKHR(logicalDevice, swapchain, UINT64_MAX, imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
 
@@ -2058,12 +2701,25 @@ void renderFrame(const std::vector<Renderable*>& renderables, const std::vector<
     vkCmdSetScissor(commandBuffers[currentFrame], 0, 1, &scissor);
 
     int activeProgram = -1;
+    bool activeCompact = false;
+    // Shader programs can still be getting created on job workers, don't let pipelineVector move under us.
+    std::unique_lock<std::mutex> pipelineLock(pipelineMutex);
 
     for (const auto& r : renderables) {
-        if (r->shaderProgram != activeProgram) {
+        if (vboIndexCounts[r->vboID] == 0) continue; // Still loading
+
+        bool compact = vboVertexFormats[r->vboID] == JE_VERTEX_COMPACT16;
+        if (r->shaderProgram != activeProgram || compact != activeCompact) {
             activeProgram = static_cast<int>(r->shaderProgram);
-            vkCmdBindPipeline(commandBuffers[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
-                              pipelineVector[activeProgram]);
+            activeCompact = compact;
+            VkPipeline pipeline = compact ? getCompactPipeline(activeProgram) : pipelineVector[activeProgram];
+            if (pipeline == VK_NULL_HANDLE) {
+                // Vertex shader can't read compact vertices, so it's skipped instead (jbdpack's --compact-vertices says
+                // which shaders can). Forget the program so the next one rebinds.
+                activeProgram = -1;
+                continue;
+            }
+            vkCmdBindPipeline(commandBuffers[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
         }
 
         std::vector<VkDescriptorSet> descriptor_sets = {};
@@ -2080,15 +2736,17 @@ void renderFrame(const std::vector<Renderable*>& renderables, const std::vector<
                                 descriptor_sets.data(), 0, nullptr);
 
         vkCmdBindVertexBuffers(commandBuffers[currentFrame], 0, 1, &vertexBuffers[r->vboID], offsets);
-        vkCmdBindIndexBuffer(commandBuffers[currentFrame], indexBuffers[r->vboID], 0, VK_INDEX_TYPE_UINT32);
+        vkCmdBindIndexBuffer(commandBuffers[currentFrame], indexBuffers[r->vboID], 0, vboIndexTypes[r->vboID]);
 
-        JEPushConstants_VK constants = {r->objectMatrix, r->normal};
+        JEPushConstants_VK constants = {compact ? r->objectMatrix * vboDequantizeMatrices[r->vboID] : r->objectMatrix, r->normal};
         vkCmdPushConstants(commandBuffers[currentFrame], pipelineLayoutVector[activeProgram],
                            VK_SHADER_STAGE_ALL_GRAPHICS, 0, sizeof(JEPushConstants_VK), &constants);
 
-        vkCmdDrawIndexed(commandBuffers[currentFrame], r->indicesSize, 1, 0, 0, 0);
+        vkCmdDrawIndexed(commandBuffers[currentFrame], vboIndexCounts[r->vboID], 1, 0, 0, 0);
     }
 
+    pipelineLock.unlock();
+
     ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), commandBuffers[currentFrame]);
 
     vkCmdEndRenderPass(commandBuffers[currentFrame]);
@@ -2192,16 +2850,28 @@ void deinitGFX() {
         vkDestroyPipeline(logicalDevice, graphicsPipelines, nullptr);
     }
 
-    for (auto graphicsPipelineLayout : pipelineLayoutVector) {
-        vkDestroyPipelineLayout(logicalDevice, graphicsPipelineLayout, nullptr);
+    for (auto graphicsPipelines : compactPipelineVector) {
+        vkDestroyPipeline(logicalDevice, graphicsPipelines, nullptr);
+    }
+
+    for (const auto& graphicsPipelineLayout : pipelineLayoutCache) {
+        vkDestroyPipelineLayout(logicalDevice, graphicsPipelineLayout.second, nullptr);
+    }
+
+    for (auto shaderModule : shaderModuleVector) {
+        vkDestroyShaderModule(logicalDevice, shaderModule, nullptr);
     }
 
+    savePipelineCache();
+    vkDestroyPipelineCache(logicalDevice, pipelineCache, nullptr);
+
     vkDestroyDescriptorSetLayout(logicalDevice, uniformDescriptorSetLayout, nullptr);
     vkDestroyDescriptorSetLayout(logicalDevice, textureDescriptorSetLayout, nullptr);
     vkDestroyRenderPass(logicalDevice, renderPass, nullptr);
     vkDestroyDevice(logicalDevice, nullptr);
     vkDestroySurfaceKHR(instance, windowSurface, nullptr);
     vkDestroyInstance(instance, nullptr);
+    glslang::FinalizeProcess();
     glfwDestroyWindow(*windowPtr);
     glfwTerminate();
 }
@@ -12,6 +12,9 @@
 #include "../renderable.h"
 #include <glm/glm.hpp>
 #include "../../engine.h"
+#include "../bcutil.h"
+#include "../meshutil.h"
+#include <span>
 
 // VK_SHADER_STAGE_VERTEX_BIT
 #define JE_VERTEX_SHADER 0x00000001
@@ -23,6 +26,9 @@
 
 #define MAX_FRAMES_IN_FLIGHT 2
 
+// Where the driver's pipeline cache gets saved between runs. Safe to delete, it just makes the next start slower.
+#define PIPELINE_CACHE_FILE "./pipeline_cache.bin"
+
 struct JEMemoryBlock_VK {
     VkDeviceMemory memory;
     uint32_t type;
@@ -48,6 +54,33 @@ struct JEDescriptorSet_VK {
 };
 
 
+// Decoded RGBA8 image from a job worker, waiting to be put in a reserved texture slot.
+struct JETextureUpload_VK {
+    unsigned int descriptorID;
+    unsigned char* pixels; // From stbi, freed once it's in the staging buffer
+    int width;
+    int height;
+    int samplerFilter;
+    // Whole .jtex file. If it's not empty it's used instead of pixels (width/height come from it too). Points into a
+    // bundle mapping or into storage, like a cooked mesh's spans.
+    std::span<const std::byte> cooked;
+    std::vector<std::byte> storage;
+};
+
+// Parsed mesh from a job worker, waiting to be put in a reserved VBO.
+struct JEMeshUpload_VK {
+    unsigned int vboID;
+    std::vector<JEInterleavedVertex_VK> vertices;
+    std::vector<unsigned int> indices;
+    // Cooked meshes leave the vectors empty and point these at GPU ready data instead,
+    // either in a bundle mapping or in storage (moving the upload doesn't move storage's bytes).
+    std::span<const std::byte> cookedVertices;
+    std::span<const std::byte> cookedIndices;
+    std::vector<std::byte> storage;
+    JECookedVertexFormat vertexFormat = JE_VERTEX_FLOAT32; // What cookedVertices holds
+    uint32_t indexSize = 4; // 2 or 4, what cookedIndices holds
+    glm::mat4 dequantize{1.0f}; // Compact positions -> model space, see getDequantizeMatrix
+};
 
 #ifdef DEBUG_ENABLED
 struct JEUniformBufferReference_VK {
@@ -60,12 +93,28 @@ void initGFX(GLFWwindow **window, const char* windowName, int width, int height,
 void renderFrame(const std::vector<Renderable*>& renderables, const std::vector<void (*)()>& imGuiCalls);
 void deinitGFX();
 unsigned int loadTexture(const std::string& fileName, const int& samplerFilter);
-unsigned int loadBundledTexture(char* fileFirstBytePtr, size_t fileLength, const int& samplerFilter);
+unsigned int loadBundledTexture(const unsigned char* fileFirstBytePtr, size_t fileLength, const int& samplerFilter);
+// mips[0] is full size, every level after is half the last. Decompressed on the CPU if the GPU can't do BC.
+unsigned int loadBlockCompressedTexture(JEBlockFormat format, int texWidth, int texHeight, const std::vector<std::vector<unsigned char>>& mips, const int& samplerFilter);
+// Cooked .jtex from texutil, uploaded without decoding or generating anything.
+unsigned int loadCookedTexture(const unsigned char* bytes, size_t length, const int& samplerFilter);
+bool isBlockCompressionSupported();
 unsigned int loadShader(const std::string& file_path, int target);
 unsigned int createProgram(unsigned int VertexShaderID, unsigned int FragmentShaderID, const JEShaderProgramSettings& settings);
 unsigned int loadCubemap(std::vector<std::string> faces);
 void resizeViewport();
+// Indices go up as 16 bit whenever there are few enough vertices.
 unsigned int createVBO(std::vector<JEInterleavedVertex_VK> *interleavedVertices, std::vector<unsigned int> *indices);
+// Cooked mesh data as is, in whatever vertex format and index size it was cooked with.
+unsigned int createVBO(const JECookedMesh& mesh);
+// Takes a JE_VERTEX_COMPACT16 position (0-1 across the bounds) back to model space.
+glm::mat4 getDequantizeMatrix(const JECookedMeshHeader& header);
+// Async loading. Reserve on the main thread, queue from anywhere, and renderFrame uploads whatever is queued.
+unsigned int reserveTexture(unsigned int placeholderID);
+unsigned int reserveVBO();
+void queueTextureUpload(JETextureUpload_VK upload);
+void queueMeshUpload(JEMeshUpload_VK upload);
+void flushUploads();
 /* We are exposing these to the user through engine.h instead.
 unsigned int createUniformBuffer(size_t bufferSize);
 void updateUniformBuffer(unsigned int id, void* ptr, size_t size, bool updateAll);
@@ -3,64 +3,322 @@
 //
 
 #include "bundleutil.h"
+#include "lzutil.h"
 #include <fstream>
 #include <unordered_map>
 #include <cstring>
+#include <mutex>
+#include <memory>
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
-struct JEBundledFileInfo {
+struct JEBundledFileInfo_V1 {
     char path[64];
-    unsigned long fileStartOffset;
-    unsigned long fileLength;
+    uint64_t fileStartOffset;
+    uint64_t fileLength;
 };
 
-struct JEFileHeader {
-    unsigned int magicNum = 0x0B1A11A7;
-    unsigned int fileCount = 0;
+struct JEFileHeader_V1 {
+    uint32_t magicNum = JE_BUNDLE_MAGIC_V1;
+    uint32_t fileCount = 0;
 };
 
-std::unordered_map<std::string, std::vector<unsigned char>> bundleCache{};
+// An open, mapped bundle. v1 bundles don't have anything to search quickly so their table gets hashed on open.
+struct JEMappedBundle {
+    const std::byte* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+    uint32_t version = 0;
+    const JEBundleEntry_V2* entries = nullptr;
+    uint64_t fileCount = 0;
+    // One per entry, set once its checksum has passed so it's never run again. Mutable since lookups only get a const
+    // bundle, and it's never resized once the table's been read.
+    mutable std::vector<std::atomic<bool>> verified;
+    std::unordered_map<std::string, std::span<const std::byte>> v1Files;
 
-std::vector<unsigned char> getFileChars(std::string bundleFileName) {
-    if (bundleCache.contains(bundleFileName)) {
-        return bundleCache.at(bundleFileName);
-    } else {
-        std::vector<unsigned char> chars;
-        std::ifstream file(bundleFileName, std::ios::binary);
-        while (!file.eof()) {
-            char c{};
-            file.get(c);
-            chars.push_back(c);
-        }
-        chars.resize(chars.size()-1); // TODO this is bad, probably
-        bundleCache.insert({bundleFileName, chars});
-        return chars;
+    // Each one separately, mapBundle can throw with only some of them open
+    ~JEMappedBundle() {
+#ifdef _WIN32
+        if (data != nullptr) UnmapViewOfFile(data);
+        if (mapping != nullptr) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (data != nullptr) munmap(const_cast<std::byte*>(data), size);
+#endif
+    }
+};
+
+std::unordered_map<std::string, std::unique_ptr<JEMappedBundle>> openBundles{};
+// Assets get pulled out of bundles from job workers too. Only guards opening/closing, a mapped bundle is read only.
+std::mutex openBundlesMutex;
+
+uint64_t bundlePathHash(std::string_view path) {
+    uint64_t hash = 0xCBF29CE484222325;
+    for (char c : path) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001B3;
     }
+    return hash;
 }
 
-std::vector<unsigned char> getFileCharVec(const std::string& extractFileName, const std::string& bundleFileName) {
-    std::vector<unsigned char> chars = getFileChars(bundleFileName);
-    JEFileHeader head = *reinterpret_cast<JEFileHeader*>(&chars[0]);
-    if (head.magicNum != 0x0B1A11A7) {
+// Whatever's been opened by the time this throws gets closed when the bundle's destroyed
+void mapBundle(JEMappedBundle& bundle, const std::string& bundleFileName) {
+#ifdef _WIN32
+    bundle.file = CreateFileA(bundleFileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (bundle.file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Couldn't open bundle file \"" + bundleFileName + "\"!");
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(bundle.file, &fileSize)) {
+        throw std::runtime_error("Couldn't get the size of bundle file \"" + bundleFileName + "\"!");
+    }
+    bundle.size = static_cast<size_t>(fileSize.QuadPart);
+    bundle.mapping = CreateFileMappingA(bundle.file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (bundle.mapping == nullptr) {
+        throw std::runtime_error("Couldn't map bundle file \"" + bundleFileName + "\"!");
+    }
+    bundle.data = static_cast<const std::byte*>(MapViewOfFile(bundle.mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+    int fd = open(bundleFileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Couldn't open bundle file \"" + bundleFileName + "\"!");
+    }
+    struct stat fileInfo{};
+    if (fstat(fd, &fileInfo) != 0) {
+        close(fd);
+        throw std::runtime_error("Couldn't get the size of bundle file \"" + bundleFileName + "\"!");
+    }
+    bundle.size = static_cast<size_t>(fileInfo.st_size);
+    void* mapped = bundle.size == 0 ? MAP_FAILED : mmap(nullptr, bundle.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping keeps the file alive on its own
+    bundle.data = mapped == MAP_FAILED ? nullptr : static_cast<const std::byte*>(mapped);
+#endif
+    if (bundle.data == nullptr) {
+        throw std::runtime_error("Couldn't map bundle file \"" + bundleFileName + "\"!");
+    }
+}
+
+// Everything gets bounds checked once here so lookups never have to.
+void readBundleTOC(JEMappedBundle& bundle, const std::string& bundleFileName) {
+    uint32_t magic = 0;
+    if (bundle.size >= sizeof(magic)) memcpy(&magic, bundle.data, sizeof(magic));
+
+    if (magic == JE_BUNDLE_MAGIC_V2 && bundle.size >= sizeof(JEBundleHeader_V2)) {
+        JEBundleHeader_V2 head;
+        memcpy(&head, bundle.data, sizeof(head));
+        if (head.version != JE_BUNDLE_VERSION) {
+            throw std::runtime_error("Bundle file \"" + bundleFileName + "\" is version " + std::to_string(head.version) + ", expected " + std::to_string(JE_BUNDLE_VERSION) + "!");
+        }
+        if (head.tocOffset % alignof(JEBundleEntry_V2) != 0 || head.tocOffset > bundle.size ||
+            head.fileCount > (bundle.size - head.tocOffset) / sizeof(JEBundleEntry_V2) || head.pathsOffset > bundle.size) {
+            throw std::runtime_error("Bundle file \"" + bundleFileName + "\" has a broken table of contents!");
+        }
+        bundle.version = 2;
+        bundle.fileCount = head.fileCount;
+        // The mapping is page aligned and tocOffset is 8 aligned, so the table can be used right where it is.
+        bundle.entries = reinterpret_cast<const JEBundleEntry_V2*>(bundle.data + head.tocOffset);
+        for (uint64_t i = 0; i < bundle.fileCount; i++) {
+            const JEBundleEntry_V2& e = bundle.entries[i];
+            if (e.offset > bundle.size || e.storedSize > bundle.size - e.offset || e.pathOffset > bundle.size || e.pathLength > bundle.size - e.pathOffset ||
+                (i > 0 && bundle.entries[i-1].pathHash > e.pathHash) ||
+                (e.codec != JE_BUNDLE_CODEC_STORED && e.codec != JE_BUNDLE_CODEC_LZ) || (e.codec == JE_BUNDLE_CODEC_STORED && e.storedSize != e.size)) {
+                throw std::runtime_error("Bundle file \"" + bundleFileName + "\" has a broken table of contents!");
+            }
+        }
+        bundle.verified = std::vector<std::atomic<bool>>(bundle.fileCount);
+    } else if (magic == JE_BUNDLE_MAGIC_V1 && bundle.size >= sizeof(JEFileHeader_V1)) {
+        JEFileHeader_V1 head;
+        memcpy(&head, bundle.data, sizeof(head));
+        if (head.fileCount > (bundle.size - sizeof(head)) / sizeof(JEBundledFileInfo_V1)) {
+            throw std::runtime_error("Bundle file \"" + bundleFileName + "\" has a broken table of contents!");
+        }
+        bundle.version = 1;
+        for (uint32_t i = 0; i < head.fileCount; i++) {
+            JEBundledFileInfo_V1 info;
+            memcpy(&info, bundle.data + sizeof(head) + i * sizeof(info), sizeof(info));
+            if (info.fileStartOffset > bundle.size || info.fileLength > bundle.size - info.fileStartOffset) continue;
+            bundle.v1Files.insert({std::string(info.path, strnlen(info.path, sizeof(info.path))), {bundle.data + info.fileStartOffset, info.fileLength}});
+        }
+    } else {
         throw std::runtime_error("Couldn't read bundle file \"" + bundleFileName + "\"!");
     }
-    JEBundledFileInfo* correctBfiPtr = nullptr;
-    for (int i = 0; i < head.fileCount; ++i) {
-        JEBundledFileInfo* current = reinterpret_cast<JEBundledFileInfo*>(&chars[sizeof(JEFileHeader) + i * sizeof(JEBundledFileInfo)]);
-        if (extractFileName.starts_with(current->path)) {
-            correctBfiPtr = current;
-            break;
+}
+
+const JEMappedBundle& getBundle(const std::string& bundleFileName) {
+    std::lock_guard<std::mutex> lock(openBundlesMutex);
+    if (openBundles.contains(bundleFileName)) {
+        return *openBundles.at(bundleFileName);
+    }
+    auto bundle = std::make_unique<JEMappedBundle>();
+    mapBundle(*bundle, bundleFileName);
+    readBundleTOC(*bundle, bundleFileName);
+    return *openBundles.insert({bundleFileName, std::move(bundle)}).first->second;
+}
+
+// Where a file is in the mapping and how to get it out. v1 files are always stored and have no checksum.
+struct JEBundleLookup {
+    std::span<const std::byte> stored;
+    uint64_t size;
+    uint32_t codec;
+    uint32_t checksum;
+    std::atomic<bool>* verified; // nullptr if there's no checksum to check
+};
+
+JEBundleLookup findBundledFile(const std::string& extractFileName, const std::string& bundleFileName) {
+    const JEMappedBundle& bundle = getBundle(bundleFileName);
+
+    if (bundle.version == 1) {
+        auto found = bundle.v1Files.find(extractFileName);
+        if (found != bundle.v1Files.end()) return {found->second, found->second.size(), JE_BUNDLE_CODEC_STORED, 0, nullptr};
+        // v1 paths got cut off at 63 characters, so long names only match the start.
+        for (const auto& [path, file] : bundle.v1Files) {
+            if (path.size() == 63 && extractFileName.starts_with(path)) return {file, file.size(), JE_BUNDLE_CODEC_STORED, 0, nullptr};
+        }
+    } else {
+        uint64_t hash = bundlePathHash(extractFileName);
+        const JEBundleEntry_V2* end = bundle.entries + bundle.fileCount;
+        const JEBundleEntry_V2* e = std::lower_bound(bundle.entries, end, hash, [](const JEBundleEntry_V2& entry, uint64_t h) { return entry.pathHash < h; });
+        for (; e != end && e->pathHash == hash; e++) {
+            std::string_view path(reinterpret_cast<const char*>(bundle.data + e->pathOffset), e->pathLength);
+            if (path == extractFileName) return {{bundle.data + e->offset, e->storedSize}, e->size, e->codec, e->checksum, &bundle.verified[e - bundle.entries]};
         }
     }
-    if (correctBfiPtr != nullptr) {
-        JEBundledFileInfo correctBfi{};
-        memcpy(&correctBfi.path, &correctBfiPtr->path, sizeof(correctBfi.path)); // i know it's 64 bytes but codacy hates me and makes me verify it
-        correctBfi.fileLength = correctBfiPtr->fileLength;
-        correctBfi.fileStartOffset = correctBfiPtr->fileStartOffset;
-        chars.erase(chars.begin(), chars.begin()+correctBfi.fileStartOffset);
-        chars.resize(correctBfi.fileLength);
-        return chars;
+    throw std::runtime_error("Couldn't read file \"" + extractFileName + "\" from bundle \"" + bundleFileName + "\"!");
+}
+
+// Only the first time each entry is read. The mapping's read only, so once it's passed it stays passed, and what comes
+// out of decompressing it is always the same too.
+void checkBundledFile(const JEBundleLookup& file, std::span<const std::byte> contents, const std::string& extractFileName) {
+    if (file.verified == nullptr || file.verified->load(std::memory_order_relaxed)) return;
+    if (computeCrc32(contents) != file.checksum) {
+        throw std::runtime_error("Bundled file \"" + extractFileName + "\" failed its checksum!");
+    }
+    file.verified->store(true, std::memory_order_relaxed);
+}
+
+std::span<const std::byte> getBundledFile(const std::string& extractFileName, const std::string& bundleFileName, std::vector<std::byte>& storage) {
+    JEBundleLookup file = findBundledFile(extractFileName, bundleFileName);
+    if (file.codec == JE_BUNDLE_CODEC_STORED) {
+        checkBundledFile(file, file.stored, extractFileName);
+        return file.stored;
+    }
+    storage.resize(file.size);
+    lzDecompress(file.stored, storage);
+    checkBundledFile(file, storage, extractFileName);
+    return storage;
+}
+
+size_t getBundledFileSize(const std::string& extractFileName, const std::string& bundleFileName) {
+    return findBundledFile(extractFileName, bundleFileName).size;
+}
+
+void readBundledFile(const std::string& extractFileName, const std::string& bundleFileName, std::span<std::byte> destination) {
+    JEBundleLookup file = findBundledFile(extractFileName, bundleFileName);
+    if (destination.size() != file.size) {
+        throw std::runtime_error("Buffer for bundled file \"" + extractFileName + "\" is the wrong size!");
+    }
+    if (file.codec == JE_BUNDLE_CODEC_STORED) {
+        if (file.size > 0) memcpy(destination.data(), file.stored.data(), file.size);
+    } else {
+        lzDecompress(file.stored, destination);
+    }
+    checkBundledFile(file, destination, extractFileName);
+}
+
+std::vector<unsigned char> getFileCharVec(const std::string& extractFileName, const std::string& bundleFileName) {
+    std::vector<unsigned char> chars(getBundledFileSize(extractFileName, bundleFileName));
+    readBundledFile(extractFileName, bundleFileName, std::as_writable_bytes(std::span(chars)));
+    return chars;
+}
+
+void closeBundles() {
+    std::lock_guard<std::mutex> lock(openBundlesMutex);
+    openBundles.clear();
+}
+
+std::vector<std::byte> packBundle(const std::vector<JEBundleInput>& files, uint32_t alignment) {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        throw std::runtime_error("Bundle alignment has to be a power of two!");
     }
-    else {
-        throw std::runtime_error("Couldn't read file \"" + extractFileName + "\" from bundle \"" + bundleFileName + "\"!");
+    auto align = [alignment](uint64_t offset) { return (offset + alignment - 1) & ~static_cast<uint64_t>(alignment - 1); };
+
+    JEBundleHeader_V2 head;
+    head.fileCount = files.size();
+    head.tocOffset = sizeof(JEBundleHeader_V2);
+    head.pathsOffset = head.tocOffset + sizeof(JEBundleEntry_V2) * files.size();
+    head.alignment = alignment;
+
+    std::vector<JEBundleEntry_V2> entries(files.size());
+    std::string paths;
+    for (size_t i = 0; i < files.size(); i++) {
+        entries[i].pathHash = bundlePathHash(files[i].path);
+        entries[i].pathOffset = head.pathsOffset + paths.size();
+        entries[i].pathLength = files[i].path.size();
+        paths += files[i].path;
+    }
+
+    std::vector<std::byte> data;
+    // Content hash -> entries already holding that data. Hash collisions still get a full compare.
+    std::unordered_map<uint64_t, std::vector<size_t>> written;
+    uint64_t dataStart = align(head.pathsOffset + paths.size());
+    for (size_t i = 0; i < files.size(); i++) {
+        const std::vector<std::byte>& contents = files[i].contents;
+        std::string_view contentView(reinterpret_cast<const char*>(contents.data()), contents.size());
+        uint64_t contentHash = bundlePathHash(contentView);
+
+        bool duplicate = false;
+        for (size_t other : written[contentHash]) {
+            if (files[other].contents == contents && files[other].compress == files[i].compress) {
+                JEBundleEntry_V2 copy = entries[other];
+                copy.pathHash = entries[i].pathHash;
+                copy.pathOffset = entries[i].pathOffset;
+                copy.pathLength = entries[i].pathLength;
+                entries[i] = copy;
+                duplicate = true;
+                break;
+            }
+        }
+        if (duplicate) continue;
+        written[contentHash].push_back(i);
+
+        entries[i].size = contents.size();
+        entries[i].checksum = computeCrc32(contents);
+        entries[i].codec = JE_BUNDLE_CODEC_STORED;
+        std::vector<std::byte> compressed;
+        if (files[i].compress && !contents.empty()) {
+            compressed = lzCompress(contents);
+            // Not worth a decompress pass for a couple percent
+            if (compressed.size() < contents.size() - contents.size() / 16) entries[i].codec = JE_BUNDLE_CODEC_LZ;
+        }
+        const std::vector<std::byte>& stored = entries[i].codec == JE_BUNDLE_CODEC_LZ ? compressed : contents;
+
+        data.resize(align(dataStart + data.size()) - dataStart);
+        entries[i].offset = dataStart + data.size();
+        entries[i].storedSize = stored.size();
+        data.insert(data.end(), stored.begin(), stored.end());
     }
-}
\ No newline at end of file
+
+    // Lookups binary search by hash, the data stays in the order it was given.
+    std::stable_sort(entries.begin(), entries.end(), [](const JEBundleEntry_V2& a, const JEBundleEntry_V2& b) { return a.pathHash < b.pathHash; });
+
+    std::vector<std::byte> bundle(dataStart + data.size());
+    memcpy(bundle.data(), &head, sizeof(head));
+    if (!entries.empty()) memcpy(bundle.data() + head.tocOffset, entries.data(), sizeof(JEBundleEntry_V2) * entries.size());
+    if (!paths.empty()) memcpy(bundle.data() + head.pathsOffset, paths.data(), paths.size());
+    if (!data.empty()) memcpy(bundle.data() + dataStart, data.data(), data.size());
+    return bundle;
+}
@@ -7,7 +7,92 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
+#include <span>
+#include <cstddef>
+#include <cstdint>
 
+// v1 bundles: JEFileHeader_V1, then a JEBundledFileInfo_V1 (64 char path, offset, length) per file, then the data.
+#define JE_BUNDLE_MAGIC_V1 0x0B1A11A7
+
+// v2 bundles, all little endian:
+//   JEBundleHeader_V2
+//   JEBundleEntry_V2[fileCount]    at tocOffset, sorted by pathHash so lookups are a binary search
+//   path strings                   at pathsOffset, not null terminated, entries point into here
+//   file data                      every file starts on a multiple of alignment, stored raw or compressed per entry
+#define JE_BUNDLE_MAGIC_V2 0x3244424A // "JBD2"
+#define JE_BUNDLE_VERSION 2
+
+#define JE_BUNDLE_CODEC_STORED 0 // As is
+#define JE_BUNDLE_CODEC_LZ 1     // LZ4 block, see lzutil.h
+
+struct JEBundleHeader_V2 {
+    uint32_t magic = JE_BUNDLE_MAGIC_V2;
+    uint32_t version = JE_BUNDLE_VERSION;
+    uint64_t fileCount = 0;
+    uint64_t tocOffset = 0;
+    uint64_t pathsOffset = 0;
+    uint32_t alignment = 16;
+    uint32_t reserved = 0;
+};
+
+struct JEBundleEntry_V2 {
+    uint64_t pathHash; // bundlePathHash(path)
+    uint64_t offset;     // From the start of the bundle
+    uint64_t storedSize; // What's actually in the bundle
+    uint64_t size;       // After decompressing
+    uint64_t pathOffset;
+    uint32_t pathLength;
+    uint32_t codec;      // JE_BUNDLE_CODEC_*
+    uint32_t checksum;   // CRC-32 of the uncompressed file
+    uint32_t reserved;
+};
+
+/**
+ * FNV-1a, 64 bit. What the v2 table of contents is sorted by.
+ */
+uint64_t bundlePathHash(std::string_view path);
+/**
+ * Get a file out of a bundle. The bundle gets memory mapped the first time it's used and stays mapped until closeBundles(),
+ * so finding the file is a binary search. Stored files aren't copied at all, compressed ones get decompressed into storage.
+ * The checksum is checked either way.
+ * Safe to call from job workers, which is where anything compressed should be loaded from.
+ * @param extractFileName Path of the file as it was packed, e.g. "./textures/logo.png"
+ * @param bundleFileName Path of the .jbd
+ * @param storage Where compressed files get decompressed to. Left alone for stored files.
+ * @return View into either the mapping or storage. Throws std::runtime_error if the file can't be found or is broken.
+ */
+std::span<const std::byte> getBundledFile(const std::string& extractFileName, const std::string& bundleFileName, std::vector<std::byte>& storage);
+/**
+ * @return Size of a bundled file once it's decompressed.
+ */
+size_t getBundledFileSize(const std::string& extractFileName, const std::string& bundleFileName);
+/**
+ * Decompress (or copy) a bundled file straight into a buffer the caller already has, checksum checked.
+ * @param destination Has to be exactly getBundledFileSize() bytes.
+ */
+void readBundledFile(const std::string& extractFileName, const std::string& bundleFileName, std::span<std::byte> destination);
+/**
+ * Same as getBundledFile, but always copied out into its own vector.
+ */
 std::vector<unsigned char> getFileCharVec(const std::string& extractFileName, const std::string& bundleFileName);
+// One file going into packBundle.
+struct JEBundleInput {
+    std::string path;                // What it gets looked up by, e.g. "./textures/logo.png"
+    std::vector<std::byte> contents;
+    bool compress = true;            // Only kept compressed if it actually got smaller
+};
+
+/**
+ * Build a v2 bundle. File data is written in the order given, so put files that get loaded together next to each other.
+ * Files with identical contents are only stored once, every path just points at the same data.
+ * @param alignment Every file's data starts on a multiple of this, has to be a power of two
+ * @return The whole bundle
+ */
+std::vector<std::byte> packBundle(const std::vector<JEBundleInput>& files, uint32_t alignment = 16);
+/**
+ * Unmap every open bundle. Every span getBundledFile handed out is dead after this.
+ */
+void closeBundles();
 
 #endif //JOSHENGINE_BUNDLEUTIL_H
@@ -0,0 +1,248 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+// jbdpack: packs a directory into a .jbd bundle, optionally cooking assets on the way in.
+//   jbdpack <output.jbd> <directory> [options]
+//     --prefix <path>         What goes in front of every path in the bundle. Defaults to "./<directory name>/",
+//                             which is what the game asks for (e.g. "./textures/logo.png").
+//     --manifest <file>       One bundle path per line, in the order the game loads them. Those get packed first,
+//                             in that order, so loading is a sequential read. Everything else goes after, sorted.
+//     --cook-textures <fmt>   rgba, bc1, bc3, bc5 or bc7. Images become cooked .jtex textures, keeping their path.
+//     --cook-textures-for <glob> <fmt>
+//                             Cook images matching glob to fmt instead, e.g. --cook-textures-for "*_specmis.png" bc5
+//                             for two channel spec/emissive maps next to bc7 albedo. Matched against the path inside
+//                             the directory, or just the file name if the glob has no '/'. * doesn't cross a '/', **
+//                             does, ? is any one character. Later rules win. Images matching no rule get the
+//                             --cook-textures format, or stay as they are without one.
+//     --box-mips              Box filter for cooked mips instead of Kaiser.
+//     --cook-meshes           OBJs become cooked .jmesh meshes, keeping their path. Triangles and vertices get reordered
+//                             for the vertex cache, overdraw and vertex fetch on the way (prints ACMR/ATVR before/after).
+//     --no-optimize           Cook meshes in the order the OBJ has them.
+//     --compact-vertices      Cook meshes to the 16 byte JE_VERTEX_COMPACT16 layout instead of 32 byte floats. Only for
+//                             bundles whose meshes are all drawn with vertex shaders that have a JE_COMPACT_VERTICES
+//                             path (vertex3d.glsl does, the skybox's doesn't).
+//     --no-compress           Store everything as is.
+//     --align <n>             Data alignment, power of two. Default 16.
+//
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#include "bundleutil.h"
+#include "../gfx/texutil.h"
+#include "../gfx/meshutil.h"
+#include "../job/jobutil.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+
+std::vector<std::byte> readWholeFile(const std::filesystem::path& path) {
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+    if (!stream.is_open()) throw std::runtime_error("Couldn't open " + path.string());
+    std::vector<std::byte> contents(static_cast<size_t>(stream.tellg()));
+    stream.seekg(0);
+    stream.read(reinterpret_cast<char*>(contents.data()), static_cast<std::streamsize>(contents.size()));
+    return contents;
+}
+
+bool isImage(const std::string& path) {
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+    return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".bmp" || extension == ".tga";
+}
+
+std::vector<std::byte> cookImage(const std::vector<std::byte>& file, JECookedFormat format, bool kaiser) {
+    int width, height, channels;
+    // Same orientation the engine loads uncooked images in
+    stbi_set_flip_vertically_on_load_thread(true);
+    stbi_uc* pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(file.data()), static_cast<int>(file.size()), &width, &height, &channels, STBI_rgb_alpha);
+    if (!pixels) throw std::runtime_error(stbi_failure_reason());
+    std::vector<unsigned char> cooked = cookTexture(pixels, width, height, format, kaiser);
+    stbi_image_free(pixels);
+    auto first = reinterpret_cast<const std::byte*>(cooked.data());
+    return {first, first + cooked.size()};
+}
+
+// Whole string against a glob, see --cook-textures-for
+bool globMatches(std::string_view glob, std::string_view text) {
+    if (glob.empty()) return text.empty();
+    if (glob.starts_with("**")) {
+        for (size_t skip = 0; skip <= text.size(); skip++) {
+            if (globMatches(glob.substr(2), text.substr(skip))) return true;
+        }
+        return false;
+    }
+    if (glob[0] == '*') {
+        for (size_t skip = 0; skip <= text.size(); skip++) {
+            if (globMatches(glob.substr(1), text.substr(skip))) return true;
+            if (skip < text.size() && text[skip] == '/') break;
+        }
+        return false;
+    }
+    if (text.empty() || (glob[0] != '?' && glob[0] != text[0]) || (glob[0] == '?' && text[0] == '/')) return false;
+    return globMatches(glob.substr(1), text.substr(1));
+}
+
+struct JETextureRule {
+    std::string glob;
+    JECookedFormat format;
+};
+
+bool isObj(const std::string& path) {
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+    return extension == ".obj";
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: jbdpack <output.jbd> <directory> [--prefix <path>] [--manifest <file>] [--cook-textures rgba|bc1|bc3|bc5|bc7] [--cook-textures-for <glob> <fmt>]... [--box-mips] [--cook-meshes] [--no-optimize] [--compact-vertices] [--no-compress] [--align <n>]" << std::endl;
+        return 1;
+    }
+    std::filesystem::path output = argv[1];
+    std::filesystem::path directory = argv[2];
+    std::string prefix = "./" + directory.lexically_normal().filename().string() + "/";
+    if (prefix == ".//") prefix = "./" + directory.lexically_normal().parent_path().filename().string() + "/";
+    std::filesystem::path manifest;
+    bool cookTextures = false, cookMeshes = false, optimizeMeshes = true, kaiser = true, compress = true;
+    JECookedFormat textureFormat = JE_COOKED_BC7;
+    std::vector<JETextureRule> textureRules;
+    JECookedVertexFormat meshFormat = JE_VERTEX_FLOAT32;
+    uint32_t alignment = 16;
+
+    const std::unordered_map<std::string, JECookedFormat> textureFormats = {
+        {"rgba", JE_COOKED_RGBA8_SRGB}, {"bc1", JE_COOKED_BC1}, {"bc3", JE_COOKED_BC3}, {"bc5", JE_COOKED_BC5}, {"bc7", JE_COOKED_BC7}
+    };
+
+    for (int i = 3; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--prefix" && hasValue) {
+            prefix = argv[++i];
+        } else if (arg == "--manifest" && hasValue) {
+            manifest = argv[++i];
+        } else if (arg == "--cook-textures" && hasValue && textureFormats.contains(argv[i+1])) {
+            cookTextures = true;
+            textureFormat = textureFormats.at(argv[++i]);
+        } else if (arg == "--cook-textures-for" && i + 2 < argc && textureFormats.contains(argv[i+2])) {
+            textureRules.push_back({argv[i+1], textureFormats.at(argv[i+2])});
+            i += 2;
+        } else if (arg == "--box-mips") {
+            kaiser = false;
+        } else if (arg == "--cook-meshes") {
+            cookMeshes = true;
+        } else if (arg == "--no-optimize") {
+            optimizeMeshes = false;
+        } else if (arg == "--compact-vertices") {
+            meshFormat = JE_VERTEX_COMPACT16;
+        } else if (arg == "--no-compress") {
+            compress = false;
+        } else if (arg == "--align" && hasValue) {
+            alignment = std::stoul(argv[++i]);
+        } else {
+            std::cerr << "jbdpack: Don't know what to do with \"" << arg << "\"!" << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        // Sorted so the same directory always packs into the same bytes
+        std::vector<JEBundleInput> files;
+        std::vector<std::filesystem::path> sources;
+        std::vector<std::string> relatives;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(directory)) {
+            std::string relative = std::filesystem::relative(entry.path(), directory).generic_string();
+            if (!entry.is_regular_file() || relative.starts_with(".") || relative.find("/.") != std::string::npos) continue; // .DS_Store and friends
+            sources.push_back(entry.path());
+            relatives.push_back(relative);
+            files.push_back({prefix + relative, {}, compress});
+        }
+        std::vector<size_t> order(files.size());
+        for (size_t i = 0; i < order.size(); i++) order[i] = i;
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return files[a].path < files[b].path; });
+
+        if (!manifest.empty()) {
+            std::ifstream manifestStream(manifest);
+            if (!manifestStream.is_open()) throw std::runtime_error("Couldn't open manifest " + manifest.string());
+            std::unordered_map<std::string, size_t> rank;
+            std::string line;
+            while (std::getline(manifestStream, line)) {
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                if (line.empty() || line.starts_with("#") || rank.contains(line)) continue;
+                rank.insert({line, rank.size()});
+            }
+            std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                size_t rankA = rank.contains(files[a].path) ? rank.at(files[a].path) : rank.size();
+                size_t rankB = rank.contains(files[b].path) ? rank.at(files[b].path) : rank.size();
+                return rankA < rankB;
+            });
+        }
+
+        initJobs();
+        std::atomic<size_t> cooked = 0;
+        std::mutex meshStatsMutex;
+        JEVertexCacheStats meshesBefore, meshesAfter;
+        parallelFor(files.size(), [&](size_t i) {
+            files[i].contents = readWholeFile(sources[i]);
+            // Last rule that matches, otherwise the default if there is one
+            bool cookTexture = cookTextures;
+            JECookedFormat format = textureFormat;
+            std::string_view fileName = std::string_view(relatives[i]).substr(relatives[i].rfind('/') + 1);
+            for (const JETextureRule& rule : textureRules) {
+                if (globMatches(rule.glob, rule.glob.find('/') == std::string::npos ? fileName : std::string_view(relatives[i]))) {
+                    cookTexture = true;
+                    format = rule.format;
+                }
+            }
+            if (cookTexture && isImage(files[i].path)) {
+                files[i].contents = cookImage(files[i].contents, format, kaiser);
+                cooked++;
+            } else if (cookMeshes && isObj(files[i].path)) {
+                std::vector<Model> models = parseObj(files[i].contents);
+                if (optimizeMeshes) {
+                    JEVertexCacheStats before, after;
+                    for (Model& m : models) {
+                        before += measureVertexCache(m);
+                        optimizeModel(m);
+                        after += measureVertexCache(m);
+                    }
+                    std::lock_guard lock(meshStatsMutex);
+                    std::cout << "jbdpack: " << files[i].path << " ACMR " << before.acmr() << " -> " << after.acmr() << ", ATVR " << before.atvr() << " -> " << after.atvr() << std::endl;
+                    meshesBefore += before;
+                    meshesAfter += after;
+                }
+                files[i].contents = cookMesh(models, meshFormat);
+                cooked++;
+            }
+        }, 1);
+        deinitJobs();
+
+        std::vector<JEBundleInput> ordered;
+        for (size_t i : order) ordered.push_back(std::move(files[i]));
+
+        size_t inputBytes = 0;
+        for (const auto& f : ordered) inputBytes += f.contents.size();
+        std::vector<std::byte> bundle = packBundle(ordered, alignment);
+
+        std::filesystem::path temporary = output;
+        temporary += ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(bundle.data()), static_cast<std::streamsize>(bundle.size()));
+            if (!out.good()) throw std::runtime_error("Couldn't write " + temporary.string());
+        }
+        std::filesystem::rename(temporary, output);
+
+        if (meshesBefore.triangles > 0) {
+            std::cout << "jbdpack: All meshes ACMR " << meshesBefore.acmr() << " -> " << meshesAfter.acmr() << ", ATVR " << meshesBefore.atvr() << " -> " << meshesAfter.atvr() << std::endl;
+        }
+        std::cout << "jbdpack: " << ordered.size() << " files (" << cooked << " cooked), " << inputBytes << " -> " << bundle.size() << " bytes in " << output.string() << std::endl;
+    } catch (std::exception &e) {
+        std::cerr << "jbdpack: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,149 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#include "lzutil.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+#define LZ_MIN_MATCH 4
+#define LZ_LAST_LITERALS 5 // The last 5 bytes are always literals
+#define LZ_MATCH_SAFE 12   // and the last match has to start at least 12 bytes before the end
+#define LZ_MAX_OFFSET 65535
+#define LZ_HASH_BITS 16
+
+uint32_t read32(const std::byte* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// Length over 15 spills into extra bytes, 255 each until one that's less.
+void writeLength(std::vector<std::byte>& out, size_t length) {
+    for (; length >= 255; length -= 255) out.push_back(std::byte{255});
+    out.push_back(static_cast<std::byte>(length));
+}
+
+void writeSequence(std::vector<std::byte>& out, const std::byte* literals, size_t literalLength, size_t offset, size_t matchLength) {
+    size_t matchCode = matchLength - LZ_MIN_MATCH;
+    out.push_back(static_cast<std::byte>((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(matchCode, 15)));
+    if (literalLength >= 15) writeLength(out, literalLength - 15);
+    out.insert(out.end(), literals, literals + literalLength);
+    out.push_back(static_cast<std::byte>(offset & 0xFF));
+    out.push_back(static_cast<std::byte>(offset >> 8));
+    if (matchCode >= 15) writeLength(out, matchCode - 15);
+}
+
+std::vector<std::byte> lzCompress(std::span<const std::byte> source) {
+    std::vector<std::byte> out;
+    out.reserve(source.size() / 2 + 16);
+    const std::byte* src = source.data();
+    size_t size = source.size();
+    size_t anchor = 0;
+
+    if (size > LZ_MATCH_SAFE) {
+        // Last place each 4 byte sequence was seen, plus one so zero means never
+        std::vector<uint32_t> table(1 << LZ_HASH_BITS, 0);
+        size_t matchLimit = size - LZ_LAST_LITERALS;
+        size_t inputLimit = size - LZ_MATCH_SAFE;
+        size_t i = 0;
+        while (i <= inputLimit) {
+            uint32_t sequence = read32(src + i);
+            uint32_t hash = (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+            size_t candidate = table[hash];
+            table[hash] = static_cast<uint32_t>(i + 1);
+
+            if (candidate == 0 || i - (candidate - 1) > LZ_MAX_OFFSET || read32(src + candidate - 1) != sequence) {
+                // Skip ahead faster the longer nothing has matched, incompressible data would crawl otherwise.
+                i += 1 + ((i - anchor) >> 6);
+                continue;
+            }
+            size_t match = candidate - 1;
+
+            // Grab whatever matches before the hashed bytes too
+            while (i > anchor && match > 0 && src[i-1] == src[match-1]) {
+                i--;
+                match--;
+            }
+            size_t length = LZ_MIN_MATCH;
+            while (i + length < matchLimit && src[match + length] == src[i + length]) length++;
+
+            writeSequence(out, src + anchor, i - anchor, i - match, length);
+            i += length;
+            anchor = i;
+        }
+    }
+
+    size_t literalLength = size - anchor;
+    out.push_back(static_cast<std::byte>(std::min<size_t>(literalLength, 15) << 4));
+    if (literalLength >= 15) writeLength(out, literalLength - 15);
+    out.insert(out.end(), src + anchor, src + size);
+    return out;
+}
+
+void lzDecompress(std::span<const std::byte> source, std::span<std::byte> destination) {
+    const std::byte* src = source.data();
+    std::byte* dst = destination.data();
+    size_t in = 0, out = 0;
+    size_t sourceSize = source.size(), destinationSize = destination.size();
+
+    auto readLength = [&](size_t length) {
+        if (length != 15) return length;
+        std::byte b;
+        do {
+            if (in >= sourceSize) throw std::runtime_error("LZ block is cut off!");
+            b = src[in++];
+            length += static_cast<size_t>(b);
+        } while (b == std::byte{255});
+        return length;
+    };
+
+    while (true) {
+        if (in >= sourceSize) throw std::runtime_error("LZ block is cut off!");
+        auto token = static_cast<size_t>(src[in++]);
+
+        size_t literalLength = readLength(token >> 4);
+        if (literalLength > sourceSize - in || literalLength > destinationSize - out) {
+            throw std::runtime_error("LZ block literals run past the end!");
+        }
+        if (literalLength > 0) memcpy(dst + out, src + in, literalLength);
+        in += literalLength;
+        out += literalLength;
+        if (in == sourceSize) break; // The last sequence is only literals
+
+        if (sourceSize - in < 2) throw std::runtime_error("LZ block is cut off!");
+        size_t offset = static_cast<size_t>(src[in]) | (static_cast<size_t>(src[in+1]) << 8);
+        in += 2;
+        if (offset == 0 || offset > out) throw std::runtime_error("LZ block match points before the start!");
+
+        size_t matchLength = readLength(token & 15) + LZ_MIN_MATCH;
+        if (matchLength > destinationSize - out) throw std::runtime_error("LZ block match runs past the end!");
+        if (offset >= matchLength) {
+            memcpy(dst + out, dst + out - offset, matchLength);
+        } else {
+            // Overlapping (repeating pattern), has to go a byte at a time
+            for (size_t i = 0; i < matchLength; i++) dst[out + i] = dst[out + i - offset];
+        }
+        out += matchLength;
+    }
+
+    if (out != destinationSize) throw std::runtime_error("LZ block decompressed to the wrong size!");
+}
+
+constexpr std::array<uint32_t, 256> crcTable = [] {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+        table[i] = c;
+    }
+    return table;
+}();
+
+uint32_t computeCrc32(std::span<const std::byte> bytes) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (std::byte b : bytes) crc = crcTable[(crc ^ static_cast<uint32_t>(b)) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFF;
+}
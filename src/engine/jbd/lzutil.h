@@ -0,0 +1,31 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#ifndef JOSHENGINE_LZUTIL_H
+#define JOSHENGINE_LZUTIL_H
+
+#include <vector>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+
+// LZ4 block format (no frame, no dictionary). Decoding is a couple of memcpys per sequence, so it's a lot faster than
+// reading the bytes it saves off disk.
+
+/**
+ * Compress a buffer. Greedy matching off a hash table, meant for packing bundles, not for anything at runtime.
+ * @return The compressed block. Can be bigger than the input if it doesn't compress, check before storing it.
+ */
+std::vector<std::byte> lzCompress(std::span<const std::byte> source);
+/**
+ * Decompress a block straight into destination, which has to be exactly the uncompressed size.
+ * Bounds checked, throws std::runtime_error on anything broken instead of reading or writing out of bounds.
+ */
+void lzDecompress(std::span<const std::byte> source, std::span<std::byte> destination);
+/**
+ * CRC-32 (the zlib/PNG one).
+ */
+uint32_t computeCrc32(std::span<const std::byte> bytes);
+
+#endif //JOSHENGINE_LZUTIL_H
@@ -0,0 +1,128 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#include "jobutil.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <chrono>
+#include <algorithm>
+#include <atomic>
+
+std::vector<std::thread> jobWorkers;
+std::deque<std::packaged_task<void()>> jobQueue;
+std::mutex jobQueueMutex;
+std::condition_variable jobQueueCondition;
+std::atomic<bool> jobsRunning = false; // Atomic since initJobs checks it without the queue lock
+
+// Pops one job off the queue and runs it. Returns false if there was nothing to do.
+bool runQueuedJob() {
+    std::packaged_task<void()> task;
+    {
+        std::lock_guard<std::mutex> lock(jobQueueMutex);
+        if (jobQueue.empty()) return false;
+        task = std::move(jobQueue.front());
+        jobQueue.pop_front();
+    }
+    task();
+    return true;
+}
+
+void jobWorkerLoop() {
+    while (true) {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(jobQueueMutex);
+            jobQueueCondition.wait(lock, []{ return !jobQueue.empty() || !jobsRunning; });
+            if (jobQueue.empty()) return; // Only empty here if we're shutting down.
+            task = std::move(jobQueue.front());
+            jobQueue.pop_front();
+        }
+        // Exceptions end up in the job's future, packaged_task deals with that for us.
+        task();
+    }
+}
+
+void initJobs() {
+    if (jobsRunning) return;
+    jobsRunning = true;
+    // Leave a core for the main thread, but always have at least one worker.
+    unsigned int workerCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    for (unsigned int i = 0; i < workerCount; i++) {
+        jobWorkers.emplace_back(&jobWorkerLoop);
+    }
+}
+
+void deinitJobs() {
+    {
+        std::lock_guard<std::mutex> lock(jobQueueMutex);
+        jobsRunning = false;
+    }
+    jobQueueCondition.notify_all();
+    for (auto& worker : jobWorkers) {
+        worker.join();
+    }
+    jobWorkers.clear();
+}
+
+unsigned int getJobWorkerCount() {
+    return jobWorkers.size();
+}
+
+JEJob submitJob(std::function<void()> job) {
+    std::packaged_task<void()> task(std::move(job));
+    JEJob handle = task.get_future().share();
+    {
+        // Checked under the lock so deinitJobs can't let the workers go between the check and the push
+        std::lock_guard<std::mutex> lock(jobQueueMutex);
+        if (jobsRunning) jobQueue.push_back(std::move(task));
+    }
+    if (task.valid()) {
+        // No workers (yet, or anymore). Just do it right here.
+        task();
+        return handle;
+    }
+    jobQueueCondition.notify_one();
+    return handle;
+}
+
+void waitForJobs(const std::vector<JEJob>& jobs) {
+    for (const auto& job : jobs) {
+        // Help out instead of blocking, this is also what keeps jobs that wait on other jobs from deadlocking.
+        while (job.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (!runQueuedJob()) job.wait_for(std::chrono::microseconds(100));
+        }
+    }
+    for (const auto& job : jobs) {
+        job.get();
+    }
+}
+
+void parallelFor(size_t count, const std::function<void(size_t i)>& function, size_t minChunkSize) {
+    if (count == 0) return;
+    size_t threads = getJobWorkerCount() + 1;
+    size_t chunkSize = std::max(minChunkSize, (count + threads - 1) / threads);
+    if (chunkSize >= count) {
+        for (size_t i = 0; i < count; i++) function(i);
+        return;
+    }
+
+    std::vector<JEJob> jobs;
+    // The calling thread takes the first chunk itself.
+    for (size_t start = chunkSize; start < count; start += chunkSize) {
+        size_t end = std::min(start + chunkSize, count);
+        jobs.push_back(submitJob([&function, start, end]() {
+            for (size_t i = start; i < end; i++) function(i);
+        }));
+    }
+    try {
+        for (size_t i = 0; i < chunkSize; i++) function(i);
+    } catch (...) {
+        // The other chunks still reference function, they have to finish before we unwind.
+        for (const auto& job : jobs) job.wait();
+        throw;
+    }
+    waitForJobs(jobs);
+}
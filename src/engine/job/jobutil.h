@@ -0,0 +1,48 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#ifndef JOSHENGINE_JOBUTIL_H
+#define JOSHENGINE_JOBUTIL_H
+
+#include <functional>
+#include <future>
+#include <vector>
+
+// A handle to a job submitted to the worker threads. get() rethrows anything the job threw.
+typedef std::shared_future<void> JEJob;
+
+/**
+ * Start the job worker threads. The engine's init() already calls this, you shouldn't have to.
+ */
+void initJobs();
+/**
+ * Finish whatever is queued and join the job worker threads.
+ */
+void deinitJobs();
+/**
+ * @return How many worker threads are running jobs (not counting the main thread).
+ */
+unsigned int getJobWorkerCount();
+/**
+ * Queue a function to be run on a worker thread.
+ * Jobs run in no particular order and can run at the same time as each other, so don't touch engine state that isn't thread safe.
+ * @param job Function to run
+ * @return Handle to wait on
+ */
+JEJob submitJob(std::function<void()> job);
+/**
+ * Wait for a list of jobs, running queued jobs on this thread while we wait instead of just sleeping.
+ * Rethrows the first exception thrown by any of the jobs.
+ * @param jobs Jobs to wait for
+ */
+void waitForJobs(const std::vector<JEJob>& jobs);
+/**
+ * Split [0, count) into chunks and run them across the workers and the calling thread, returning when all are done.
+ * @param count Number of items
+ * @param function Called once for every index
+ * @param minChunkSize Smallest amount of items a single job gets, so tiny loops don't drown in queue overhead
+ */
+void parallelFor(size_t count, const std::function<void(size_t i)>& function, size_t minChunkSize = 64);
+
+#endif //JOSHENGINE_JOBUTIL_H
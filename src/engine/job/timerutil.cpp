@@ -0,0 +1,151 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#include "timerutil.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+#define JE_TIMER_SLOTS (1 << JE_TIMER_SLOT_BITS)
+
+struct JETimer {
+    uint64_t when = 0; // Tick it goes off on
+    void (*callback)(GameObject* object) = nullptr;
+    GameObject* object = nullptr;
+    uint32_t generation = 0; // Bumped whenever it's freed, so old IDs (and old entries in the wheel) don't match a reused one
+    bool live = false;
+};
+
+std::vector<JETimer> timers;
+std::vector<uint32_t> freeTimers;
+// Slot s of level l holds timers going off within the level's turn that starts when the ticks it covers read s.
+// Level 0 is single ticks, and everything above gets moved down a level once its slot comes around.
+std::vector<JETimerID> timerWheel[JE_TIMER_LEVELS][JE_TIMER_SLOTS];
+std::unordered_multimap<const GameObject*, uint32_t> objectTimers;
+uint64_t timerTick = 0;
+double timerSeconds = 0;
+
+// Low half is index + 1 so 0 is never a timer
+JETimerID timerID(uint32_t index) {
+    return static_cast<uint64_t>(timers[index].generation) << 32 | (index + 1);
+}
+
+// Index of a timer that's still waiting, -1 if it's gone off, been cancelled or never existed
+int64_t liveTimer(JETimerID id) {
+    auto index = static_cast<uint32_t>(id) - 1;
+    if (static_cast<uint32_t>(id) == 0 || index >= timers.size()) return -1;
+    if (!timers[index].live || timers[index].generation != static_cast<uint32_t>(id >> 32)) return -1;
+    return index;
+}
+
+void insertTimer(uint32_t index) {
+    uint64_t when = timers[index].when;
+    uint64_t delta = when - timerTick;
+    int level = 0;
+    while (level + 1 < JE_TIMER_LEVELS && delta >= static_cast<uint64_t>(1) << (JE_TIMER_SLOT_BITS * (level + 1))) level++;
+    timerWheel[level][(when >> (JE_TIMER_SLOT_BITS * level)) & (JE_TIMER_SLOTS - 1)].push_back(timerID(index));
+}
+
+void freeTimer(uint32_t index) {
+    JETimer& timer = timers[index];
+    if (timer.object != nullptr) {
+        auto [first, last] = objectTimers.equal_range(timer.object);
+        for (auto it = first; it != last; ++it) {
+            if (it->second == index) {
+                objectTimers.erase(it);
+                break;
+            }
+        }
+    }
+    timer.live = false;
+    timer.generation++;
+    timer.object = nullptr;
+    freeTimers.push_back(index);
+}
+
+JETimerID scheduleAfter(double seconds, void (*callback)(GameObject* object), GameObject* object) {
+    uint32_t index;
+    if (freeTimers.empty()) {
+        index = static_cast<uint32_t>(timers.size());
+        timers.emplace_back();
+    } else {
+        index = freeTimers.back();
+        freeTimers.pop_back();
+    }
+    const double maxTicks = static_cast<double>((static_cast<uint64_t>(1) << (JE_TIMER_SLOT_BITS * JE_TIMER_LEVELS)) - 1);
+    double ticks = std::clamp(std::ceil(seconds * JE_TIMER_TICKS_PER_SECOND), 1.0, maxTicks);
+    JETimer& timer = timers[index];
+    timer.when = timerTick + static_cast<uint64_t>(ticks);
+    timer.callback = callback;
+    timer.object = object;
+    timer.live = true;
+    if (object != nullptr) objectTimers.emplace(object, index);
+    insertTimer(index);
+    return timerID(index);
+}
+
+bool cancelTimer(JETimerID timer) {
+    int64_t index = liveTimer(timer);
+    if (index < 0) return false;
+    // Its entry in the wheel stays, but it won't match once the generation's moved on
+    freeTimer(static_cast<uint32_t>(index));
+    return true;
+}
+
+void cancelObjectTimers(const GameObject* object) {
+    auto [first, last] = objectTimers.equal_range(object);
+    if (first == last) return;
+    std::vector<uint32_t> cancelling;
+    for (auto it = first; it != last; ++it) cancelling.push_back(it->second);
+    for (uint32_t index : cancelling) freeTimer(index);
+}
+
+void cancelAllObjectTimers() {
+    std::vector<uint32_t> cancelling;
+    for (auto const& [object, index] : objectTimers) cancelling.push_back(index);
+    for (uint32_t index : cancelling) freeTimer(index);
+}
+
+// One slot of a level's turn has come around, so everything in it is close enough for the levels below
+void cascadeTimers(int level) {
+    std::vector<JETimerID>& slot = timerWheel[level][(timerTick >> (JE_TIMER_SLOT_BITS * level)) & (JE_TIMER_SLOTS - 1)];
+    if (slot.empty()) return;
+    std::vector<JETimerID> moving;
+    moving.swap(slot);
+    for (JETimerID id : moving) {
+        int64_t index = liveTimer(id);
+        if (index >= 0) insertTimer(static_cast<uint32_t>(index));
+    }
+}
+
+void runTimerTick() {
+    // Highest first, what comes down from one level can land in the next one's slot that's due right now
+    for (int level = JE_TIMER_LEVELS - 1; level > 0; level--) {
+        if ((timerTick & ((static_cast<uint64_t>(1) << (JE_TIMER_SLOT_BITS * level)) - 1)) == 0) cascadeTimers(level);
+    }
+    std::vector<JETimerID>& slot = timerWheel[0][timerTick & (JE_TIMER_SLOTS - 1)];
+    if (slot.empty()) return;
+    std::vector<JETimerID> firing;
+    firing.swap(slot);
+    for (JETimerID id : firing) {
+        // Could've been cancelled by something that went off earlier this tick
+        int64_t index = liveTimer(id);
+        if (index < 0) continue;
+        void (*callback)(GameObject* object) = timers[index].callback;
+        GameObject* object = timers[index].object;
+        // Freed first so the callback can delete its object or schedule itself again
+        freeTimer(static_cast<uint32_t>(index));
+        callback(object);
+    }
+}
+
+void advanceTimers(double dt) {
+    timerSeconds += dt;
+    auto target = static_cast<uint64_t>(timerSeconds * JE_TIMER_TICKS_PER_SECOND);
+    while (timerTick < target) {
+        timerTick++;
+        runTimerTick();
+    }
+}
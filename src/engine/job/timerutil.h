@@ -0,0 +1,49 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#ifndef JOSHENGINE_TIMERUTIL_H
+#define JOSHENGINE_TIMERUTIL_H
+
+#include <cstdint>
+
+class GameObject;
+
+// Timers go off on ticks this long, so anything scheduled gets rounded up to the next one
+#define JE_TIMER_TICKS_PER_SECOND 1024
+// Each level of the wheel is 2^this slots, each slot one tick of the level below's whole turn
+#define JE_TIMER_SLOT_BITS 6
+// Levels of the wheel. 5 levels of 64 slots at 1024 ticks a second is about 12 days, longer gets clamped to that.
+#define JE_TIMER_LEVELS 5
+
+// Handle to a scheduled timer, for cancelling it. 0 is never a timer.
+typedef uint64_t JETimerID;
+
+/**
+ * Call a function once some game time from now. Timers sit in a hierarchical timing wheel, so nothing about a timer
+ * that hasn't gone off yet gets looked at every frame. Game time only moves while the engine's running updates.
+ * @param seconds How long from now, rounded up to a whole tick (at least one)
+ * @param callback Called on the main thread, after that frame's GameObject updates. Can schedule and cancel timers.
+ * @param object Passed to the callback. Deleting it cancels the timer, so it has to be the one in the engine's map,
+ * not the one an init function gets before putGameObject copies it in.
+ * @return Handle for cancelTimer
+ */
+JETimerID scheduleAfter(double seconds, void (*callback)(GameObject* object), GameObject* object = nullptr);
+/**
+ * @return false if it had already gone off or been cancelled
+ */
+bool cancelTimer(JETimerID timer);
+/**
+ * Cancel every timer for a GameObject. deleteGameObject already does this.
+ */
+void cancelObjectTimers(const GameObject* object);
+/**
+ * Cancel every timer that has a GameObject, leaving the ones that don't. clearGameObjects already does this.
+ */
+void cancelAllObjectTimers();
+/**
+ * Move game time forward, setting off whatever's due in order. The engine's main loop calls this, you shouldn't have to.
+ */
+void advanceTimers(double dt);
+
+#endif //JOSHENGINE_TIMERUTIL_H
@@ -0,0 +1,142 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#include "bvhutil.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+float surfaceArea(glm::vec3 min, glm::vec3 max) {
+    glm::vec3 size = max - min;
+    return 2 * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+struct JEBVHBin {
+    glm::vec3 min = glm::vec3(INFINITY);
+    glm::vec3 max = glm::vec3(-INFINITY);
+    uint32_t count = 0;
+
+    void grow(glm::vec3 itemMin, glm::vec3 itemMax) {
+        min = glm::min(min, itemMin);
+        max = glm::max(max, itemMax);
+    }
+    void grow(const JEBVHBin& other) {
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+        count += other.count;
+    }
+};
+
+// Builds the node for items [start, end) and everything under it, returns the node's index
+uint32_t buildNode(JEBVH& bvh, uint32_t start, uint32_t end, std::span<const glm::vec3> mins, std::span<const glm::vec3> maxs,
+                   const std::vector<glm::vec3>& centroids) {
+    uint32_t index = static_cast<uint32_t>(bvh.nodes.size());
+    bvh.nodes.emplace_back();
+    JEBVHBin bounds, centroidBounds;
+    for (uint32_t i = start; i < end; i++) {
+        uint32_t item = bvh.items[i];
+        bounds.grow(mins[item], maxs[item]);
+        centroidBounds.grow(centroids[item], centroids[item]);
+    }
+    bvh.nodes[index].min = bounds.min;
+    bvh.nodes[index].max = bounds.max;
+    uint32_t count = end - start;
+
+    // Cheapest split over every axis, costed as items that would be tested times the odds of getting that far (area)
+    float bestCost = INFINITY;
+    int bestAxis = -1;
+    uint32_t bestBin = 0;
+    glm::vec3 extent = centroidBounds.max - centroidBounds.min;
+    if (count > 1) {
+        for (int axis = 0; axis < 3; axis++) {
+            if (extent[axis] <= 0) continue;
+            JEBVHBin bins[JE_BVH_BINS];
+            for (uint32_t i = start; i < end; i++) {
+                uint32_t item = bvh.items[i];
+                auto bin = static_cast<uint32_t>((centroids[item][axis] - centroidBounds.min[axis]) / extent[axis] * JE_BVH_BINS);
+                bin = std::min(bin, static_cast<uint32_t>(JE_BVH_BINS - 1));
+                bins[bin].grow(mins[item], maxs[item]);
+                bins[bin].count++;
+            }
+            // Sweep from the right once to get every right side, then from the left to price each split
+            JEBVHBin right[JE_BVH_BINS];
+            JEBVHBin grow;
+            for (int b = JE_BVH_BINS - 1; b > 0; b--) {
+                grow.grow(bins[b]);
+                right[b] = grow;
+            }
+            JEBVHBin left;
+            for (uint32_t b = 1; b < JE_BVH_BINS; b++) {
+                left.grow(bins[b - 1]);
+                if (left.count == 0 || right[b].count == 0) continue;
+                float cost = left.count * surfaceArea(left.min, left.max) + right[b].count * surfaceArea(right[b].min, right[b].max);
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestBin = b;
+                }
+            }
+        }
+    }
+
+    // Splitting costs a node visit, which is about one item test
+    float leafCost = static_cast<float>(count) * surfaceArea(bounds.min, bounds.max);
+    float splitCost = surfaceArea(bounds.min, bounds.max) + bestCost;
+    if (count <= JE_BVH_MAX_LEAF && (bestAxis < 0 || splitCost >= leafCost)) {
+        bvh.nodes[index].leaf = start << 8 | count;
+        bvh.nodes[index].skip = index + 1;
+        return index;
+    }
+
+    uint32_t middle;
+    if (bestAxis >= 0) {
+        float low = centroidBounds.min[bestAxis], size = extent[bestAxis];
+        auto split = std::partition(bvh.items.begin() + start, bvh.items.begin() + end, [&](uint32_t item) {
+            auto bin = static_cast<uint32_t>((centroids[item][bestAxis] - low) / size * JE_BVH_BINS);
+            return std::min(bin, static_cast<uint32_t>(JE_BVH_BINS - 1)) < bestBin;
+        });
+        middle = static_cast<uint32_t>(split - bvh.items.begin());
+    } else {
+        // Too many items all sitting on the same centroid, nothing to go off of so just halve them
+        middle = start + count / 2;
+    }
+    buildNode(bvh, start, middle, mins, maxs, centroids);
+    buildNode(bvh, middle, end, mins, maxs, centroids);
+    bvh.nodes[index].leaf = 0;
+    bvh.nodes[index].skip = static_cast<uint32_t>(bvh.nodes.size());
+    return index;
+}
+
+JEBVH buildBVH(std::span<const glm::vec3> mins, std::span<const glm::vec3> maxs) {
+    JEBVH bvh;
+    if (mins.empty()) return bvh;
+    if (mins.size() > JE_BVH_MAX_ITEMS) {
+        throw std::runtime_error("Too many items for one BVH!");
+    }
+    bvh.items.resize(mins.size());
+    std::vector<glm::vec3> centroids(mins.size());
+    for (uint32_t i = 0; i < mins.size(); i++) {
+        bvh.items[i] = i;
+        centroids[i] = (mins[i] + maxs[i]) * 0.5f;
+    }
+    bvh.nodes.reserve(mins.size() * 2);
+    buildNode(bvh, 0, static_cast<uint32_t>(mins.size()), mins, maxs, centroids);
+    return bvh;
+}
+
+bool rayHitsBounds(glm::vec3 origin, glm::vec3 inverseMotion, float maxTime, glm::vec3 min, glm::vec3 max) {
+    float enter = 0, leave = maxTime;
+    for (int axis = 0; axis < 3; axis++) {
+        if (std::isinf(inverseMotion[axis])) {
+            // Not moving this way, 0 * infinity would make a NaN out of a ray sitting right on the edge
+            if (origin[axis] < min[axis] || origin[axis] > max[axis]) return false;
+            continue;
+        }
+        float low = (min[axis] - origin[axis]) * inverseMotion[axis];
+        float high = (max[axis] - origin[axis]) * inverseMotion[axis];
+        enter = std::max(enter, std::min(low, high));
+        leave = std::min(leave, std::max(low, high));
+    }
+    return enter <= leave;
+}
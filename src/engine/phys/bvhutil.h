@@ -0,0 +1,77 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#ifndef JOSHENGINE_BVHUTIL_H
+#define JOSHENGINE_BVHUTIL_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <span>
+#include <cstdint>
+
+// Most items a leaf can hold, past this it always splits even if the SAH thinks it's not worth it. Fits in JEBVHNode::leaf.
+#define JE_BVH_MAX_LEAF 8
+// Buckets along each axis that splits get picked from. More is a slightly better tree for a slower build.
+#define JE_BVH_BINS 12
+// Most items one BVH can be built over, a leaf's first item only gets the top 24 bits of JEBVHNode::leaf.
+#define JE_BVH_MAX_ITEMS (1u << 24)
+
+// Nodes are stored depth first, so an inner node's first child is right after it and the second child is after the
+// whole first subtree. skip is where to go once a node's box misses (or a leaf is done), its next sibling or the next one
+// up's. That's the entire traversal, no stack. 32 bytes, two to a cache line.
+struct JEBVHNode {
+    glm::vec3 min;
+    uint32_t skip;
+    glm::vec3 max;
+    uint32_t leaf; // First item << 8 | item count, 0 for inner nodes
+
+    [[nodiscard]] uint32_t itemCount() const { return leaf & 0xFF; }
+    [[nodiscard]] uint32_t firstItem() const { return leaf >> 8; }
+};
+
+// Static bounding volume hierarchy over whatever boxes it's built from. Items are the indices of those boxes.
+struct JEBVH {
+    std::vector<JEBVHNode> nodes;
+    std::vector<uint32_t> items; // Leaves point at ranges of this
+};
+
+/**
+ * Build a BVH, splitting with the surface area heuristic over binned centroids.
+ * Throws if there are more than JE_BVH_MAX_ITEMS items.
+ * @param mins Axis aligned bounds of every item
+ * @param maxs Same length as mins
+ */
+JEBVH buildBVH(std::span<const glm::vec3> mins, std::span<const glm::vec3> maxs);
+/**
+ * Whether a ray gets into a box before maxTime.
+ * @param inverseMotion 1 / motion for each component, infinity where it doesn't move is fine
+ */
+bool rayHitsBounds(glm::vec3 origin, glm::vec3 inverseMotion, float maxTime, glm::vec3 min, glm::vec3 max);
+
+/**
+ * Walk the BVH, looking at the items of every leaf whose way down passes overlaps.
+ * @param overlaps bool(glm::vec3 min, glm::vec3 max), whether anything in a node's box could matter
+ * @param visit bool(uint32_t item), return false to stop
+ */
+template<typename Overlaps, typename Visit>
+void traverseBVH(const JEBVH& bvh, Overlaps&& overlaps, Visit&& visit) {
+    uint32_t i = 0;
+    while (i < bvh.nodes.size()) {
+        const JEBVHNode& node = bvh.nodes[i];
+        if (!overlaps(node.min, node.max)) {
+            i = node.skip;
+            continue;
+        }
+        if (node.leaf == 0) {
+            i++;
+            continue;
+        }
+        for (uint32_t item = node.firstItem(); item < node.firstItem() + node.itemCount(); item++) {
+            if (!visit(bvh.items[item])) return;
+        }
+        i = node.skip;
+    }
+}
+
+#endif //JOSHENGINE_BVHUTIL_H
@@ -0,0 +1,486 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#include "colliderutil.h"
+#include "../engine.h"
+#include "../job/jobutil.h"
+#include <algorithm>
+#include <cmath>
+#include <bit>
+
+// The tests are written once against these, and run 8, 4 or 1 lanes at a time depending on what the build targets.
+// AVX2 only if the compiler was told it can use it (JE_AVX2 in CMake), every x86-64 CPU has SSE2.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define JE_LANES 8
+typedef __m256 JELanes;
+typedef __m256 JELaneMask;
+JELanes lanesLoad(const float* p) { return _mm256_loadu_ps(p); }
+JELanes lanesSet(float v) { return _mm256_set1_ps(v); }
+JELanes lanesAdd(JELanes a, JELanes b) { return _mm256_add_ps(a, b); }
+JELanes lanesSub(JELanes a, JELanes b) { return _mm256_sub_ps(a, b); }
+JELanes lanesMul(JELanes a, JELanes b) { return _mm256_mul_ps(a, b); }
+JELanes lanesDiv(JELanes a, JELanes b) { return _mm256_div_ps(a, b); }
+void lanesStore(float* p, JELanes a) { _mm256_storeu_ps(p, a); }
+JELanes lanesMin(JELanes a, JELanes b) { return _mm256_min_ps(a, b); }
+JELanes lanesMax(JELanes a, JELanes b) { return _mm256_max_ps(a, b); }
+JELanes lanesAbs(JELanes a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+JELaneMask lanesLess(JELanes a, JELanes b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+JELaneMask lanesAnd(JELaneMask a, JELaneMask b) { return _mm256_and_ps(a, b); }
+uint32_t lanesBits(JELaneMask m) { return static_cast<uint32_t>(_mm256_movemask_ps(m)); }
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define JE_LANES 4
+typedef __m128 JELanes;
+typedef __m128 JELaneMask;
+JELanes lanesLoad(const float* p) { return _mm_loadu_ps(p); }
+JELanes lanesSet(float v) { return _mm_set1_ps(v); }
+JELanes lanesAdd(JELanes a, JELanes b) { return _mm_add_ps(a, b); }
+JELanes lanesSub(JELanes a, JELanes b) { return _mm_sub_ps(a, b); }
+JELanes lanesMul(JELanes a, JELanes b) { return _mm_mul_ps(a, b); }
+JELanes lanesDiv(JELanes a, JELanes b) { return _mm_div_ps(a, b); }
+void lanesStore(float* p, JELanes a) { _mm_storeu_ps(p, a); }
+JELanes lanesMin(JELanes a, JELanes b) { return _mm_min_ps(a, b); }
+JELanes lanesMax(JELanes a, JELanes b) { return _mm_max_ps(a, b); }
+JELanes lanesAbs(JELanes a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+JELaneMask lanesLess(JELanes a, JELanes b) { return _mm_cmplt_ps(a, b); }
+JELaneMask lanesAnd(JELaneMask a, JELaneMask b) { return _mm_and_ps(a, b); }
+uint32_t lanesBits(JELaneMask m) { return static_cast<uint32_t>(_mm_movemask_ps(m)); }
+#else
+#define JE_LANES 1
+typedef float JELanes;
+typedef bool JELaneMask;
+JELanes lanesLoad(const float* p) { return *p; }
+JELanes lanesSet(float v) { return v; }
+JELanes lanesAdd(JELanes a, JELanes b) { return a + b; }
+JELanes lanesSub(JELanes a, JELanes b) { return a - b; }
+JELanes lanesMul(JELanes a, JELanes b) { return a * b; }
+JELanes lanesDiv(JELanes a, JELanes b) { return a / b; }
+void lanesStore(float* p, JELanes a) { *p = a; }
+JELanes lanesMin(JELanes a, JELanes b) { return a < b ? a : b; }
+JELanes lanesMax(JELanes a, JELanes b) { return a > b ? a : b; }
+JELanes lanesAbs(JELanes a) { return a < 0 ? -a : a; }
+JELaneMask lanesLess(JELanes a, JELanes b) { return a < b; }
+JELaneMask lanesAnd(JELaneMask a, JELaneMask b) { return a && b; }
+uint32_t lanesBits(JELaneMask m) { return m ? 1 : 0; }
+#endif
+
+// A point in box space for JE_LANES colliders starting at i
+struct JELocalPoint {
+    JELanes x, y, z;
+};
+
+JELocalPoint toColliderSpace(const JEColliderSet& colliders, size_t i, glm::vec3 point) {
+    JELanes dx = lanesSub(lanesSet(point.x), lanesLoad(&colliders.centerX[i]));
+    JELanes dy = lanesSub(lanesSet(point.y), lanesLoad(&colliders.centerY[i]));
+    JELanes dz = lanesSub(lanesSet(point.z), lanesLoad(&colliders.centerZ[i]));
+    JELanes local[3];
+    for (int row = 0; row < 3; row++) {
+        local[row] = lanesAdd(lanesAdd(lanesMul(lanesLoad(&colliders.rotation[row*3][i]), dx),
+                                       lanesMul(lanesLoad(&colliders.rotation[row*3 + 1][i]), dy)),
+                                       lanesMul(lanesLoad(&colliders.rotation[row*3 + 2][i]), dz));
+    }
+    return {local[0], local[1], local[2]};
+}
+
+// Same but a direction, so no moving to the center first
+JELocalPoint toColliderDirection(const JEColliderSet& colliders, size_t i, glm::vec3 direction) {
+    JELanes local[3];
+    for (int row = 0; row < 3; row++) {
+        local[row] = lanesAdd(lanesAdd(lanesMul(lanesLoad(&colliders.rotation[row*3][i]), lanesSet(direction.x)),
+                                       lanesMul(lanesLoad(&colliders.rotation[row*3 + 1][i]), lanesSet(direction.y))),
+                                       lanesMul(lanesLoad(&colliders.rotation[row*3 + 2][i]), lanesSet(direction.z)));
+    }
+    return {local[0], local[1], local[2]};
+}
+
+// Masks off the padding in the last batch
+uint32_t realColliderBits(const JEColliderSet& colliders, size_t batch) {
+    size_t left = colliders.count - std::min(colliders.count, batch * JE_COLLIDER_BATCH);
+    return left >= JE_COLLIDER_BATCH ? (1u << JE_COLLIDER_BATCH) - 1 : (1u << left) - 1;
+}
+
+// One box's axes in world space (rows of the world to box rotation) and half size along each
+struct JEBox {
+    glm::vec3 center;
+    glm::vec3 axes[3];
+    float half[3];
+};
+
+JEBox getBox(const JEColliderSet& colliders, size_t index) {
+    JEBox box{glm::vec3(colliders.centerX[index], colliders.centerY[index], colliders.centerZ[index]), {},
+              {colliders.halfX[index], colliders.halfY[index], colliders.halfZ[index]}};
+    for (int row = 0; row < 3; row++) {
+        box.axes[row] = glm::vec3(colliders.rotation[row*3][index], colliders.rotation[row*3 + 1][index], colliders.rotation[row*3 + 2][index]);
+    }
+    return box;
+}
+
+JEColliderSet bakeColliders(const std::vector<Transform>& boxes) {
+    JEColliderSet colliders;
+    colliders.count = boxes.size();
+    size_t padded = (boxes.size() + JE_COLLIDER_BATCH - 1) / JE_COLLIDER_BATCH * JE_COLLIDER_BATCH;
+    for (auto* field : {&colliders.centerX, &colliders.centerY, &colliders.centerZ, &colliders.halfX, &colliders.halfY, &colliders.halfZ}) {
+        field->resize(padded, 0.0f);
+    }
+    for (auto& field : colliders.rotation) field.resize(padded, 0.0f);
+
+    for (size_t i = 0; i < boxes.size(); i++) {
+        const Transform& box = boxes[i];
+        colliders.centerX[i] = box.position.x;
+        colliders.centerY[i] = box.position.y;
+        colliders.centerZ[i] = box.position.z;
+        // Sign doesn't matter to testPoint, a box flipped inside out is still the same box
+        colliders.halfX[i] = std::abs(box.scale.x);
+        colliders.halfY[i] = std::abs(box.scale.y);
+        colliders.halfZ[i] = std::abs(box.scale.z);
+        // testPoint does vec4(d, 1) * rotate, which is the transpose (inverse) of the rotation. That's column j as row j.
+        mat4 rotate = box.getRotateMatrix();
+        for (int row = 0; row < 3; row++) {
+            for (int column = 0; column < 3; column++) {
+                colliders.rotation[row*3 + column][i] = rotate[row][column];
+            }
+        }
+    }
+
+    // World space bounds of each box for the BVH, each axis reaches as far as its share of every box axis
+    std::vector<glm::vec3> mins(boxes.size()), maxs(boxes.size());
+    for (size_t i = 0; i < boxes.size(); i++) {
+        JEBox box = getBox(colliders, i);
+        glm::vec3 reach = glm::abs(box.axes[0]) * box.half[0] + glm::abs(box.axes[1]) * box.half[1] + glm::abs(box.axes[2]) * box.half[2];
+        mins[i] = box.center - reach;
+        maxs[i] = box.center + reach;
+    }
+    colliders.bvh = buildBVH(mins, maxs);
+    return colliders;
+}
+
+uint32_t testPointBatch(const JEColliderSet& colliders, size_t batch, glm::vec3 point) {
+    uint32_t bits = 0;
+    for (size_t lane = 0; lane < JE_COLLIDER_BATCH; lane += JE_LANES) {
+        size_t i = batch * JE_COLLIDER_BATCH + lane;
+        JELocalPoint local = toColliderSpace(colliders, i, point);
+        JELaneMask inside = lanesAnd(lanesAnd(lanesLess(lanesAbs(local.x), lanesLoad(&colliders.halfX[i])),
+                                              lanesLess(lanesAbs(local.y), lanesLoad(&colliders.halfY[i]))),
+                                              lanesLess(lanesAbs(local.z), lanesLoad(&colliders.halfZ[i])));
+        bits |= lanesBits(inside) << lane;
+    }
+    return bits & realColliderBits(colliders, batch);
+}
+
+uint32_t testSphereBatch(const JEColliderSet& colliders, size_t batch, glm::vec3 center, float radius) {
+    uint32_t bits = 0;
+    JELanes radiusSquared = lanesSet(radius * radius);
+    for (size_t lane = 0; lane < JE_COLLIDER_BATCH; lane += JE_LANES) {
+        size_t i = batch * JE_COLLIDER_BATCH + lane;
+        JELocalPoint local = toColliderSpace(colliders, i, center);
+        // Distance from the closest point on the box, which is the center clamped into it
+        JELanes hx = lanesLoad(&colliders.halfX[i]), hy = lanesLoad(&colliders.halfY[i]), hz = lanesLoad(&colliders.halfZ[i]);
+        JELanes ox = lanesSub(local.x, lanesMax(lanesMin(local.x, hx), lanesSub(lanesSet(0), hx)));
+        JELanes oy = lanesSub(local.y, lanesMax(lanesMin(local.y, hy), lanesSub(lanesSet(0), hy)));
+        JELanes oz = lanesSub(local.z, lanesMax(lanesMin(local.z, hz), lanesSub(lanesSet(0), hz)));
+        JELanes distanceSquared = lanesAdd(lanesAdd(lanesMul(ox, ox), lanesMul(oy, oy)), lanesMul(oz, oz));
+        bits |= lanesBits(lanesLess(distanceSquared, radiusSquared)) << lane;
+    }
+    return bits & realColliderBits(colliders, batch);
+}
+
+bool testPointCollider(const JEColliderSet& colliders, size_t index, glm::vec3 point) {
+    JEBox box = getBox(colliders, index);
+    glm::vec3 d = point - box.center;
+    for (int axis = 0; axis < 3; axis++) {
+        if (!(std::abs(glm::dot(box.axes[axis], d)) < box.half[axis])) return false;
+    }
+    return true;
+}
+
+// Out through the face with the least room left between it and the point. Depth is negative if the point's outside.
+JEContact minimumAxisContact(const JEBox& box, glm::vec3 point) {
+    glm::vec3 d = point - box.center;
+    JEContact contact{};
+    for (int axis = 0; axis < 3; axis++) {
+        float local = glm::dot(box.axes[axis], d);
+        float depth = box.half[axis] - std::abs(local);
+        if (axis == 0 || depth < contact.depth) {
+            contact.normal = box.axes[axis] * (local < 0 ? -1.0f : 1.0f);
+            contact.depth = depth;
+        }
+    }
+    return contact;
+}
+
+bool pointContact(const JEColliderSet& colliders, size_t index, glm::vec3 point, JEContact& contact) {
+    JEContact found = minimumAxisContact(getBox(colliders, index), point);
+    if (!(found.depth > 0)) return false;
+    contact = found;
+    return true;
+}
+
+glm::vec3 closestPointOnCollider(const JEColliderSet& colliders, size_t index, glm::vec3 point) {
+    JEBox box = getBox(colliders, index);
+    glm::vec3 d = point - box.center;
+    glm::vec3 closest = box.center;
+    for (int axis = 0; axis < 3; axis++) {
+        closest += box.axes[axis] * std::clamp(glm::dot(box.axes[axis], d), -box.half[axis], box.half[axis]);
+    }
+    return closest;
+}
+
+bool sphereContact(const JEColliderSet& colliders, size_t index, glm::vec3 center, float radius, JEContact& contact) {
+    JEBox box = getBox(colliders, index);
+    glm::vec3 d = center - box.center;
+    // Offset from the closest point, done in box space so a center that's inside comes out exactly zero
+    glm::vec3 away(0.0f);
+    for (int axis = 0; axis < 3; axis++) {
+        float local = glm::dot(box.axes[axis], d);
+        away += box.axes[axis] * (local - std::clamp(local, -box.half[axis], box.half[axis]));
+    }
+    float distanceSquared = glm::dot(away, away);
+    if (distanceSquared >= radius * radius) return false;
+    if (distanceSquared > 0) {
+        float distance = std::sqrt(distanceSquared);
+        contact.normal = away / distance;
+        contact.depth = radius - distance;
+        return true;
+    }
+    // Center's inside (or right on the surface), so there's no closest point to push away from
+    contact = minimumAxisContact(box, center);
+    contact.depth += radius;
+    return true;
+}
+
+float exitDistance(const JEColliderSet& colliders, size_t index, glm::vec3 point, glm::vec3 direction) {
+    if (!testPointCollider(colliders, index, point)) return 0;
+    JEBox box = getBox(colliders, index);
+    glm::vec3 d = point - box.center;
+    // Leaving any one slab is leaving the box, so it's the nearest face in the direction of travel
+    float exit = INFINITY;
+    for (int axis = 0; axis < 3; axis++) {
+        float speed = glm::dot(box.axes[axis], direction);
+        if (speed == 0) continue;
+        float local = glm::dot(box.axes[axis], d);
+        exit = std::min(exit, ((speed > 0 ? box.half[axis] : -box.half[axis]) - local) / speed);
+    }
+    return exit;
+}
+
+bool pointHitsAnyCollider(const JEColliderSet& colliders, glm::vec3 point) {
+    for (size_t batch = 0; batch < colliders.batchCount(); batch++) {
+        if (testPointBatch(colliders, batch, point)) return true;
+    }
+    return false;
+}
+
+bool sphereHitsAnyCollider(const JEColliderSet& colliders, glm::vec3 center, float radius) {
+    for (size_t batch = 0; batch < colliders.batchCount(); batch++) {
+        if (testSphereBatch(colliders, batch, center, radius)) return true;
+    }
+    return false;
+}
+
+uint32_t sweepBatch(const JEColliderSet& colliders, size_t batch, glm::vec3 origin, glm::vec3 motion, float radius, float* times) {
+    uint32_t bits = 0;
+    JELanes zero = lanesSet(0), one = lanesSet(1), grow = lanesSet(radius);
+    for (size_t lane = 0; lane < JE_COLLIDER_BATCH; lane += JE_LANES) {
+        size_t i = batch * JE_COLLIDER_BATCH + lane;
+        JELocalPoint start = toColliderSpace(colliders, i, origin);
+        JELocalPoint move = toColliderDirection(colliders, i, motion);
+        const JELanes starts[3] = {start.x, start.y, start.z};
+        const JELanes moves[3] = {move.x, move.y, move.z};
+        const float* halves[3] = {&colliders.halfX[i], &colliders.halfY[i], &colliders.halfZ[i]};
+        // Slabs: it's inside the box between the latest time it enters one and the earliest it leaves one.
+        // Not moving along an axis divides to +-infinity, which is always or never inside that slab like it should be.
+        JELanes enter = lanesSet(-INFINITY), leave = lanesSet(INFINITY);
+        for (int axis = 0; axis < 3; axis++) {
+            JELanes half = lanesAdd(lanesLoad(halves[axis]), grow);
+            JELanes low = lanesDiv(lanesSub(lanesSub(zero, half), starts[axis]), moves[axis]);
+            JELanes high = lanesDiv(lanesSub(half, starts[axis]), moves[axis]);
+            enter = lanesMax(enter, lanesMin(low, high));
+            leave = lanesMin(leave, lanesMax(low, high));
+        }
+        JELaneMask hit = lanesAnd(lanesAnd(lanesLess(enter, leave), lanesLess(zero, leave)), lanesLess(enter, one));
+        lanesStore(times + lane, lanesMax(enter, zero));
+        bits |= lanesBits(hit) << lane;
+    }
+    return bits & realColliderBits(colliders, batch);
+}
+
+// Which face a sweep went in through, the slab it entered last
+glm::vec3 sweepNormal(const JEBox& box, glm::vec3 origin, glm::vec3 motion, float radius) {
+    glm::vec3 d = origin - box.center;
+    float latest = -INFINITY;
+    glm::vec3 normal = minimumAxisContact(box, origin).normal; // Started inside, just take the nearest way out
+    for (int axis = 0; axis < 3; axis++) {
+        float speed = glm::dot(box.axes[axis], motion);
+        if (speed == 0) continue;
+        float half = box.half[axis] + radius;
+        float enter = ((speed > 0 ? -half : half) - glm::dot(box.axes[axis], d)) / speed;
+        if (enter >= 0 && enter > latest) {
+            latest = enter;
+            normal = box.axes[axis] * (speed > 0 ? -1.0f : 1.0f);
+        }
+    }
+    return normal;
+}
+
+void sweepColliders(const JEColliderSet& colliders, std::span<const glm::vec3> origins, std::span<const glm::vec3> motions,
+                    std::span<const float> radii, std::span<JESweepHit> hits) {
+    float times[JE_COLLIDER_BATCH];
+    for (size_t s = 0; s < origins.size(); s++) {
+        JESweepHit& hit = hits[s];
+        hit = JESweepHit{};
+        for (size_t batch = 0; batch < colliders.batchCount(); batch++) {
+            uint32_t bits = sweepBatch(colliders, batch, origins[s], motions[s], radii[s], times);
+            while (bits) {
+                int lane = std::countr_zero(bits);
+                bits &= bits - 1;
+                if (times[lane] < hit.time) {
+                    hit.time = times[lane];
+                    hit.collider = batch * JE_COLLIDER_BATCH + lane;
+                }
+            }
+        }
+        if (hit.time <= 1) hit.normal = sweepNormal(getBox(colliders, hit.collider), origins[s], motions[s], radii[s]);
+    }
+}
+
+// Same test as sweepBatch for a single box
+bool sweepBox(const JEBox& box, glm::vec3 origin, glm::vec3 motion, float radius, float& time) {
+    glm::vec3 d = origin - box.center;
+    float enter = -INFINITY, leave = INFINITY;
+    for (int axis = 0; axis < 3; axis++) {
+        float start = glm::dot(box.axes[axis], d);
+        float speed = glm::dot(box.axes[axis], motion);
+        float half = box.half[axis] + radius;
+        if (speed == 0) {
+            if (!(std::abs(start) < half)) return false;
+            continue;
+        }
+        float low = (-half - start) / speed, high = (half - start) / speed;
+        enter = std::max(enter, std::min(low, high));
+        leave = std::min(leave, std::max(low, high));
+    }
+    if (!(enter < leave && leave > 0 && enter < 1)) return false;
+    time = std::max(enter, 0.0f);
+    return true;
+}
+
+JEBox boxFromTransform(const Transform& transform) {
+    mat4 rotate = transform.getRotateMatrix();
+    JEBox box{transform.position, {}, {std::abs(transform.scale.x), std::abs(transform.scale.y), std::abs(transform.scale.z)}};
+    for (int axis = 0; axis < 3; axis++) box.axes[axis] = glm::vec3(rotate[axis]);
+    return box;
+}
+
+// Separating axis test between two boxes, the 3 face axes of each and the 9 edge pairs. Touching doesn't count.
+bool boxesOverlap(const JEBox& a, const JEBox& b) {
+    float rotation[3][3], absRotation[3][3];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            rotation[i][j] = glm::dot(a.axes[i], b.axes[j]);
+            // Nudged so parallel edges, whose cross product is zero, don't make a fake separating axis
+            absRotation[i][j] = std::abs(rotation[i][j]) + 1e-6f;
+        }
+    }
+    glm::vec3 d = b.center - a.center;
+    float t[3] = {glm::dot(d, a.axes[0]), glm::dot(d, a.axes[1]), glm::dot(d, a.axes[2])};
+
+    for (int i = 0; i < 3; i++) {
+        float reach = b.half[0] * absRotation[i][0] + b.half[1] * absRotation[i][1] + b.half[2] * absRotation[i][2];
+        if (std::abs(t[i]) >= a.half[i] + reach) return false;
+    }
+    for (int j = 0; j < 3; j++) {
+        float reach = a.half[0] * absRotation[0][j] + a.half[1] * absRotation[1][j] + a.half[2] * absRotation[2][j];
+        if (std::abs(t[0] * rotation[0][j] + t[1] * rotation[1][j] + t[2] * rotation[2][j]) >= b.half[j] + reach) return false;
+    }
+    for (int i = 0; i < 3; i++) {
+        int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+        for (int j = 0; j < 3; j++) {
+            int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+            float reachA = a.half[i1] * absRotation[i2][j] + a.half[i2] * absRotation[i1][j];
+            float reachB = b.half[j1] * absRotation[i][j2] + b.half[j2] * absRotation[i][j1];
+            if (std::abs(t[i2] * rotation[i1][j] - t[i1] * rotation[i2][j]) >= reachA + reachB) return false;
+        }
+    }
+    return true;
+}
+
+JESweepHit sweepSphere(const JEColliderSet& colliders, const JESweep& sweep) {
+    JESweepHit hit;
+    glm::vec3 inverseMotion = 1.0f / sweep.motion;
+    // Boxes get grown by radius along their own axes, so a tilted one's corners stick out up to radius * sqrt(3)
+    glm::vec3 grow(sweep.radius * 1.7320508f);
+    traverseBVH(colliders.bvh, [&](glm::vec3 min, glm::vec3 max) {
+        // Anything past the closest hit so far can't be closer
+        return rayHitsBounds(sweep.origin, inverseMotion, std::min(hit.time, 1.0f), min - grow, max + grow);
+    }, [&](uint32_t collider) {
+        float time;
+        if (sweepBox(getBox(colliders, collider), sweep.origin, sweep.motion, sweep.radius, time) && time < hit.time) {
+            hit.time = time;
+            hit.collider = collider;
+        }
+        return true;
+    });
+    if (hit.time <= 1) hit.normal = sweepNormal(getBox(colliders, hit.collider), sweep.origin, sweep.motion, sweep.radius);
+    return hit;
+}
+
+bool hasLineOfSight(const JEColliderSet& colliders, glm::vec3 from, glm::vec3 to) {
+    glm::vec3 motion = to - from;
+    glm::vec3 inverseMotion = 1.0f / motion;
+    bool blocked = false;
+    traverseBVH(colliders.bvh, [&](glm::vec3 min, glm::vec3 max) {
+        return rayHitsBounds(from, inverseMotion, 1, min, max);
+    }, [&](uint32_t collider) {
+        // Anything at all in the way will do
+        float time;
+        blocked = sweepBox(getBox(colliders, collider), from, motion, 0, time);
+        return !blocked;
+    });
+    return !blocked;
+}
+
+void overlapSphere(const JEColliderSet& colliders, glm::vec3 center, float radius, std::vector<uint32_t>& found) {
+    found.clear();
+    traverseBVH(colliders.bvh, [&](glm::vec3 min, glm::vec3 max) {
+        glm::vec3 away = center - glm::clamp(center, min, max);
+        return glm::dot(away, away) < radius * radius;
+    }, [&](uint32_t collider) {
+        JEContact contact{};
+        if (sphereContact(colliders, collider, center, radius, contact)) found.push_back(collider);
+        return true;
+    });
+}
+
+void overlapBox(const JEColliderSet& colliders, const Transform& box, std::vector<uint32_t>& found) {
+    found.clear();
+    JEBox query = boxFromTransform(box);
+    glm::vec3 reach = glm::abs(query.axes[0]) * query.half[0] + glm::abs(query.axes[1]) * query.half[1] + glm::abs(query.axes[2]) * query.half[2];
+    glm::vec3 queryMin = query.center - reach, queryMax = query.center + reach;
+    traverseBVH(colliders.bvh, [&](glm::vec3 min, glm::vec3 max) {
+        return queryMin.x < max.x && queryMax.x > min.x && queryMin.y < max.y && queryMax.y > min.y && queryMin.z < max.z && queryMax.z > min.z;
+    }, [&](uint32_t collider) {
+        if (boxesOverlap(query, getBox(colliders, collider))) found.push_back(collider);
+        return true;
+    });
+}
+
+void sweepSpheres(const JEColliderSet& colliders, std::span<const JESweep> sweeps, std::span<JESweepHit> hits) {
+    parallelFor(sweeps.size(), [&](size_t i) {
+        hits[i] = sweepSphere(colliders, sweeps[i]);
+    });
+}
+
+void overlapSpheres(const JEColliderSet& colliders, std::span<const glm::vec3> centers, std::span<const float> radii,
+                    std::span<std::vector<uint32_t>> found) {
+    parallelFor(centers.size(), [&](size_t i) {
+        overlapSphere(colliders, centers[i], radii[i], found[i]);
+    });
+}
+
+void overlapBoxes(const JEColliderSet& colliders, std::span<const Transform> boxes, std::span<std::vector<uint32_t>> found) {
+    parallelFor(boxes.size(), [&](size_t i) {
+        overlapBox(colliders, boxes[i], found[i]);
+    });
+}
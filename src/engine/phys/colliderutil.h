@@ -0,0 +1,138 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#ifndef JOSHENGINE_COLLIDERUTIL_H
+#define JOSHENGINE_COLLIDERUTIL_H
+
+#include "bvhutil.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <span>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+class Transform;
+
+// Colliders get tested this many at a time (one AVX2 register, two SSE ones), and sets are padded out to a multiple of it.
+#define JE_COLLIDER_BATCH 8
+
+// Static oriented boxes, baked once when a map loads instead of building a rotation matrix for every test.
+// Structure of arrays, so a batch is one load per field. Indices match the Transforms it was baked from.
+struct JEColliderSet {
+    size_t count = 0; // Real boxes, the padding after them never hits anything
+    std::vector<float> centerX, centerY, centerZ;
+    std::vector<float> halfX, halfY, halfZ;
+    // World to box space, row major: local.x = rotation[0]*d.x + rotation[1]*d.y + rotation[2]*d.z and so on
+    std::vector<float> rotation[9];
+    JEBVH bvh; // Over the real boxes, for queries that only want the ones near them
+
+    [[nodiscard]] size_t batchCount() const { return centerX.size() / JE_COLLIDER_BATCH; }
+};
+
+/**
+ * Bake box colliders. Same boxes testPoint uses: centered on position, rotated by rotation, scale is the half size.
+ */
+JEColliderSet bakeColliders(const std::vector<Transform>& boxes);
+/**
+ * Test a point against one batch of colliders.
+ * @param batch Colliders batch * JE_COLLIDER_BATCH and the JE_COLLIDER_BATCH after it
+ * @return Bit i is set if the point is inside collider batch * JE_COLLIDER_BATCH + i
+ */
+uint32_t testPointBatch(const JEColliderSet& colliders, size_t batch, glm::vec3 point);
+/**
+ * Test a sphere against one batch of colliders, same as testPointBatch. Touching doesn't count.
+ */
+uint32_t testSphereBatch(const JEColliderSet& colliders, size_t batch, glm::vec3 center, float radius);
+/**
+ * Test a point against a single collider. For when only one box matters, otherwise use the batches.
+ */
+bool testPointCollider(const JEColliderSet& colliders, size_t index, glm::vec3 point);
+// Which way is out of a collider, and how far.
+struct JEContact {
+    glm::vec3 normal; // World space, pointing out of the box
+    float depth;      // Move this far along normal to be out
+};
+
+/**
+ * Contact for a point inside a box: out through whichever face it's closest to (minimum axis separation).
+ * @return false (contact left alone) if the point isn't inside
+ */
+bool pointContact(const JEColliderSet& colliders, size_t index, glm::vec3 point, JEContact& contact);
+/**
+ * Contact for a sphere overlapping a box: away from the closest point on the box, or pointContact if the center's inside.
+ * @return false (contact left alone) if they don't overlap
+ */
+bool sphereContact(const JEColliderSet& colliders, size_t index, glm::vec3 center, float radius, JEContact& contact);
+/**
+ * @return Closest point on (or in) a box to point
+ */
+glm::vec3 closestPointOnCollider(const JEColliderSet& colliders, size_t index, glm::vec3 point);
+/**
+ * How far a point has to go in a given direction to get out of a box, e.g. straight up for snapping onto things.
+ * @param direction Normalized
+ * @return 0 if it's already out
+ */
+float exitDistance(const JEColliderSet& colliders, size_t index, glm::vec3 point, glm::vec3 direction);
+// Where a sweep first hit something.
+struct JESweepHit {
+    float time = INFINITY; // How much of the motion it got through first, 0 to 1. INFINITY if it didn't hit.
+    glm::vec3 normal{};    // Face it hit, world space
+    size_t collider = 0;
+};
+
+/**
+ * Sweep a sphere against one batch of colliders. Treated as the box grown by radius, square corners and all, so it can
+ * hit a hair early going past an edge. Radius 0 is a ray. Starting inside a box hits at time 0.
+ * @param motion Where it goes this tick, time 1 is origin + motion
+ * @param times Filled with JE_COLLIDER_BATCH hit times, only meaningful where the bit is set
+ * @return Bit i is set if it hits collider batch * JE_COLLIDER_BATCH + i during the motion
+ */
+uint32_t sweepBatch(const JEColliderSet& colliders, size_t batch, glm::vec3 origin, glm::vec3 motion, float radius, float* times);
+/**
+ * Sweep a lot of spheres (e.g. every bullet this tick) through the colliders in one go, see sweepBatch.
+ * @param hits Same length as origins, each gets the first thing it hits
+ */
+void sweepColliders(const JEColliderSet& colliders, std::span<const glm::vec3> origins, std::span<const glm::vec3> motions,
+                    std::span<const float> radii, std::span<JESweepHit> hits);
+
+// A sphere moving through the world, radius 0 for a ray. Time 1 is origin + motion.
+struct JESweep {
+    glm::vec3 origin;
+    glm::vec3 motion;
+    float radius = 0;
+};
+
+// sweepColliders and friends test every box, which is quickest for lots of short sweeps through a small map.
+// These go through the BVH instead, so they only look at boxes near them. Good for long rays and big maps.
+
+/**
+ * First box a sphere hits along its motion, same rules as sweepBatch.
+ */
+JESweepHit sweepSphere(const JEColliderSet& colliders, const JESweep& sweep);
+/**
+ * @return Whether nothing's in the way between from and to. Stops at the first thing in the way.
+ */
+bool hasLineOfSight(const JEColliderSet& colliders, glm::vec3 from, glm::vec3 to);
+/**
+ * Every box a sphere overlaps. Touching doesn't count.
+ * @param found Cleared first, then filled with collider indices
+ */
+void overlapSphere(const JEColliderSet& colliders, glm::vec3 center, float radius, std::vector<uint32_t>& found);
+/**
+ * Every box another box (same as the ones baked, scale is the half size) overlaps. Touching doesn't count.
+ * @param found Cleared first, then filled with collider indices
+ */
+void overlapBox(const JEColliderSet& colliders, const Transform& box, std::vector<uint32_t>& found);
+/**
+ * Batched versions of the above, spread across the job workers. Outputs line up with the queries.
+ */
+void sweepSpheres(const JEColliderSet& colliders, std::span<const JESweep> sweeps, std::span<JESweepHit> hits);
+void overlapSpheres(const JEColliderSet& colliders, std::span<const glm::vec3> centers, std::span<const float> radii,
+                    std::span<std::vector<uint32_t>> found);
+void overlapBoxes(const JEColliderSet& colliders, std::span<const Transform> boxes, std::span<std::vector<uint32_t>> found);
+[[nodiscard]] bool pointHitsAnyCollider(const JEColliderSet& colliders, glm::vec3 point);
+[[nodiscard]] bool sphereHitsAnyCollider(const JEColliderSet& colliders, glm::vec3 center, float radius);
+
+#endif //JOSHENGINE_COLLIDERUTIL_H
@@ -0,0 +1,132 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#include "flowfieldutil.h"
+#include "../job/jobutil.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// Biggest grid buildFlowField will make. Way past any map so far, it's there to catch a bad cell size.
+#define JE_FLOW_FIELD_MAX_CELLS (1 << 24)
+
+struct JEFlowNeighbours {
+    int offsets[26][3];
+    glm::vec3 directions[26]; // Normalized offsets
+    uint8_t opposites[26];    // Neighbour that undoes each one, for pointing back the way the search came from
+
+    JEFlowNeighbours() {
+        // Faces, then edges, then corners, so a search that can go straight does
+        int count = 0;
+        for (int axes = 1; axes <= 3; axes++) {
+            for (int dz = -1; dz <= 1; dz++) {
+                for (int dy = -1; dy <= 1; dy++) {
+                    for (int dx = -1; dx <= 1; dx++) {
+                        if (std::abs(dx) + std::abs(dy) + std::abs(dz) != axes) continue;
+                        offsets[count][0] = dx;
+                        offsets[count][1] = dy;
+                        offsets[count][2] = dz;
+                        directions[count] = glm::normalize(glm::vec3(static_cast<float>(dx), static_cast<float>(dy), static_cast<float>(dz)));
+                        count++;
+                    }
+                }
+            }
+        }
+        for (int neighbour = 0; neighbour < 26; neighbour++) {
+            for (int other = 0; other < 26; other++) {
+                if (offsets[other][0] == -offsets[neighbour][0] && offsets[other][1] == -offsets[neighbour][1] &&
+                    offsets[other][2] == -offsets[neighbour][2]) opposites[neighbour] = static_cast<uint8_t>(other);
+            }
+        }
+    }
+};
+const JEFlowNeighbours flowNeighbours;
+
+JEFlowField buildFlowField(const JEColliderSet& colliders, glm::vec3 min, glm::vec3 max, float cellSize, float clearance) {
+    JEFlowField field;
+    field.origin = min;
+    field.cellSize = cellSize;
+    glm::vec3 size = glm::max(max - min, glm::vec3(0.0f)) / cellSize;
+    field.width = std::max(static_cast<int>(std::ceil(size.x)), 1);
+    field.height = std::max(static_cast<int>(std::ceil(size.y)), 1);
+    field.depth = std::max(static_cast<int>(std::ceil(size.z)), 1);
+    size_t cells = static_cast<size_t>(field.width) * field.height * field.depth;
+    if (cells > JE_FLOW_FIELD_MAX_CELLS) throw std::runtime_error("Flow field would have too many cells!");
+
+    field.blocked.resize(cells);
+    // A slice at a time across the workers, each cell's one sphere test against the colliders
+    parallelFor(field.depth, [&](size_t z) {
+        for (int y = 0; y < field.height; y++) {
+            for (int x = 0; x < field.width; x++) {
+                glm::vec3 center = min + (glm::vec3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)) + 0.5f) * cellSize;
+                field.blocked[x + field.width * (y + field.height * z)] = sphereHitsAnyCollider(colliders, center, clearance);
+            }
+        }
+    }, 1);
+    field.flow.assign(cells, JE_FLOW_NONE);
+    field.nextFlow.assign(cells, JE_FLOW_NONE);
+    field.queue.reserve(cells);
+    return field;
+}
+
+int64_t flowFieldCell(const JEFlowField& field, glm::vec3 point) {
+    glm::vec3 cell = glm::floor((point - field.origin) / field.cellSize);
+    // Compared as floats so something miles away can't overflow the int
+    if (cell.x < 0 || cell.y < 0 || cell.z < 0 ||
+        cell.x >= static_cast<float>(field.width) || cell.y >= static_cast<float>(field.height) || cell.z >= static_cast<float>(field.depth)) return -1;
+    return static_cast<int64_t>(cell.x) + field.width * (static_cast<int64_t>(cell.y) + field.height * static_cast<int64_t>(cell.z));
+}
+
+void setFlowFieldTarget(JEFlowField& field, glm::vec3 target) {
+    int64_t cell = flowFieldCell(field, target);
+    // Already there or already on its way there
+    if (cell == (field.searching() ? field.nextTarget : field.target)) return;
+    field.nextTarget = cell;
+    field.queue.clear();
+    field.queueHead = 0;
+    std::fill(field.nextFlow.begin(), field.nextFlow.end(), JE_FLOW_NONE);
+    if (cell < 0) {
+        // Target left the grid, nothing leads anywhere until it comes back
+        std::fill(field.flow.begin(), field.flow.end(), JE_FLOW_NONE);
+        field.target = -1;
+        return;
+    }
+    // Starts from the target even if it's blocked, it's probably just standing close to a wall
+    field.nextFlow[cell] = JE_FLOW_HERE;
+    field.queue.push_back(static_cast<uint32_t>(cell));
+}
+
+bool stepFlowField(JEFlowField& field, size_t maxCells) {
+    if (!field.searching()) return false;
+    for (size_t searched = 0; searched < maxCells && field.searching(); searched++) {
+        uint32_t cell = field.queue[field.queueHead++];
+        int x = static_cast<int>(cell % field.width);
+        int y = static_cast<int>(cell / field.width % field.height);
+        int z = static_cast<int>(cell / field.width / field.height);
+        for (int neighbour = 0; neighbour < 26; neighbour++) {
+            const int* offset = flowNeighbours.offsets[neighbour];
+            int nx = x + offset[0], ny = y + offset[1], nz = z + offset[2];
+            if (nx < 0 || ny < 0 || nz < 0 || nx >= field.width || ny >= field.height || nz >= field.depth) continue;
+            uint32_t next = nx + field.width * (ny + field.height * nz);
+            if (field.nextFlow[next] != JE_FLOW_NONE) continue;
+            // Found from here, so heading back here is one step closer. Blocked ones get told how to get out but aren't
+            // searched from, nothing gets through a wall.
+            field.nextFlow[next] = flowNeighbours.opposites[neighbour];
+            if (!field.blocked[next]) field.queue.push_back(next);
+        }
+    }
+    if (field.searching()) return false;
+    std::swap(field.flow, field.nextFlow);
+    field.target = field.nextTarget;
+    return true;
+}
+
+bool sampleFlowField(const JEFlowField& field, glm::vec3 point, glm::vec3& direction) {
+    int64_t cell = flowFieldCell(field, point);
+    if (cell < 0) return false;
+    uint8_t flow = field.flow[cell];
+    if (flow >= JE_FLOW_HERE) return false;
+    direction = flowNeighbours.directions[flow];
+    return true;
+}
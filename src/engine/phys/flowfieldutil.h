@@ -0,0 +1,69 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#ifndef JOSHENGINE_FLOWFIELDUTIL_H
+#define JOSHENGINE_FLOWFIELDUTIL_H
+
+#include "colliderutil.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+// Flow value for cells with no way to the target (or not worked out yet)
+#define JE_FLOW_NONE 0xFF
+// Flow value for the target's own cell, already there
+#define JE_FLOW_HERE 26
+
+// 3D grid over a map, each cell saying which of its 26 neighbours is next on the shortest way to one target. Everything
+// heading for the same place (e.g. a wave of enemies chasing the player) shares one search instead of pathing separately.
+// The search is spread over ticks: a new target starts filling nextFlow, and flow only gets swapped over once it's done,
+// so flow is always a whole field, just a few ticks behind.
+struct JEFlowField {
+    glm::vec3 origin{}; // Min corner of cell 0
+    float cellSize = 1;
+    int width = 0, height = 0, depth = 0; // Cells along x, y, z. Cell index is x + width * (y + height * z).
+    std::vector<uint8_t> blocked;         // 1 where something's in the way
+    std::vector<uint8_t> flow;            // Neighbour to head for, JE_FLOW_NONE or JE_FLOW_HERE
+    int64_t target = -1;                  // Cell flow leads to, -1 before the first search finishes
+
+    // The search in progress, breadth first
+    std::vector<uint8_t> nextFlow;
+    std::vector<uint32_t> queue;
+    size_t queueHead = 0;
+    int64_t nextTarget = -1;
+
+    [[nodiscard]] size_t cellCount() const { return blocked.size(); }
+    [[nodiscard]] bool searching() const { return queueHead < queue.size(); }
+};
+
+/**
+ * Rasterize colliders into a flow field with no target yet.
+ * @param min Corner of the area it covers, anything outside never gets a flow
+ * @param max Other corner
+ * @param clearance A cell's blocked if a sphere this big at its center hits a collider. At least half a cell's diagonal
+ * keeps straight moves between free cells from clipping corners.
+ */
+JEFlowField buildFlowField(const JEColliderSet& colliders, glm::vec3 min, glm::vec3 max, float cellSize, float clearance);
+/**
+ * @return Cell a point is in, -1 if it's outside the grid
+ */
+int64_t flowFieldCell(const JEFlowField& field, glm::vec3 point);
+/**
+ * Point the field somewhere new. Only starts a search if that's a different cell than last time, so calling it every
+ * tick with something that moves is fine.
+ */
+void setFlowFieldTarget(JEFlowField& field, glm::vec3 target);
+/**
+ * Keep searching for at most this many cells, swapping the result in if it finishes.
+ * @return Whether a new field got swapped in
+ */
+bool stepFlowField(JEFlowField& field, size_t maxCells);
+/**
+ * Which way to go from a point. Blocked cells next to open ones point back out into the open.
+ * @param direction Set to the normalized way to the next cell, left alone if this returns false
+ * @return false if the point's outside the grid, already in the target's cell or has no way there
+ */
+bool sampleFlowField(const JEFlowField& field, glm::vec3 point, glm::vec3& direction);
+
+#endif //JOSHENGINE_FLOWFIELDUTIL_H
@@ -0,0 +1,389 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#include "meshcolliderutil.h"
+#include "../engine.h"
+#include "../jbd/bundleutil.h"
+#include "../job/jobutil.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+// Moves a model space vertex to where the renderer would draw it: scale, rotate, then translate
+glm::vec3 toWorld(const Transform& transform, const mat4& rotate, glm::vec3 vertex) {
+    return transform.position + glm::vec3(rotate * glm::vec4(vertex * transform.scale, 1.0f));
+}
+
+// Triangle bounds for the BVH, once every vertex is in
+void buildTriangleBVH(JEMeshCollider& mesh) {
+    std::vector<glm::vec3> mins(mesh.triangleCount()), maxs(mesh.triangleCount());
+    for (size_t t = 0; t < mesh.triangleCount(); t++) {
+        glm::vec3 a = mesh.vertices[mesh.indices[t*3]], b = mesh.vertices[mesh.indices[t*3 + 1]], c = mesh.vertices[mesh.indices[t*3 + 2]];
+        mins[t] = glm::min(a, glm::min(b, c));
+        maxs[t] = glm::max(a, glm::max(b, c));
+    }
+    mesh.bvh = buildBVH(mins, maxs);
+}
+
+JEMeshCollider bakeMeshCollider(const std::vector<Model>& models, const Transform& transform) {
+    JEMeshCollider mesh;
+    mat4 rotate = transform.getRotateMatrix();
+    for (const Model& model : models) {
+        auto base = static_cast<uint32_t>(mesh.vertices.size());
+        for (size_t i = 0; i < model.vertices.size() / 3; i++) {
+            mesh.vertices.push_back(toWorld(transform, rotate, glm::vec3(model.vertices[i*3], model.vertices[i*3 + 1], model.vertices[i*3 + 2])));
+        }
+        for (unsigned int index : model.indices) mesh.indices.push_back(base + index);
+    }
+    buildTriangleBVH(mesh);
+    return mesh;
+}
+
+JEMeshCollider bakeCookedMeshCollider(const JECookedMesh& cooked, const Transform& transform) {
+    JEMeshCollider mesh;
+    mat4 rotate = transform.getRotateMatrix();
+    const JECookedMeshHeader& header = cooked.header;
+    glm::vec3 boundsMin(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+    glm::vec3 boundsSize = glm::vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]) - boundsMin;
+    mesh.vertices.resize(header.vertexCount);
+    for (size_t i = 0; i < header.vertexCount; i++) {
+        const std::byte* vertex = cooked.vertices.data() + i * header.vertexStride;
+        glm::vec3 position;
+        if (header.vertexFormat == JE_VERTEX_COMPACT16) {
+            // Position's the first thing in either layout
+            uint16_t quantized[3];
+            memcpy(quantized, vertex, sizeof(quantized));
+            position = boundsMin + glm::vec3(quantized[0], quantized[1], quantized[2]) / 65535.0f * boundsSize;
+        } else {
+            float floats[3];
+            memcpy(floats, vertex, sizeof(floats));
+            position = glm::vec3(floats[0], floats[1], floats[2]);
+        }
+        mesh.vertices[i] = toWorld(transform, rotate, position);
+    }
+    mesh.indices.resize(header.indexCount);
+    for (size_t i = 0; i < header.indexCount; i++) {
+        if (header.indexSize == sizeof(uint16_t)) {
+            uint16_t index;
+            memcpy(&index, cooked.indices.data() + i * sizeof(uint16_t), sizeof(index));
+            mesh.indices[i] = index;
+        } else {
+            memcpy(&mesh.indices[i], cooked.indices.data() + i * sizeof(uint32_t), sizeof(uint32_t));
+        }
+    }
+    buildTriangleBVH(mesh);
+    return mesh;
+}
+
+JEMeshCollider loadMeshCollider(const std::string& path, const Transform& transform, const std::string& bundleFileName) {
+    try {
+        std::vector<std::byte> storage;
+        std::span<const std::byte> file = getBundledFile(path, bundleFileName, storage);
+        if (isCookedMesh(file)) return bakeCookedMeshCollider(parseCookedMesh(file), transform);
+        return bakeMeshCollider(parseObj(file), transform);
+    } catch (std::exception &e) {
+        std::cerr << "Failed to load mesh collider \"" << path << "\"! " << e.what() << " It won't collide with anything." << std::endl;
+        return {};
+    }
+}
+
+JEMeshColliderLoad loadMeshColliderAsync(const std::string& path, const Transform& transform, const std::string& bundleFileName) {
+    // loadMeshCollider never throws, so the promise always gets its value
+    auto baked = std::make_shared<std::promise<JEMeshCollider>>();
+    JEMeshColliderLoad load = baked->get_future().share();
+    submitJob([baked, path, transform, bundleFileName]() {
+        baked->set_value(loadMeshCollider(path, transform, bundleFileName));
+    });
+    return load;
+}
+
+const JEMeshCollider* finishedMeshCollider(const JEMeshColliderLoad& load) {
+    if (!load.valid() || load.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return nullptr;
+    return &load.get();
+}
+
+// Ericson, Real-Time Collision Detection 5.1.5. Works out which region of the triangle the point is over.
+glm::vec3 closestPointOnTriangle(glm::vec3 p, glm::vec3 a, glm::vec3 b, glm::vec3 c) {
+    glm::vec3 ab = b - a, ac = c - a, ap = p - a;
+    float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+    if (d1 <= 0 && d2 <= 0) return a;
+    glm::vec3 bp = p - b;
+    float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+    if (d3 >= 0 && d4 <= d3) return b;
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0 && d1 >= 0 && d3 <= 0) return a + ab * (d1 / (d1 - d3));
+    glm::vec3 cp = p - c;
+    float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+    if (d6 >= 0 && d5 <= d6) return c;
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0 && d2 >= 0 && d6 <= 0) return a + ac * (d2 / (d2 - d6));
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    float denominator = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denominator) + ac * (vc * denominator);
+}
+
+// Whether a point in the triangle's plane is inside it (edges count). Barycentric signs, so nothing depends on how
+// big the triangle is or how far it is from the origin.
+bool pointInTriangle(glm::vec3 p, glm::vec3 a, glm::vec3 b, glm::vec3 c) {
+    glm::vec3 normal = glm::cross(b - a, c - a);
+    return glm::dot(glm::cross(b - a, p - a), normal) >= 0 &&
+           glm::dot(glm::cross(c - b, p - b), normal) >= 0 &&
+           glm::dot(glm::cross(a - c, p - c), normal) >= 0;
+}
+
+// Ericson 5.1.9, closest points between segments p1-q1 and p2-q2
+void closestPointsOnSegments(glm::vec3 p1, glm::vec3 q1, glm::vec3 p2, glm::vec3 q2, glm::vec3& on1, glm::vec3& on2) {
+    glm::vec3 d1 = q1 - p1, d2 = q2 - p2, r = p1 - p2;
+    float a = glm::dot(d1, d1), e = glm::dot(d2, d2), f = glm::dot(d2, r);
+    float s = 0, t = 0;
+    if (a <= 1e-12f && e <= 1e-12f) {
+        on1 = p1;
+        on2 = p2;
+        return;
+    }
+    if (a <= 1e-12f) {
+        t = std::clamp(f / e, 0.0f, 1.0f);
+    } else {
+        float c = glm::dot(d1, r);
+        if (e <= 1e-12f) {
+            s = std::clamp(-c / a, 0.0f, 1.0f);
+        } else {
+            float b = glm::dot(d1, d2), denominator = a * e - b * b;
+            s = denominator != 0 ? std::clamp((b * f - c * e) / denominator, 0.0f, 1.0f) : 0.0f;
+            t = (b * s + f) / e;
+            if (t < 0) {
+                t = 0;
+                s = std::clamp(-c / a, 0.0f, 1.0f);
+            } else if (t > 1) {
+                t = 1;
+                s = std::clamp((b - c) / a, 0.0f, 1.0f);
+            }
+        }
+    }
+    on1 = p1 + d1 * s;
+    on2 = p2 + d2 * t;
+}
+
+// Closest points between a segment and a triangle. Either it goes through the triangle, or the closest pair involves
+// one of its ends or one of the triangle's edges.
+void closestPointsSegmentTriangle(glm::vec3 p, glm::vec3 q, glm::vec3 a, glm::vec3 b, glm::vec3 c, glm::vec3& onSegment, glm::vec3& onTriangle) {
+    glm::vec3 normal = glm::cross(b - a, c - a);
+    float dp = glm::dot(p - a, normal), dq = glm::dot(q - a, normal);
+    if ((dp <= 0 && dq >= 0) || (dp >= 0 && dq <= 0)) {
+        if (dp != dq) {
+            glm::vec3 crossing = p + (q - p) * (dp / (dp - dq));
+            if (pointInTriangle(crossing, a, b, c)) {
+                onSegment = onTriangle = crossing;
+                return;
+            }
+        }
+    }
+    float best = INFINITY;
+    auto consider = [&](glm::vec3 segmentPoint, glm::vec3 trianglePoint) {
+        glm::vec3 d = segmentPoint - trianglePoint;
+        if (glm::dot(d, d) < best) {
+            best = glm::dot(d, d);
+            onSegment = segmentPoint;
+            onTriangle = trianglePoint;
+        }
+    };
+    consider(p, closestPointOnTriangle(p, a, b, c));
+    consider(q, closestPointOnTriangle(q, a, b, c));
+    const glm::vec3 corners[3] = {a, b, c};
+    for (int edge = 0; edge < 3; edge++) {
+        glm::vec3 segmentPoint, edgePoint;
+        closestPointsOnSegments(p, q, corners[edge], corners[(edge + 1) % 3], segmentPoint, edgePoint);
+        consider(segmentPoint, edgePoint);
+    }
+}
+
+// First time in [0, 1] a ray gets within radius of center
+bool rayHitsSphere(glm::vec3 origin, glm::vec3 motion, glm::vec3 center, float radius, float& time) {
+    glm::vec3 m = origin - center;
+    float c = glm::dot(m, m) - radius * radius;
+    if (c < 0) {
+        time = 0;
+        return true;
+    }
+    float a = glm::dot(motion, motion), b = glm::dot(m, motion);
+    if (a == 0 || b >= 0) return false;
+    float discriminant = b * b - a * c;
+    if (discriminant < 0) return false;
+    time = (-b - std::sqrt(discriminant)) / a;
+    return time <= 1;
+}
+
+// First time in [0, 1] a ray gets within radius of the segment from start to end
+bool rayHitsCapsule(glm::vec3 origin, glm::vec3 motion, glm::vec3 start, glm::vec3 end, float radius, float& time) {
+    bool hit = false;
+    float sphereTime;
+    time = INFINITY;
+    if (rayHitsSphere(origin, motion, start, radius, sphereTime)) time = sphereTime, hit = true;
+    if (rayHitsSphere(origin, motion, end, radius, sphereTime) && sphereTime < time) time = sphereTime, hit = true;
+
+    // The round side, as an infinite cylinder that only counts between the ends
+    glm::vec3 axis = end - start;
+    float length2 = glm::dot(axis, axis);
+    if (length2 == 0) return hit;
+    glm::vec3 m = origin - start;
+    glm::vec3 mAcross = m - axis * (glm::dot(m, axis) / length2);
+    glm::vec3 motionAcross = motion - axis * (glm::dot(motion, axis) / length2);
+    float a = glm::dot(motionAcross, motionAcross), b = glm::dot(mAcross, motionAcross);
+    float c = glm::dot(mAcross, mAcross) - radius * radius;
+    float sideTime;
+    if (c < 0) {
+        sideTime = 0;
+    } else {
+        if (a == 0 || b >= 0) return hit;
+        float discriminant = b * b - a * c;
+        if (discriminant < 0) return hit;
+        sideTime = (-b - std::sqrt(discriminant)) / a;
+    }
+    float along = glm::dot(m + motion * sideTime, axis) / length2;
+    if (sideTime <= 1 && along >= 0 && along <= 1 && sideTime < time) {
+        time = sideTime;
+        hit = true;
+    }
+    return hit;
+}
+
+// The way out from a triangle to something touching it, face normal facing against motion if they're right on top of each other
+glm::vec3 contactNormal(glm::vec3 from, glm::vec3 onTriangle, glm::vec3 a, glm::vec3 b, glm::vec3 c, glm::vec3 motion) {
+    glm::vec3 away = from - onTriangle;
+    if (glm::dot(away, away) > 1e-12f) return glm::normalize(away);
+    glm::vec3 normal = glm::normalize(glm::cross(b - a, c - a));
+    return glm::dot(normal, motion) > 0 ? -normal : normal;
+}
+
+bool sweepSphereTriangle(glm::vec3 center, glm::vec3 motion, float radius, glm::vec3 a, glm::vec3 b, glm::vec3 c, float& time, glm::vec3& normal) {
+    glm::vec3 closest = closestPointOnTriangle(center, a, b, c);
+    if (glm::dot(center - closest, center - closest) < radius * radius) {
+        time = 0;
+        normal = contactNormal(center, closest, a, b, c, motion);
+        return true;
+    }
+    time = INFINITY;
+    // Face: when the sphere's near side reaches the plane, if that's inside the triangle
+    glm::vec3 faceNormal = glm::cross(b - a, c - a);
+    if (glm::dot(faceNormal, faceNormal) > 0) {
+        faceNormal = glm::normalize(faceNormal);
+        float distance = glm::dot(center - a, faceNormal);
+        if (distance < 0) {
+            faceNormal = -faceNormal;
+            distance = -distance;
+        }
+        float speed = glm::dot(motion, faceNormal);
+        if (speed < 0 && distance >= radius) {
+            float faceTime = (radius - distance) / speed;
+            glm::vec3 touch = center + motion * faceTime - faceNormal * radius;
+            if (faceTime <= 1 && pointInTriangle(touch, a, b, c)) {
+                time = faceTime;
+                normal = faceNormal;
+            }
+        }
+    }
+    // Edges and corners: the center against a capsule around each edge
+    const glm::vec3 corners[3] = {a, b, c};
+    bool edgeHit = false;
+    for (int edge = 0; edge < 3; edge++) {
+        float edgeTime;
+        if (rayHitsCapsule(center, motion, corners[edge], corners[(edge + 1) % 3], radius, edgeTime) && edgeTime < time) {
+            time = edgeTime;
+            edgeHit = true;
+        }
+    }
+    if (time > 1) return false;
+    if (edgeHit) {
+        glm::vec3 touching = center + motion * time;
+        normal = contactNormal(touching, closestPointOnTriangle(touching, a, b, c), a, b, c, motion);
+    }
+    return true;
+}
+
+// A capsule's first touch is one of its end spheres hitting the triangle, a triangle corner hitting its side,
+// or a triangle edge crossing its middle line
+bool sweepCapsuleTriangle(glm::vec3 start, glm::vec3 end, float radius, glm::vec3 motion, glm::vec3 a, glm::vec3 b, glm::vec3 c, float& time, glm::vec3& normal) {
+    glm::vec3 onSegment, onTriangle;
+    closestPointsSegmentTriangle(start, end, a, b, c, onSegment, onTriangle);
+    if (glm::dot(onSegment - onTriangle, onSegment - onTriangle) < radius * radius) {
+        time = 0;
+        normal = contactNormal(onSegment, onTriangle, a, b, c, motion);
+        return true;
+    }
+    time = INFINITY;
+    float featureTime;
+    glm::vec3 featureNormal;
+    if (sweepSphereTriangle(start, motion, radius, a, b, c, featureTime, featureNormal) && featureTime < time) time = featureTime;
+    if (sweepSphereTriangle(end, motion, radius, a, b, c, featureTime, featureNormal) && featureTime < time) time = featureTime;
+    const glm::vec3 corners[3] = {a, b, c};
+    for (glm::vec3 corner : corners) {
+        // Corner moving backwards into the capsule is the same as the capsule moving into it
+        if (rayHitsCapsule(corner, -motion, start, end, radius, featureTime) && featureTime < time) time = featureTime;
+    }
+    glm::vec3 axis = end - start;
+    for (int edge = 0; edge < 3; edge++) {
+        glm::vec3 edgeStart = corners[edge], edgeDirection = corners[(edge + 1) % 3] - edgeStart;
+        // Lines' distance along their common normal, which only changes with the part of the motion along it
+        glm::vec3 across = glm::cross(axis, edgeDirection);
+        if (glm::dot(across, across) < 1e-12f) continue; // Parallel, the ends and corners cover it
+        across = glm::normalize(across);
+        float distance = glm::dot(start - edgeStart, across), speed = glm::dot(motion, across);
+        if (std::abs(distance) < radius || distance * speed >= 0) continue;
+        featureTime = ((distance > 0 ? radius : -radius) - distance) / speed;
+        if (featureTime > 1 || featureTime >= time) continue;
+        // Only counts if the lines' closest points are actually on both segments, otherwise it's an end or a corner.
+        // Checked by where they are along each segment rather than how far apart, so it holds up far from the origin.
+        glm::vec3 r = start + motion * featureTime - edgeStart;
+        float aa = glm::dot(axis, axis), ab = glm::dot(axis, edgeDirection), ee = glm::dot(edgeDirection, edgeDirection);
+        float ar = glm::dot(axis, r), er = glm::dot(edgeDirection, r), denominator = aa * ee - ab * ab;
+        float alongAxis = (ab * er - ar * ee) / denominator, alongEdge = (aa * er - ab * ar) / denominator;
+        if (alongAxis >= 0 && alongAxis <= 1 && alongEdge >= 0 && alongEdge <= 1) time = featureTime;
+    }
+    if (time > 1) return false;
+    glm::vec3 moved = motion * time;
+    closestPointsSegmentTriangle(start + moved, end + moved, a, b, c, onSegment, onTriangle);
+    normal = contactNormal(onSegment, onTriangle, a, b, c, motion);
+    return true;
+}
+
+JESweepHit sweepSphereMesh(const JEMeshCollider& mesh, const JESweep& sweep) {
+    JESweepHit hit;
+    glm::vec3 inverseMotion = 1.0f / sweep.motion;
+    glm::vec3 grow(sweep.radius);
+    traverseBVH(mesh.bvh, [&](glm::vec3 min, glm::vec3 max) {
+        return rayHitsBounds(sweep.origin, inverseMotion, std::min(hit.time, 1.0f), min - grow, max + grow);
+    }, [&](uint32_t triangle) {
+        float time;
+        glm::vec3 normal;
+        if (sweepSphereTriangle(sweep.origin, sweep.motion, sweep.radius, mesh.vertices[mesh.indices[triangle*3]],
+                                mesh.vertices[mesh.indices[triangle*3 + 1]], mesh.vertices[mesh.indices[triangle*3 + 2]], time, normal) && time < hit.time) {
+            hit = {time, normal, triangle};
+        }
+        return true;
+    });
+    return hit;
+}
+
+JESweepHit sweepCapsuleMesh(const JEMeshCollider& mesh, glm::vec3 a, glm::vec3 b, float radius, glm::vec3 motion) {
+    JESweepHit hit;
+    glm::vec3 inverseMotion = 1.0f / motion;
+    // Following a as it moves, a node's box grows by however far the rest of the capsule reaches from it
+    glm::vec3 axis = b - a;
+    glm::vec3 growLow = glm::max(axis, glm::vec3(0.0f)) + glm::vec3(radius);
+    glm::vec3 growHigh = -glm::min(axis, glm::vec3(0.0f)) + glm::vec3(radius);
+    traverseBVH(mesh.bvh, [&](glm::vec3 min, glm::vec3 max) {
+        return rayHitsBounds(a, inverseMotion, std::min(hit.time, 1.0f), min - growLow, max + growHigh);
+    }, [&](uint32_t triangle) {
+        float time;
+        glm::vec3 normal;
+        if (sweepCapsuleTriangle(a, b, radius, motion, mesh.vertices[mesh.indices[triangle*3]],
+                                 mesh.vertices[mesh.indices[triangle*3 + 1]], mesh.vertices[mesh.indices[triangle*3 + 2]], time, normal) && time < hit.time) {
+            hit = {time, normal, triangle};
+        }
+        return true;
+    });
+    return hit;
+}
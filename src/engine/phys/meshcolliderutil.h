@@ -0,0 +1,62 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#ifndef JOSHENGINE_MESHCOLLIDERUTIL_H
+#define JOSHENGINE_MESHCOLLIDERUTIL_H
+
+#include "bvhutil.h"
+#include "colliderutil.h"
+#include "../gfx/meshutil.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+#include <future>
+
+class Transform;
+
+// Triangles baked into world space for exact collision against render geometry, with a BVH over them so a query only
+// tests the handful of triangles near it.
+struct JEMeshCollider {
+    std::vector<glm::vec3> vertices;
+    std::vector<uint32_t> indices; // Triangle i is indices[i*3] to indices[i*3 + 2]
+    JEBVH bvh;                     // Items are triangles
+
+    [[nodiscard]] size_t triangleCount() const { return indices.size() / 3; }
+};
+
+// A mesh collider being loaded and baked on a job worker
+typedef std::shared_future<JEMeshCollider> JEMeshColliderLoad;
+
+/**
+ * Bake parsed models into one mesh collider.
+ * @param transform Where it goes in the world, same as the GameObject drawing it
+ */
+JEMeshCollider bakeMeshCollider(const std::vector<Model>& models, const Transform& transform);
+/**
+ * Load an OBJ (or cooked .jmesh) and bake it. Same files loadObjAsync takes.
+ * @return An empty collider that never hits anything if the file couldn't be loaded
+ */
+JEMeshCollider loadMeshCollider(const std::string& path, const Transform& transform, const std::string& bundleFileName = "./obj_bundle.jbd");
+/**
+ * loadMeshCollider on a job worker, returns right away. Parsing and building the BVH for a whole level takes a while.
+ */
+JEMeshColliderLoad loadMeshColliderAsync(const std::string& path, const Transform& transform, const std::string& bundleFileName = "./obj_bundle.jbd");
+/**
+ * Never blocks, so it's fine to check every query.
+ * @return The baked collider, nullptr if it's still loading
+ */
+const JEMeshCollider* finishedMeshCollider(const JEMeshColliderLoad& load);
+/**
+ * First triangle a sphere hits along its motion. Exact, faces, edges and corners. Starting out touching hits at time 0.
+ * @return collider is the triangle it hit
+ */
+JESweepHit sweepSphereMesh(const JEMeshCollider& mesh, const JESweep& sweep);
+/**
+ * First triangle a capsule hits along its motion. Same as sweepSphereMesh, the capsule doesn't rotate.
+ * @param a One end of the capsule's middle line
+ * @param b The other end
+ */
+JESweepHit sweepCapsuleMesh(const JEMeshCollider& mesh, glm::vec3 a, glm::vec3 b, float radius, glm::vec3 motion);
+
+#endif //JOSHENGINE_MESHCOLLIDERUTIL_H
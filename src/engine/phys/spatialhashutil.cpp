@@ -0,0 +1,78 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#include "spatialhashutil.h"
+#include <cmath>
+#include <algorithm>
+
+struct JECell {
+    int32_t x, y, z;
+};
+
+JECell cellOf(const JESpatialHash& hash, glm::vec3 position) {
+    return {static_cast<int32_t>(std::floor(position.x / hash.cellSize)),
+            static_cast<int32_t>(std::floor(position.y / hash.cellSize)),
+            static_cast<int32_t>(std::floor(position.z / hash.cellSize))};
+}
+
+// Teschner et al. Different cells can land in the same bucket, queries check the actual cell so that's fine.
+uint32_t bucketOf(const JESpatialHash& hash, JECell cell) {
+    uint32_t h = (static_cast<uint32_t>(cell.x) * 73856093u) ^ (static_cast<uint32_t>(cell.y) * 19349663u) ^ (static_cast<uint32_t>(cell.z) * 83492791u);
+    return h & static_cast<uint32_t>(hash.bucketStarts.size() - 2);
+}
+
+void buildSpatialHash(JESpatialHash& hash, std::span<const glm::vec3> positions, std::span<const float> radii, float cellSize) {
+    hash.cellSize = cellSize;
+    hash.positions.assign(positions.begin(), positions.end());
+    hash.radii.assign(radii.begin(), radii.end());
+    hash.maxRadius = 0;
+    for (float r : radii) hash.maxRadius = std::max(hash.maxRadius, r);
+
+    // Power of two at least twice the item count keeps buckets short
+    size_t bucketCount = 16;
+    while (bucketCount < positions.size() * 2) bucketCount *= 2;
+    hash.bucketStarts.assign(bucketCount + 1, 0);
+
+    hash.itemBuckets.resize(positions.size());
+    for (size_t i = 0; i < positions.size(); i++) {
+        hash.itemBuckets[i] = bucketOf(hash, cellOf(hash, positions[i]));
+        hash.bucketStarts[hash.itemBuckets[i] + 1]++;
+    }
+    for (size_t b = 0; b < bucketCount; b++) hash.bucketStarts[b + 1] += hash.bucketStarts[b];
+
+    // Each start doubles as a cursor while filling, which leaves it at its bucket's end (the next one's start)...
+    hash.items.resize(positions.size());
+    for (size_t i = 0; i < positions.size(); i++) {
+        hash.items[hash.bucketStarts[hash.itemBuckets[i]]++] = static_cast<uint32_t>(i);
+    }
+    // ...so shift them all back one
+    for (size_t b = bucketCount; b > 0; b--) hash.bucketStarts[b] = hash.bucketStarts[b - 1];
+    hash.bucketStarts[0] = 0;
+}
+
+void querySpatialHash(const JESpatialHash& hash, glm::vec3 center, float radius, std::vector<uint32_t>& found) {
+    found.clear();
+    if (hash.items.empty()) return;
+    // Items are only in the cell their center's in, so anything that could reach the query is within this
+    float reach = radius + hash.maxRadius;
+    JECell low = cellOf(hash, center - glm::vec3(reach));
+    JECell high = cellOf(hash, center + glm::vec3(reach));
+    for (int32_t x = low.x; x <= high.x; x++) {
+        for (int32_t y = low.y; y <= high.y; y++) {
+            for (int32_t z = low.z; z <= high.z; z++) {
+                JECell cell{x, y, z};
+                uint32_t bucket = bucketOf(hash, cell);
+                for (uint32_t i = hash.bucketStarts[bucket]; i < hash.bucketStarts[bucket + 1]; i++) {
+                    uint32_t item = hash.items[i];
+                    JECell itemCell = cellOf(hash, hash.positions[item]);
+                    // Someone else's cell sharing the bucket, or it'd get found twice
+                    if (itemCell.x != x || itemCell.y != y || itemCell.z != z) continue;
+                    glm::vec3 d = hash.positions[item] - center;
+                    float overlap = radius + hash.radii[item];
+                    if (d.x*d.x + d.y*d.y + d.z*d.z < overlap * overlap) found.push_back(item);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,38 @@
+//
+// Created by Ethan Lee on 10/19/26.
+//
+
+#ifndef JOSHENGINE_SPATIALHASHUTIL_H
+#define JOSHENGINE_SPATIALHASHUTIL_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <span>
+#include <cstdint>
+
+// Uniform grid over moving spheres, hashed so it doesn't need bounds. Rebuilt from scratch every tick, which is a
+// counting sort (no allocating once the vectors have grown), and queries only look at the cells around them.
+// Items are the indices of the positions it was built from.
+struct JESpatialHash {
+    float cellSize = 1;
+    float maxRadius = 0;
+    std::vector<uint32_t> bucketStarts; // Items in bucket b are items[bucketStarts[b]] up to items[bucketStarts[b+1]]
+    std::vector<uint32_t> items;
+    std::vector<uint32_t> itemBuckets;
+    std::vector<glm::vec3> positions;
+    std::vector<float> radii;
+};
+
+/**
+ * Rebuild a spatial hash. Items go in the cell their center is in.
+ * @param cellSize About the size of the things in it, or of the usual query. Too small and queries look at lots of
+ * empty cells, too big and they test lots of far away items.
+ */
+void buildSpatialHash(JESpatialHash& hash, std::span<const glm::vec3> positions, std::span<const float> radii, float cellSize);
+/**
+ * Find every item whose sphere overlaps this one (touching doesn't count).
+ * @param found Cleared first, then filled with item indices. Keep one around between queries so it doesn't allocate.
+ */
+void querySpatialHash(const JESpatialHash& hash, glm::vec3 center, float radius, std::vector<uint32_t>& found);
+
+#endif //JOSHENGINE_SPATIALHASHUTIL_H
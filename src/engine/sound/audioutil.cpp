@@ -8,13 +8,484 @@
 #include <alc.h>
 #include <stb_vorbis.h>
 #include <unordered_map>
+#include <future>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include "../job/jobutil.h"
+#include "../jbd/bundleutil.h"
 
 ALCdevice* alDevice;
 ALCcontext* context;
-glm::vec3 lpos;
+glm::vec3 lpos; // Game thread copy
+
+enum JEAudioCommandType : uint8_t {
+    JE_AUDIO_LISTENER,      // vectors: position, velocity, look, up
+    JE_AUDIO_MASTER_GAIN,   // scalars[0]
+    JE_AUDIO_UPLOAD_BUFFER, // id is the buffer handle. ints: samples, channels, sample rate. data: PCM from stb_vorbis (or null), freed once it's uploaded
+    JE_AUDIO_SOUND_CREATE,  // id, buffer. scalars: gain, max gain, min gain, half volume distance
+    JE_AUDIO_SOUND_MOVE,    // id. vectors: position, velocity. ints[0]: looping
+    JE_AUDIO_SOUND_PLAY,    // id
+    JE_AUDIO_SOUND_STOP,    // id
+    JE_AUDIO_SOUND_PAUSE,   // id
+    JE_AUDIO_SOUND_GAIN,    // id. scalars[0]
+    JE_AUDIO_SOUND_DELETE,  // id
+    JE_AUDIO_PLAY_AT,       // buffer, priority. vectors[0]: position. scalars: gain, half volume distance
+    JE_AUDIO_STREAM_CREATE, // id. data: stb_vorbis (or null), owned by the audio thread from here. ints[0]: looping. scalars[0]: gain
+    JE_AUDIO_STREAM_PLAY,   // id
+    JE_AUDIO_STREAM_STOP,   // id
+    JE_AUDIO_STREAM_GAIN    // id. scalars[0]
+};
+
+// Plain old data so the ring can be a static array that's ready before any constructor runs (game.cpp makes Sounds
+// at static init time, way before initAudio).
+struct JEAudioCommand {
+    JEAudioCommandType type;
+    unsigned int id;
+    unsigned int buffer;
+    int priority;
+    int ints[3];
+    float scalars[4];
+    float vectors[4][3];
+    void* data;
+};
+
+// Single producer (game thread), single consumer (audio thread). Both counters only ever go up, the slot is the
+// counter mod capacity. The game only writes head, the audio thread only writes tail.
+JEAudioCommand audioCommands[JE_AUDIO_COMMAND_CAPACITY];
+std::atomic<uint64_t> audioCommandHead{0};
+std::atomic<uint64_t> audioCommandTail{0};
+
+std::thread audioThread;
+std::atomic<bool> audioThreadRunning{false};
+
+enum JESourceState : uint8_t {
+    JE_SOURCE_STOPPED,
+    JE_SOURCE_PLAYING,
+    JE_SOURCE_PAUSED
+};
+
+// The snapshot. Written by the audio thread after each pass, snapshotCommand says how many commands it covers.
+std::atomic<uint8_t> soundStates[JE_MAX_SOUNDS];
+std::atomic<uint8_t> streamStates[JE_MAX_STREAMS];
+std::atomic<uint64_t> snapshotCommand{0};
+
+// Game thread side of it: the state the last play/stop/pause asked for, and which command that was. Until the snapshot
+// covers that command it's a better answer than the snapshot, so isPlaying() right after play() is true.
+struct JEAudioExpectation {
+    uint64_t command = 0;
+    uint8_t state = JE_SOURCE_STOPPED;
+};
+JEAudioExpectation soundExpectations[JE_MAX_SOUNDS];
+JEAudioExpectation streamExpectations[JE_MAX_STREAMS];
+
+// Handles get handed out on the game thread so nothing has to wait for the audio thread to get one.
+// Buffer handles start at 1, 0 is no buffer like it is in OpenAL.
+unsigned int soundCount = 0;
+std::vector<unsigned int> freeSoundIDs;
+unsigned int streamCount = 0;
+unsigned int bufferCount = 0;
+// Decompressed copies of bundled files that streams read out of. Moving the outer vector doesn't move what's inside.
+std::vector<std::vector<std::byte>> streamFiles;
+
+void packVector(float (&out)[3], glm::vec3 v) {
+    out[0] = v.x;
+    out[1] = v.y;
+    out[2] = v.z;
+}
+
+glm::vec3 unpackVector(const float (&v)[3]) {
+    return {v[0], v[1], v[2]};
+}
+
+// Returns the command's number, for JEAudioExpectation.
+uint64_t postAudioCommand(const JEAudioCommand& command) {
+    uint64_t head = audioCommandHead.load(std::memory_order_relaxed);
+    while (head - audioCommandTail.load(std::memory_order_acquire) >= JE_AUDIO_COMMAND_CAPACITY) {
+        // Full, only happens if the audio thread is really stuck. Nothing is going to empty it before initAudio though.
+        if (!audioThreadRunning.load(std::memory_order_relaxed)) throw std::runtime_error("Too many audio commands before initAudio!");
+        std::this_thread::yield();
+    }
+    audioCommands[head % JE_AUDIO_COMMAND_CAPACITY] = command;
+    audioCommandHead.store(head + 1, std::memory_order_release);
+    return head + 1;
+}
+
+uint8_t expectedState(const JEAudioExpectation& expected, const std::atomic<uint8_t>& snapshot) {
+    if (expected.command > snapshotCommand.load(std::memory_order_acquire)) return expected.state;
+    return snapshot.load(std::memory_order_relaxed);
+}
+
+// ---- Everything from here to the game thread API is audio thread only (or before/after it runs) ----
+
+glm::vec3 listenerPosition; // Audio thread copy
+std::vector<ALuint> alBuffers{0}; // Buffer handle -> OpenAL buffer
+// Buffer handle -> how long it plays, so voices can be reclaimed by time instead of asking OpenAL about every source.
+std::vector<float> bufferLengths{0};
+std::vector<ALuint> soundSources; // Sound ID -> OpenAL source, 0 once deleted
+
+struct JEVoiceState {
+    unsigned int buffer;
+    glm::vec3 position;
+    int priority;
+    float gain;
+    float halfVolumeDistance;
+    std::chrono::steady_clock::time_point start;
+    float length; // Seconds
+};
+
+struct JEVoice {
+    ALuint source;
+    bool active = false;
+    JEVoiceState state;
+};
+
+// Real voices are fixed, made once in initAudio. Virtual ones are just bookkeeping.
+std::vector<JEVoice> voices;
+std::vector<JEVoiceState> virtualVoices;
+
+struct JEAudioStream {
+    stb_vorbis* vorbis;
+    int channels;
+    int sampleRate;
+    bool loop;
+    ALuint source;
+    ALuint buffers[JE_STREAM_BUFFER_COUNT];
+    bool playing = false; // What the game asked for. The source can stop on its own if it starves, that gets fixed up.
+    bool reachedEnd = false; // Only for non looping streams, nothing left to decode
+};
+
+// Same ID system as everything else
+std::vector<JEAudioStream> streams;
+
+ALuint bufferName(unsigned int buffer) {
+    return buffer < alBuffers.size() ? alBuffers[buffer] : 0;
+}
+
+// Decode the next chunk into buffer. Loops back to the start in the middle of a buffer if it has to, so there's no gap.
+// Returns false if there was nothing left to decode.
+bool fillStreamBuffer(JEAudioStream& stream, ALuint buffer) {
+    if (!stream.vorbis) return false;
+    static thread_local std::vector<short> pcm;
+    pcm.resize(static_cast<size_t>(JE_STREAM_BUFFER_FRAMES) * stream.channels);
+    int filled = 0; // Frames
+    bool rewound = false;
+    while (filled < JE_STREAM_BUFFER_FRAMES) {
+        int frames = stb_vorbis_get_samples_short_interleaved(stream.vorbis, stream.channels, pcm.data() + filled * stream.channels, (JE_STREAM_BUFFER_FRAMES - filled) * stream.channels);
+        filled += frames;
+        if (frames > 0) {
+            rewound = false;
+            continue;
+        }
+        // Rewinding twice in a row without getting anything means the file has no audio in it, don't spin on it.
+        if (!stream.loop || rewound) {
+            stream.reachedEnd = true;
+            break;
+        }
+        stb_vorbis_seek_start(stream.vorbis);
+        rewound = true;
+    }
+    if (filled == 0) return false;
+    alBufferData(buffer, stream.channels > 1 ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16, pcm.data(), filled * stream.channels * static_cast<int>(sizeof(short)), stream.sampleRate);
+    return true;
+}
+
+// Swap finished buffers for freshly decoded ones.
+void serviceStream(JEAudioStream& stream) {
+    ALint processed = 0;
+    alGetSourcei(stream.source, AL_BUFFERS_PROCESSED, &processed);
+    for (; processed > 0; processed--) {
+        ALuint buffer;
+        alSourceUnqueueBuffers(stream.source, 1, &buffer);
+        if (!stream.reachedEnd && fillStreamBuffer(stream, buffer)) alSourceQueueBuffers(stream.source, 1, &buffer);
+    }
+
+    ALint queued = 0, state = 0;
+    alGetSourcei(stream.source, AL_BUFFERS_QUEUED, &queued);
+    alGetSourcei(stream.source, AL_SOURCE_STATE, &state);
+    if (queued == 0) {
+        stream.playing = false; // Played out
+    } else if (state != AL_PLAYING) {
+        // Ran dry before we got to it (a hitch somewhere). OpenAL stops the source, so start it back up.
+        alSourcePlay(stream.source);
+    }
+}
+
+void createStream(unsigned int id, stb_vorbis* vorbis, bool loop, float gain) {
+    stb_vorbis_info info{};
+    if (vorbis) info = stb_vorbis_get_info(vorbis);
+
+    JEAudioStream stream{vorbis, info.channels, static_cast<int>(info.sample_rate), loop};
+    alGenSources(1, &stream.source);
+    alGenBuffers(JE_STREAM_BUFFER_COUNT, stream.buffers);
+    alSourcef(stream.source, AL_PITCH, 1);
+    alSourcef(stream.source, AL_GAIN, gain);
+    // Stuck to the listener
+    alSourcei(stream.source, AL_SOURCE_RELATIVE, AL_TRUE);
+    alSource3f(stream.source, AL_POSITION, 0, 0, 0);
+    alSourcef(stream.source, AL_ROLLOFF_FACTOR, 0);
+
+    if (streams.size() <= id) streams.resize(id + 1);
+    streams[id] = stream;
+}
+
+void playStream(JEAudioStream& stream) {
+    alSourceStop(stream.source);
+    alSourcei(stream.source, AL_BUFFER, 0); // Unqueues everything
+    if (stream.vorbis) stb_vorbis_seek_start(stream.vorbis);
+    stream.reachedEnd = false;
+
+    // Fill them all now so it starts right away, serviceStream keeps it going from here.
+    int queued = 0;
+    for (ALuint buffer : stream.buffers) {
+        if (!fillStreamBuffer(stream, buffer)) break;
+        alSourceQueueBuffers(stream.source, 1, &buffer);
+        queued++;
+    }
+    stream.playing = queued > 0;
+    if (stream.playing) alSourcePlay(stream.source);
+}
+
+void stopStream(JEAudioStream& stream) {
+    stream.playing = false;
+    alSourceStop(stream.source);
+    alSourcei(stream.source, AL_BUFFER, 0);
+}
+
+void uploadBuffer(unsigned int id, short* data, int samples, int channels, int sampleRate) {
+    ALuint buffer;
+    alGenBuffers(1, &buffer);
+    // Length's worked out before data gets freed
+    float length = data && sampleRate > 0 ? static_cast<float>(samples) / static_cast<float>(sampleRate) : 0.0f;
+    if (data) {                                                       // needless cast so the compiler will stop yelling at me
+        alBufferData(buffer, channels > 1 ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16, data, samples*channels*static_cast<int>(sizeof(short)), sampleRate);
+        // alBufferData copies, we don't need ours anymore
+        free(data);
+    }
+    if (alBuffers.size() <= id) {
+        alBuffers.resize(id + 1, 0);
+        bufferLengths.resize(id + 1, 0);
+    }
+    alBuffers[id] = buffer;
+    bufferLengths[id] = length;
+}
+
+void createSoundSource(unsigned int id, unsigned int buffer, float gain, float max, float min, float halfVolumeDistance) {
+    if (soundSources.size() <= id) soundSources.resize(id + 1, 0);
+    ALuint& source = soundSources[id];
+    alGenSources(1, &source);
+    alSourcef(source, AL_PITCH, 1);
+    alSourcef(source, AL_GAIN, gain);
+    alSourcef(source, AL_MAX_GAIN, max);
+    alSourcef(source, AL_MIN_GAIN, min);
+    alSourcef(source, AL_REFERENCE_DISTANCE, halfVolumeDistance);
+    ALuint name = bufferName(buffer);
+    alSourceQueueBuffers(source, 1, &name);
+}
+
+// Roughly what AL_INVERSE_DISTANCE does to it, for ranking voices. Doesn't need to match OpenAL exactly.
+float audibleGain(const JEVoiceState& state) {
+    float distance = glm::distance(listenerPosition, state.position);
+    return state.gain * state.halfVolumeDistance / std::max(state.halfVolumeDistance, distance);
+}
+
+float elapsedSeconds(const JEVoiceState& state, std::chrono::steady_clock::time_point now) {
+    return std::chrono::duration<float>(now - state.start).count();
+}
+
+// Lower is less important, and first to be stolen.
+bool lessImportant(const JEVoiceState& a, const JEVoiceState& b) {
+    if (a.priority != b.priority) return a.priority < b.priority;
+    return audibleGain(a) < audibleGain(b);
+}
+
+void startVoice(JEVoice& voice, const JEVoiceState& state, float offset) {
+    voice.active = true;
+    voice.state = state;
+    alSourceStop(voice.source);
+    alSourcei(voice.source, AL_BUFFER, static_cast<ALint>(bufferName(state.buffer)));
+    alSourcef(voice.source, AL_GAIN, state.gain);
+    alSourcef(voice.source, AL_MAX_GAIN, std::max(1.0f, state.gain));
+    alSourcef(voice.source, AL_REFERENCE_DISTANCE, state.halfVolumeDistance);
+    alSource3f(voice.source, AL_POSITION, state.position.x, state.position.y, state.position.z);
+    alSourcef(voice.source, AL_SEC_OFFSET, offset);
+    alSourcePlay(voice.source);
+}
+
+// A free voice, or the least important busy one if it's less important than state. nullptr if neither.
+JEVoice* findVoice(const JEVoiceState& state) {
+    JEVoice* weakest = nullptr;
+    for (auto& voice : voices) {
+        if (!voice.active) return &voice;
+        if (!weakest || lessImportant(voice.state, weakest->state)) weakest = &voice;
+    }
+    if (weakest && lessImportant(weakest->state, state)) {
+        // Stolen, but it can come back if a voice frees up before it would have ended.
+        virtualVoices.push_back(weakest->state);
+        alSourceStop(weakest->source);
+        weakest->active = false;
+        return weakest;
+    }
+    return nullptr;
+}
+
+void startOneShot(unsigned int buffer, glm::vec3 position, int priority, float gain, float halfVolumeDistance) {
+    JEVoiceState state{buffer, position, priority, gain, halfVolumeDistance, std::chrono::steady_clock::now(),
+                       buffer < bufferLengths.size() ? bufferLengths[buffer] : 0.0f};
+    if (state.length <= 0) return;
+    if (audibleGain(state) < JE_VOICE_INAUDIBLE_GAIN) {
+        virtualVoices.push_back(state);
+        return;
+    }
+    JEVoice* voice = findVoice(state);
+    if (voice) startVoice(*voice, state, 0);
+    else virtualVoices.push_back(state);
+}
+
+// Reclaim finished voices, and swap virtual and real voices around as the listener moves.
+void updateVoices() {
+    auto now = std::chrono::steady_clock::now();
+    for (auto& voice : voices) {
+        if (!voice.active) continue;
+        if (elapsedSeconds(voice.state, now) >= voice.state.length) {
+            voice.active = false;
+        } else if (audibleGain(voice.state) < JE_VOICE_INAUDIBLE_GAIN) {
+            // Listener walked away from it, free the voice up
+            alSourceStop(voice.source);
+            voice.active = false;
+            virtualVoices.push_back(voice.state);
+        }
+    }
+
+    std::erase_if(virtualVoices, [now](const JEVoiceState& state) { return elapsedSeconds(state, now) >= state.length; });
+    if (virtualVoices.empty()) return;
+    // Most important first, they get first pick of the voices. Whatever's left stays virtual.
+    std::sort(virtualVoices.begin(), virtualVoices.end(), [](const JEVoiceState& a, const JEVoiceState& b) { return lessImportant(b, a); });
+    std::vector<JEVoiceState> stillVirtual;
+    std::vector<JEVoiceState> waiting;
+    waiting.swap(virtualVoices);
+    for (const auto& state : waiting) {
+        JEVoice* voice = audibleGain(state) < JE_VOICE_INAUDIBLE_GAIN ? nullptr : findVoice(state);
+        if (voice) startVoice(*voice, state, elapsedSeconds(state, now));
+        else stillVirtual.push_back(state);
+    }
+    // findVoice may have pushed stolen voices in the meantime
+    stillVirtual.insert(stillVirtual.end(), virtualVoices.begin(), virtualVoices.end());
+    virtualVoices.swap(stillVirtual);
+}
+
+void runAudioCommand(const JEAudioCommand& command) {
+    ALuint source = 0;
+    if (command.type >= JE_AUDIO_SOUND_MOVE && command.type <= JE_AUDIO_SOUND_DELETE && command.id < soundSources.size()) {
+        source = soundSources[command.id];
+    }
+    switch (command.type) {
+        case JE_AUDIO_LISTENER: {
+            listenerPosition = unpackVector(command.vectors[0]);
+            alListener3f(AL_POSITION, command.vectors[0][0], command.vectors[0][1], command.vectors[0][2]);
+            alListener3f(AL_VELOCITY, command.vectors[1][0], command.vectors[1][1], command.vectors[1][2]);
+            ALfloat orientation[] = {command.vectors[2][0], command.vectors[2][1], command.vectors[2][2],
+                                     command.vectors[3][0], command.vectors[3][1], command.vectors[3][2]};
+            alListenerfv(AL_ORIENTATION, orientation);
+            break;
+        }
+        case JE_AUDIO_MASTER_GAIN:
+            alListenerf(AL_GAIN, command.scalars[0]);
+            break;
+        case JE_AUDIO_UPLOAD_BUFFER:
+            uploadBuffer(command.id, static_cast<short*>(command.data), command.ints[0], command.ints[1], command.ints[2]);
+            break;
+        case JE_AUDIO_SOUND_CREATE:
+            createSoundSource(command.id, command.buffer, command.scalars[0], command.scalars[1], command.scalars[2], command.scalars[3]);
+            break;
+        case JE_AUDIO_SOUND_MOVE:
+            alSource3f(source, AL_POSITION, command.vectors[0][0], command.vectors[0][1], command.vectors[0][2]);
+            alSource3f(source, AL_VELOCITY, command.vectors[1][0], command.vectors[1][1], command.vectors[1][2]);
+            alSourcei(source, AL_LOOPING, command.ints[0]);
+            break;
+        case JE_AUDIO_SOUND_PLAY:
+            alSourcePlay(source);
+            break;
+        case JE_AUDIO_SOUND_STOP:
+            alSourceStop(source);
+            break;
+        case JE_AUDIO_SOUND_PAUSE:
+            alSourcePause(source);
+            break;
+        case JE_AUDIO_SOUND_GAIN:
+            alSourcef(source, AL_GAIN, command.scalars[0]);
+            break;
+        case JE_AUDIO_SOUND_DELETE:
+            if (source) alDeleteSources(1, &source);
+            if (command.id < soundSources.size()) soundSources[command.id] = 0;
+            soundStates[command.id].store(JE_SOURCE_STOPPED, std::memory_order_relaxed);
+            break;
+        case JE_AUDIO_PLAY_AT:
+            startOneShot(command.buffer, unpackVector(command.vectors[0]), command.priority, command.scalars[0], command.scalars[1]);
+            break;
+        case JE_AUDIO_STREAM_CREATE:
+            createStream(command.id, static_cast<stb_vorbis*>(command.data), command.ints[0], command.scalars[0]);
+            break;
+        case JE_AUDIO_STREAM_PLAY:
+            playStream(streams[command.id]);
+            break;
+        case JE_AUDIO_STREAM_STOP:
+            stopStream(streams[command.id]);
+            break;
+        case JE_AUDIO_STREAM_GAIN:
+            alSourcef(streams[command.id].source, AL_GAIN, command.scalars[0]);
+            break;
+    }
+}
+
+// Run everything posted so far. Returns how many commands have been run in total.
+uint64_t runAudioCommands() {
+    uint64_t tail = audioCommandTail.load(std::memory_order_relaxed);
+    uint64_t head = audioCommandHead.load(std::memory_order_acquire);
+    for (; tail < head; tail++) {
+        runAudioCommand(audioCommands[tail % JE_AUDIO_COMMAND_CAPACITY]);
+        // Slot's free for the game to reuse
+        audioCommandTail.store(tail + 1, std::memory_order_release);
+    }
+    return tail;
+}
+
+void publishAudioSnapshot(uint64_t commandsRun) {
+    for (size_t i = 0; i < soundSources.size(); i++) {
+        if (!soundSources[i]) continue;
+        ALint state = 0;
+        alGetSourcei(soundSources[i], AL_SOURCE_STATE, &state);
+        soundStates[i].store(state == AL_PLAYING ? JE_SOURCE_PLAYING : state == AL_PAUSED ? JE_SOURCE_PAUSED : JE_SOURCE_STOPPED, std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < streams.size(); i++) streamStates[i].store(streams[i].playing ? JE_SOURCE_PLAYING : JE_SOURCE_STOPPED, std::memory_order_relaxed);
+    snapshotCommand.store(commandsRun, std::memory_order_release);
+}
+
+void audioThreadLoop() {
+    bool running = true;
+    while (running) {
+        // Checked before draining, so whatever was posted before deinitAudio still runs.
+        running = audioThreadRunning.load(std::memory_order_acquire);
+        uint64_t commandsRun = runAudioCommands();
+        for (auto& stream : streams) {
+            if (stream.playing) serviceStream(stream);
+        }
+        updateVoices();
+        publishAudioSnapshot(commandsRun);
+        // Well under one stream buffer's length, so there's always a couple queued ahead.
+        if (running) std::this_thread::sleep_for(std::chrono::milliseconds(JE_AUDIO_THREAD_PERIOD_MS));
+    }
+}
+
+// ---- Game thread API ----
 
 void setMasterVolume(float volume) {
-    alListenerf(AL_GAIN, volume);
+    JEAudioCommand command{JE_AUDIO_MASTER_GAIN};
+    command.scalars[0] = volume;
+    postAudioCommand(command);
 }
 
 glm::vec3 getListenerPos() {
@@ -23,10 +494,12 @@ glm::vec3 getListenerPos() {
 
 void updateListener(glm::vec3 position, glm::vec3 velocity, glm::vec3 lookVec, glm::vec3 upVec) {
     lpos = position;
-    alListener3f(AL_POSITION, position.x, position.y, position.z);
-    alListener3f(AL_VELOCITY, velocity.x, velocity.y, velocity.z);
-    ALfloat orientation[] = {lookVec.x, lookVec.y, lookVec.z, upVec.x, upVec.y, upVec.z};
-    alListenerfv(AL_ORIENTATION, orientation);
+    JEAudioCommand command{JE_AUDIO_LISTENER};
+    packVector(command.vectors[0], position);
+    packVector(command.vectors[1], velocity);
+    packVector(command.vectors[2], lookVec);
+    packVector(command.vectors[3], upVec);
+    postAudioCommand(command);
 }
 
 void initAudio() {
@@ -47,75 +520,182 @@ void initAudio() {
     }
 
     alDistanceModel(AL_INVERSE_DISTANCE);
+
+    voices.resize(JE_VOICE_COUNT);
+    for (auto& voice : voices) {
+        alGenSources(1, &voice.source);
+        alSourcef(voice.source, AL_PITCH, 1);
+    }
+
+    // OpenAL belongs to the audio thread from here on. Anything posted before now (static Sounds) runs on its first pass.
+    audioThreadRunning.store(true, std::memory_order_release);
+    audioThread = std::thread(&audioThreadLoop);
 }
 
-std::unordered_map<std::string, unsigned int> audioMap;
+void deinitAudio() {
+    audioThreadRunning.store(false, std::memory_order_release);
+    if (audioThread.joinable()) audioThread.join();
 
-unsigned int oggToBuffer(const std::string& filePath) {
-    if (audioMap.contains(filePath)) return audioMap.at(filePath);
+    for (auto& stream : streams) {
+        alSourceStop(stream.source);
+        alDeleteSources(1, &stream.source);
+        alDeleteBuffers(JE_STREAM_BUFFER_COUNT, stream.buffers);
+        if (stream.vorbis) stb_vorbis_close(stream.vorbis);
+    }
+    streams.clear();
+    streamFiles.clear();
 
-    int channels, sampleRate, samples;
-    short* data;
-    int error;
+    for (ALuint& source : soundSources) {
+        if (source) alDeleteSources(1, &source);
+    }
+    soundSources.clear();
 
-    stb_vorbis *v = stb_vorbis_open_filename(filePath.c_str(), &error, nullptr);
-    stb_vorbis_info info = stb_vorbis_get_info(v);
+    for (auto& voice : voices) {
+        alSourceStop(voice.source);
+        alDeleteSources(1, &voice.source);
+    }
+    voices.clear();
+    virtualVoices.clear();
 
-    samples = stb_vorbis_decode_filename(filePath.c_str(), &channels, &sampleRate, &data);
+    for (ALuint buffer : alBuffers) {
+        if (buffer) alDeleteBuffers(1, &buffer);
+    }
+    alBuffers.assign(1, 0);
+    bufferLengths.assign(1, 0);
 
-    ALuint buffer;
-    alGenBuffers(1, &buffer);                 //      needless cast so the compiler will stop yelling at me
+    alcMakeContextCurrent(nullptr);
+    alcDestroyContext(context);
+    alcCloseDevice(alDevice);
+}
+
+std::unordered_map<std::string, unsigned int> audioMap;
 
-    if (info.channels > 1) alBufferData(buffer, AL_FORMAT_STEREO16, data, samples*2*static_cast<int>(sizeof(short)), sampleRate);
-    else alBufferData(buffer, AL_FORMAT_MONO16, data, samples*static_cast<int>(sizeof(short)), sampleRate);
+struct JEDecodedOgg {
+    short* data = nullptr;
+    int samples = 0;
+    int channels = 0;
+    int sampleRate = 0;
+};
 
-    audioMap.insert({filePath, buffer});
+// Decodes that were started by preloadOgg. Only ever touched from the main thread, the futures do the handoff.
+std::unordered_map<std::string, std::shared_future<JEDecodedOgg>> pendingAudio;
 
+// Pure CPU (and file reading), runs on job workers.
+JEDecodedOgg decodeOgg(const std::string& filePath, const std::string& bundleFilePath) {
+    JEDecodedOgg decoded;
+    if (bundleFilePath.empty()) {
+        decoded.samples = stb_vorbis_decode_filename(filePath.c_str(), &decoded.channels, &decoded.sampleRate, &decoded.data);
+    } else {
+        try {
+            // Straight out of the mapping unless it was packed compressed
+            std::vector<std::byte> storage;
+            std::span<const std::byte> file = getBundledFile(filePath, bundleFilePath, storage);
+            decoded.samples = stb_vorbis_decode_memory(reinterpret_cast<const unsigned char*>(file.data()), static_cast<int>(file.size()), &decoded.channels, &decoded.sampleRate, &decoded.data);
+        } catch (std::runtime_error &e) {
+            decoded.samples = -1;
+        }
+    }
+    if (decoded.samples < 0) decoded.data = nullptr;
+    return decoded;
+}
+
+unsigned int bufferDecodedOgg(const std::string& filePath, const JEDecodedOgg& decoded) {
+    if (decoded.data == nullptr) std::cerr << "Failed to decode \"" << filePath << "\"! It will be silent." << std::endl;
+
+    unsigned int buffer = ++bufferCount;
+    // The audio thread frees the PCM once OpenAL has its copy
+    JEAudioCommand command{JE_AUDIO_UPLOAD_BUFFER, buffer};
+    command.ints[0] = decoded.samples;
+    command.ints[1] = decoded.channels;
+    command.ints[2] = decoded.sampleRate;
+    command.data = decoded.data;
+    postAudioCommand(command);
+
+    audioMap.insert({filePath, buffer});
     return buffer;
 }
+
+void preloadOgg(const std::string& filePath, const std::string& bundleFilePath) {
+    if (audioMap.contains(filePath) || pendingAudio.contains(filePath)) return;
+    std::shared_ptr<std::promise<JEDecodedOgg>> decodePromise = std::make_shared<std::promise<JEDecodedOgg>>();
+    pendingAudio.insert({filePath, decodePromise->get_future().share()});
+    submitJob([decodePromise, filePath, bundleFilePath]() {
+        decodePromise->set_value(decodeOgg(filePath, bundleFilePath));
+    });
+}
+
+unsigned int oggToBuffer(const std::string& filePath, const std::string& bundleFilePath) {
+    if (audioMap.contains(filePath)) return audioMap.at(filePath);
+
+    if (pendingAudio.contains(filePath)) {
+        // Only waits if the worker isn't done yet
+        JEDecodedOgg decoded = pendingAudio.at(filePath).get();
+        pendingAudio.erase(filePath);
+        return bufferDecodedOgg(filePath, decoded);
+    }
+
+    return bufferDecodedOgg(filePath, decodeOgg(filePath, bundleFilePath));
+}
+
+void playAt(unsigned int buffer, glm::vec3 position, int priority, float gain, float halfVolumeDistance) {
+    JEAudioCommand command{JE_AUDIO_PLAY_AT, 0, buffer, priority};
+    packVector(command.vectors[0], position);
+    command.scalars[0] = gain;
+    command.scalars[1] = halfVolumeDistance;
+    postAudioCommand(command);
+}
+
 // If are not using MSVC
 #ifndef _MSC_VER
-Sound::Sound(glm::vec3 pos, glm::vec3 vel, const std::string &filePath, bool loop, float halfVolumeDistance, float min, float max, float gain) {
+Sound::Sound(glm::vec3 pos, glm::vec3 vel, const std::string &filePath, bool loop, float halfVolumeDistance, float min, float max, float gain, const std::string& bundleFilePath) {
     // If we are using MSVC
 #else
-    Sound::Sound(vec3_MSVC pos, vec3_MSVC vel, const std::string &filePath, bool loop, float halfVolumeDistance, float min, float max, float gain) {
+    Sound::Sound(vec3_MSVC pos, vec3_MSVC vel, const std::string &filePath, bool loop, float halfVolumeDistance, float min, float max, float gain, const std::string& bundleFilePath) {
 #endif
     isLooping = loop;
     position = pos;
     velocity = vel;
     isPaused = false;
 
-    // Create audio source
-    alGenSources((ALuint)1, &sourceID);
-    alSourcef(sourceID, AL_PITCH, 1);
-    alSourcef(sourceID, AL_GAIN, gain);
-    alSourcef(sourceID, AL_MAX_GAIN, max);
-    alSourcef(sourceID, AL_MIN_GAIN, min);
-    alSourcef(sourceID, AL_REFERENCE_DISTANCE, halfVolumeDistance);
-    updateSource();
+    if (freeSoundIDs.empty()) {
+        if (soundCount >= JE_MAX_SOUNDS) throw std::runtime_error("Too many sounds!");
+        sourceID = soundCount++;
+    } else {
+        sourceID = freeSoundIDs.back();
+        freeSoundIDs.pop_back();
+    }
+    soundExpectations[sourceID] = {};
 
-    // Fill buffer
-    bufferID = oggToBuffer(filePath);
-    alSourceQueueBuffers(sourceID, 1, &bufferID);
+    // Buffer first, so its upload is ahead of the source that plays it in the ring
+    bufferID = oggToBuffer(filePath, bundleFilePath);
+    JEAudioCommand command{JE_AUDIO_SOUND_CREATE, sourceID, bufferID};
+    command.scalars[0] = gain;
+    command.scalars[1] = max;
+    command.scalars[2] = min;
+    command.scalars[3] = halfVolumeDistance;
+    postAudioCommand(command);
+    updateSource();
 }
 
 void Sound::updateSource() const {
-    alSource3f(sourceID, AL_POSITION, position.x, position.y, position.z);
-    alSource3f(sourceID, AL_VELOCITY, velocity.x, velocity.y, velocity.z);
-    alSourcei(sourceID, AL_LOOPING, isLooping);
+    JEAudioCommand command{JE_AUDIO_SOUND_MOVE, sourceID};
+    packVector(command.vectors[0], position);
+    packVector(command.vectors[1], velocity);
+    command.ints[0] = isLooping;
+    postAudioCommand(command);
 }
 
 void Sound::play() {
-    alSourcePlay(sourceID);
+    soundExpectations[sourceID] = {postAudioCommand({JE_AUDIO_SOUND_PLAY, sourceID}), JE_SOURCE_PLAYING};
     isPaused = false;
 }
 
 void Sound::stop() const {
-    alSourceStop(sourceID);
+    soundExpectations[sourceID] = {postAudioCommand({JE_AUDIO_SOUND_STOP, sourceID}), JE_SOURCE_STOPPED};
 }
 
 void Sound::pause() {
-    alSourcePause(sourceID);
+    soundExpectations[sourceID] = {postAudioCommand({JE_AUDIO_SOUND_PAUSE, sourceID}), JE_SOURCE_PAUSED};
     isPaused = true;
 }
 
@@ -125,15 +705,65 @@ void Sound::togglePaused() {
 }
 
 bool Sound::isPlaying() const {
-    int result;
-    alGetSourcei(sourceID, AL_SOURCE_STATE, &result);
-    return result == AL_PLAYING;
+    return expectedState(soundExpectations[sourceID], soundStates[sourceID]) == JE_SOURCE_PLAYING;
 }
 
 void Sound::deleteSource() const {
-    alDeleteSources((ALuint)1, &sourceID);
+    soundExpectations[sourceID] = {postAudioCommand({JE_AUDIO_SOUND_DELETE, sourceID}), JE_SOURCE_STOPPED};
+    freeSoundIDs.push_back(sourceID);
 }
 
 void Sound::setGain(float gain) const {
-    alSourcef(sourceID, AL_GAIN, gain);
-}
\ No newline at end of file
+    JEAudioCommand command{JE_AUDIO_SOUND_GAIN, sourceID};
+    command.scalars[0] = gain;
+    postAudioCommand(command);
+}
+
+StreamedSound::StreamedSound(const std::string& filePath, bool loop, float gain, const std::string& bundleFilePath) {
+    if (streamCount >= JE_MAX_STREAMS) throw std::runtime_error("Too many streamed sounds!");
+    int error = 0;
+    stb_vorbis* vorbis = nullptr;
+    // Only reads the headers, decoding happens as it plays.
+    if (bundleFilePath.empty()) {
+        vorbis = stb_vorbis_open_filename(filePath.c_str(), &error, nullptr);
+    } else {
+        try {
+            std::vector<std::byte> storage;
+            std::span<const std::byte> file = getBundledFile(filePath, bundleFilePath, storage);
+            if (!storage.empty()) {
+                // Was packed compressed, so the decompressed copy has to live as long as the stream does
+                streamFiles.push_back(std::move(storage));
+                file = streamFiles.back();
+            }
+            vorbis = stb_vorbis_open_memory(reinterpret_cast<const unsigned char*>(file.data()), static_cast<int>(file.size()), &error, nullptr);
+        } catch (std::runtime_error &e) {
+            vorbis = nullptr;
+        }
+    }
+    if (!vorbis) std::cerr << "Failed to open \"" << filePath << "\" for streaming! It will be silent." << std::endl;
+
+    streamID = streamCount++;
+    JEAudioCommand command{JE_AUDIO_STREAM_CREATE, streamID};
+    command.data = vorbis;
+    command.ints[0] = loop;
+    command.scalars[0] = gain;
+    postAudioCommand(command);
+}
+
+void StreamedSound::play() const {
+    streamExpectations[streamID] = {postAudioCommand({JE_AUDIO_STREAM_PLAY, streamID}), JE_SOURCE_PLAYING};
+}
+
+void StreamedSound::stop() const {
+    streamExpectations[streamID] = {postAudioCommand({JE_AUDIO_STREAM_STOP, streamID}), JE_SOURCE_STOPPED};
+}
+
+void StreamedSound::setGain(float gain) const {
+    JEAudioCommand command{JE_AUDIO_STREAM_GAIN, streamID};
+    command.scalars[0] = gain;
+    postAudioCommand(command);
+}
+
+bool StreamedSound::isPlaying() const {
+    return expectedState(streamExpectations[streamID], streamStates[streamID]) == JE_SOURCE_PLAYING;
+}
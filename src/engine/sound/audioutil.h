@@ -8,8 +8,31 @@
 #include <string>
 typedef glm::vec<3, float, (glm::qualifier)3> vec3_MSVC;
 
+// Everything that talks to OpenAL between initAudio and deinitAudio happens on one audio thread. The game thread only
+// posts commands into a lock-free ring of JE_AUDIO_COMMAND_CAPACITY, and reads source state back from a snapshot the
+// audio thread publishes after each pass. A slow driver call stalls the audio thread, not the frame.
+// The functions in here are game thread only, it's the ring's one producer.
+#define JE_AUDIO_COMMAND_CAPACITY 1024
+// How long the audio thread sleeps between passes. Also about how late a play() can start.
+#define JE_AUDIO_THREAD_PERIOD_MS 4
+// Sound and StreamedSound handles
+#define JE_MAX_SOUNDS 256
+#define JE_MAX_STREAMS 64
+
 void setMasterVolume(float volume);
-unsigned int oggToBuffer(const std::string& filePath);
+/**
+ * Decode a whole .ogg into a buffer, or get the one it was already decoded into.
+ * Only waits for the decode (if preloadOgg didn't already do it), the upload itself happens on the audio thread.
+ * @param filePath Loose file, or path in the bundle e.g. "./sounds/jump.ogg"
+ * @param bundleFilePath Bundle to decode it out of, empty for a loose file
+ * @return Buffer handle, usable straight away
+ */
+unsigned int oggToBuffer(const std::string& filePath, const std::string& bundleFilePath = "");
+/**
+ * Start decoding on a job worker so the oggToBuffer (or Sound) that needs it later doesn't have to.
+ * Preload a load's worth of sounds together and they all decode at once, one worker each.
+ */
+void preloadOgg(const std::string& filePath, const std::string& bundleFilePath = "");
 
 class Sound {
 public:
@@ -17,14 +40,17 @@ public:
     unsigned int bufferID{};
     glm::vec3 position{};
     glm::vec3 velocity{};
-    bool isLooping;
-    bool isPaused;
+    bool isLooping = false;
+    bool isPaused = false;
+
+    // Placeholder until it's assigned a real one, doesn't make a source.
+    Sound() = default;
     // If we are not using MSVC
 #ifndef _MSC_VER
-    Sound(glm::vec3 pos, glm::vec3 vel, const std::string& filePath, bool loop, float halfVolumeDistance, float min, float max, float gain);
+    Sound(glm::vec3 pos, glm::vec3 vel, const std::string& filePath, bool loop, float halfVolumeDistance, float min, float max, float gain, const std::string& bundleFilePath = "");
     // If we are using MSVC
 #else
-    Sound(vec3_MSVC pos, vec3_MSVC vel, const std::string& filePath, bool loop, float halfVolumeDistance, float min, float max, float gain);
+    Sound(vec3_MSVC pos, vec3_MSVC vel, const std::string& filePath, bool loop, float halfVolumeDistance, float min, float max, float gain, const std::string& bundleFilePath = "");
 #endif
     void updateSource() const;
     void play();
@@ -34,11 +60,53 @@ public:
     void deleteSource() const;
     void setGain(float gain) const;
 
+    // From the audio thread's last snapshot, or what was last asked for if it hasn't caught up to that yet.
     [[nodiscard]] bool isPlaying() const;
 
 };
 
+// Streams decode into this many rotating buffers of JE_STREAM_BUFFER_FRAMES each (~190ms at 44.1kHz),
+// so a playing stream holds well under a second of PCM no matter how long the file is.
+#define JE_STREAM_BUFFER_COUNT 4
+#define JE_STREAM_BUFFER_FRAMES 8192
+
+// A long sound (music) that gets decoded a bit at a time on the audio thread instead of all at once up front.
+// Not positional, it always plays at the listener. Copies are handles to the same stream.
+class StreamedSound {
+public:
+    unsigned int streamID{};
+
+    StreamedSound() = default;
+    // Bundled files are streamed straight out of the bundle, so the bundle has to stay open as long as audio is.
+    StreamedSound(const std::string& filePath, bool loop, float gain, const std::string& bundleFilePath = "");
+
+    // From the start, even if it's already playing.
+    void play() const;
+    void stop() const;
+    void setGain(float gain) const;
+
+    [[nodiscard]] bool isPlaying() const;
+};
+
+// One-shot sounds share this many OpenAL sources instead of each getting their own.
+#define JE_VOICE_COUNT 32
+// Quieter than this at the listener (gain after distance falloff) and a one-shot doesn't get a real voice,
+// it's only tracked until it would have finished (a virtual voice) in case the listener gets closer.
+#define JE_VOICE_INAUDIBLE_GAIN 0.01f
+
+/**
+ * Play a buffer once at a position through the voice pool. Nothing to clean up, voices get reused once they finish,
+ * and virtual and real voices get swapped around on the audio thread as the listener moves.
+ * If every voice is busy the least important one is stolen: lowest priority, then quietest at the listener.
+ * If that's still more important than this sound, this one goes virtual instead.
+ * @param buffer From oggToBuffer
+ * @param priority Higher is more important
+ * @param halfVolumeDistance Distance where it's at half volume (OpenAL's reference distance)
+ */
+void playAt(unsigned int buffer, glm::vec3 position, int priority, float gain = 1.0f, float halfVolumeDistance = 3.0f);
+
 void initAudio();
+void deinitAudio();
 void updateListener(glm::vec3 position, glm::vec3 velocity, glm::vec3 lookVec, glm::vec3 upVec);
 
 #endif //JOSHENGINE_AUDIOUTIL_H
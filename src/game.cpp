@@ -14,7 +14,9 @@
 #include "engine/sound/audioutil.h"
 #include "menus.h"
 #include "savedata.h"
+#include "engine/job/timerutil.h"
 #include <random>
+#include <bit>
 
 Transform* cameraPtr;
 
@@ -58,46 +60,44 @@ const float mouseSpeed = 10.0f;
 
 // Since there is no null sound constructor and global definition doesn't work because god knows why,
 // this does nothing but is required.
-Sound jumpSfx = Sound(vec3(0), vec3(0), "./sounds/jump.ogg",  false, 3, 0.1, 2, 0.25);
-Sound dashSfx = Sound(vec3(0), vec3(0), "./sounds/dash.ogg",  false, 3, 0.1, 2, 0.25);
-Sound hitSfx  = Sound(vec3(0), vec3(0), "./sounds/punch.ogg", false, 3, 0.1, 2, 0.25);
+// Made for real in gameSetup, once their decodes are going
+Sound jumpSfx;
+Sound dashSfx;
+Sound hitSfx;
 
 bool closeRangeHit(vec3 hitPoint, float rad) {
-    bool hit = false;
+    // Only the enemies near the hit, not every GameObject
     std::vector<std::string> deleteThese{};
-    for (auto const &g: *getGameObjects()) {
-        if (g.first.starts_with("enemy") && testSpheres(hitPoint, rad, g.second.transform.position, g.second.transform.scale.x)) {
-            hit = true;
-            switch (g.first[5]) {
-                case ('_'): {
-                    currentScore += 20;  // Kill easter egg, 30pts
-                    health = maxHealth; // Thanks for killing that horrid thing
-                }
-                case ('1'): {
-                    if (rand()%2 == 0) maxHealth += 5;
-                    currentScore += 10;
-                    break;
-                }
-                case ('2'): {
-                    // 1/3 chance for big guy to lend a dash
-                    if (rand()%3 == 0) maxDashes += 1;
-                    currentScore += 15;
-                    break;
-                }
-                case ('3'): {
-                    // Coin flip on lil guy to lend a jump
-                    if (rand()%2 == 0) maxJumps += 1;
-                    currentScore += 10;
-                    break;
-                }
+    findEnemiesNear(hitPoint, rad, deleteThese);
+    for (auto const &name: deleteThese) {
+        switch (name[5]) {
+            case ('_'): {
+                currentScore += 20;  // Kill easter egg, 30pts
+                health = maxHealth; // Thanks for killing that horrid thing
+            }
+            case ('1'): {
+                if (rand()%2 == 0) maxHealth += 5;
+                currentScore += 10;
+                break;
+            }
+            case ('2'): {
+                // 1/3 chance for big guy to lend a dash
+                if (rand()%3 == 0) maxDashes += 1;
+                currentScore += 15;
+                break;
+            }
+            case ('3'): {
+                // Coin flip on lil guy to lend a jump
+                if (rand()%2 == 0) maxJumps += 1;
+                currentScore += 10;
+                break;
             }
-            deleteThese.push_back(g.first);
         }
     }
     for (auto const &name : deleteThese) {
         deleteGameObject(name);
     }
-    return hit;
+    return !deleteThese.empty();
 }
 
 void debugCameraMovement(double dt) {
@@ -150,6 +150,7 @@ void debugCameraMovement(double dt) {
 }
 
 void gameCameraMovement(double dt) {
+    const JEColliderSet& worldColliders = getWorldColliders();
     if (mouseLocked) {
         glm::vec2 cursor = getRawCursorPos();
         setRawCursorPos({static_cast<float>(getCurrentWidth()) / 2.0f, static_cast<float>(getCurrentHeight()) / 2.0f});
@@ -172,26 +173,26 @@ void gameCameraMovement(double dt) {
         if (health > 0) {
             // Move forward
             if (isKeyDown(GLFW_KEY_W) &&
-                !pointCollidesWithAnyBoxes(cameraPtr->position + cameraPtr->direction() * vec3(3), worldBoxColliders)) {
+                !pointCollidesWithAnyBoxes(cameraPtr->position + cameraPtr->direction() * vec3(3), worldColliders)) {
                 cameraPtr->pos_vel += forward * glm::vec3(static_cast<float>(dt) * speed);
             }
             // Move backward
             if (isKeyDown(GLFW_KEY_S) &&
-                !pointCollidesWithAnyBoxes(cameraPtr->position - cameraPtr->direction() * vec3(3), worldBoxColliders)) {
+                !pointCollidesWithAnyBoxes(cameraPtr->position - cameraPtr->direction() * vec3(3), worldColliders)) {
                 cameraPtr->pos_vel -= forward * glm::vec3(static_cast<float>(dt) * speed);
             }
             // Strafe right
             if (isKeyDown(GLFW_KEY_D) &&
-                !pointCollidesWithAnyBoxes(cameraPtr->position + right * vec3(3), worldBoxColliders)) {
+                !pointCollidesWithAnyBoxes(cameraPtr->position + right * vec3(3), worldColliders)) {
                 cameraPtr->pos_vel += right * glm::vec3(static_cast<float>(dt) * speed);
             }
             // Strafe left
             if (isKeyDown(GLFW_KEY_A) &&
-                !pointCollidesWithAnyBoxes(cameraPtr->position - right * vec3(3), worldBoxColliders)) {
+                !pointCollidesWithAnyBoxes(cameraPtr->position - right * vec3(3), worldColliders)) {
                 cameraPtr->pos_vel -= right * glm::vec3(static_cast<float>(dt) * speed);
             }
 
-            if (jumpPressed && !pointCollidesWithAnyBoxes(cameraPtr->position + vec3(0, 0.5, 0), worldBoxColliders)) {
+            if (jumpPressed && !pointCollidesWithAnyBoxes(cameraPtr->position + vec3(0, 0.5, 0), worldColliders)) {
                 // Cancel falling
                 cameraPtr->pos_vel *= vec3(1, 0, 1);
                 // Add jump (NO DELTA TIME! SINGLE EVENT!)
@@ -230,9 +231,38 @@ void gameCameraMovement(double dt) {
     }
 }
 
-double healthRegenTimer = 0;
-double movementRegenTimer = 0;
+// Whether the player was standing on something as of the last physics tick, for the regen timers
+bool playerGrounded = false;
+
+// Health and movement come back on timers that keep going for good, only doing anything while standing
+void regenHealth(GameObject*) {
+    if (currentGameState == PLAYING && playerGrounded && health < maxHealth) health++;
+    scheduleAfter(0.05, &regenHealth);
+}
+
+void regenMovement(GameObject*) {
+    if (currentGameState == PLAYING && playerGrounded) {
+        if (jumpsLeft < maxJumps) jumpsLeft++;
+        if (dashesLeft < maxDashes) dashesLeft++;
+    }
+    scheduleAfter(0.1, &regenMovement);
+}
+
+// Contacts facing at least this far up (or down) count as floor, about 45 degrees
+const float groundNormalY = 0.7f;
+// Walls whose top is at most this far above the feet get stepped up onto
+const float stepHeight = 1.0f;
+// Snaps go this far past the surface, so a box sitting right on the one just left still catches the feet
+const float contactSkin = 0.001f;
+
+// Same slowdown snapping up used to apply every 0.001 units, for a whole snap at once
+vec3 stepSlowdown(float distance) {
+    float steps = distance / 0.001f;
+    return {std::pow(0.9999f, steps), std::pow(1.00002f, steps), std::pow(0.9999f, steps)};
+}
+
 void gameCameraPhysics(double dt) {
+    const JEColliderSet& worldColliders = getWorldColliders();
     // Step physics, mult with deltaTime
     cameraPtr->position += cameraPtr->pos_vel * vec3(dt);
 
@@ -243,37 +273,52 @@ void gameCameraPhysics(double dt) {
     if (feetPos.y < -23) {
         health = 0;
     }
-    // Modified world test to snap to top
-    for (auto const& box : worldBoxColliders){
-        bool feetCollided = false;
-        while (testPoint(feetPos, box) || testPoint(feetPos2, box)) {
-            feetCollided = true;
-            vec3 add = vec3(0, 0.001, 0) * vec3(cameraPtr->position.y > box.position.y-box.scale.y ? 1 : -1);
-            cameraPtr->position += add;
-            cameraPtr->pos_vel *= vec3(0.9999, 1.00002, 0.9999); // Depending on the step up size, slow accordingly
+    // Feet are the line from 3 to 2 below the camera. Each box they're in gets resolved in one go from its contact.
+    for (size_t batch = 0; batch < worldColliders.batchCount(); batch++) {
+        uint32_t hits = testPointBatch(worldColliders, batch, feetPos) | testPointBatch(worldColliders, batch, feetPos2);
+        while (hits) {
+            size_t box = batch * JE_COLLIDER_BATCH + std::countr_zero(hits);
+            hits &= hits - 1;
+            // Boxes before this one might've already moved the feet out of it, the deeper foot decides which way is out
+            JEContact contact{}, contact2{};
+            bool inside = pointContact(worldColliders, box, feetPos, contact);
+            bool inside2 = pointContact(worldColliders, box, feetPos2, contact2);
+            if (!inside && !inside2) continue;
+            if (!inside || (inside2 && contact2.depth > contact.depth)) contact = contact2;
+
+            float boxBottom = worldColliders.centerY[box] - worldColliders.halfY[box];
+            if (cameraPtr->position.y <= boxBottom) {
+                // Head's under it, so it's a ceiling
+                float down = std::max(exitDistance(worldColliders, box, feetPos, vec3(0, -1, 0)),
+                                      exitDistance(worldColliders, box, feetPos2, vec3(0, -1, 0)));
+                cameraPtr->position.y -= down + contactSkin;
+                cameraPtr->pos_vel *= stepSlowdown(down + contactSkin);
+                if (cameraPtr->pos_vel.y > 0) cameraPtr->pos_vel.y = 0;
+            } else {
+                float up = std::max(exitDistance(worldColliders, box, feetPos, vec3(0, 1, 0)),
+                                    exitDistance(worldColliders, box, feetPos2, vec3(0, 1, 0)));
+                if (std::abs(contact.normal.y) < groundNormalY && up > stepHeight) {
+                    // Wall, push straight out of it and stop going into it
+                    cameraPtr->position += contact.normal * contact.depth;
+                    float into = dot(cameraPtr->pos_vel, contact.normal);
+                    if (into < 0) cameraPtr->pos_vel -= contact.normal * into;
+                } else {
+                    // Floor, a ledge low enough to step onto, or a platform jumped up through. Snap to the top.
+                    cameraPtr->position.y += up + contactSkin;
+                    cameraPtr->pos_vel *= stepSlowdown(up + contactSkin);
+                    feetColliding = true;
+                }
+            }
             feetPos  = cameraPtr->position - vec3(0, 3, 0);
             feetPos2 = cameraPtr->position - vec3(0, 2, 0);
         }
-        feetColliding |= feetCollided;
     }
     if (!feetColliding) {
         cameraPtr->pos_vel -= vec3(0, gravity * dt, 0);
     } else if (cameraPtr->pos_vel.y < 0) {
         cameraPtr->pos_vel.y = 0;
     }
-    healthRegenTimer += dt;
-    movementRegenTimer += dt;
-    if (feetColliding) {
-        if (healthRegenTimer > 0.05) {
-            if (health < maxHealth) health++;
-            healthRegenTimer = 0;
-        }
-        if (movementRegenTimer > 0.1) {
-            if (jumpsLeft < maxJumps) jumpsLeft++;
-            if (dashesLeft < maxDashes) dashesLeft++;
-            movementRegenTimer = 0;
-        }
-    }
+    playerGrounded = feetColliding;
     float slowSpeed =     (feetColliding ? 0.9f : 0.95f);
     cameraPtr->pos_vel *= vec3(slowSpeed, 0.99, slowSpeed);
 }
@@ -406,21 +451,22 @@ void startWave() {
     instantiateRandomEnemyWave(enemiesMax_oops_duplicate_whatever);
 }
 
-double waveTimer = 0;
+JETimerID waveTimer = 0;
+void nextWave(GameObject*) {
+    waveTimer = 0;
+    if (currentGameState == PLAYING) startWave();
+}
+
+// Next wave 4 seconds after the last enemy of this one dies
 void waveUpdate(double dt) {
-    if (currentGameState == PLAYING) {
-        if (enemiesAlive == 0) {
-            waveTimer += dt;
-            if (waveTimer > 4) {
-                startWave();
-                waveTimer = 0;
-            }
-        }
-    }
+    if (currentGameState == PLAYING && enemiesAlive == 0 && waveTimer == 0) waveTimer = scheduleAfter(4, &nextWave);
 }
 
 void loadGameplay() {
     clearGameObjects();
+    // A wave from the last game that was about to start
+    cancelTimer(waveTimer);
+    waveTimer = 0;
     currentGameState = PLAYING;
     setInMenu(false);
     playRandomThematic();
@@ -454,6 +500,7 @@ void setupMap1() {
     loadMap1();
     worldBoxColliders = getMap1BoxColliders();
     initWorldBoxColliders(worldBoxColliders);
+    initWorldMeshColliders(getMap1MeshColliders());
 }
 
 void loadMap1GP() {
@@ -473,6 +520,7 @@ void setupMap2() {
     loadMap2();
     worldBoxColliders = getMap2BoxColliders();
     initWorldBoxColliders(worldBoxColliders);
+    initWorldMeshColliders({});
 }
 
 void loadMap2GP() {
@@ -553,7 +601,7 @@ void gameSetup(){
     programSettings3dToon.transparencySupported = false;
     programSettings3dToon.shaderInputCount = 4;
     programSettings3dToon.shaderInputs = JEShaderInputUniformBit | JEShaderInputUniformBit |  (JEShaderInputTextureBit << 2)  |  (JEShaderInputTextureBit << 3);
-    createShader("3dtoon", "./shaders/vertex3d.glsl", "./shaders/toon_textured.glsl", programSettings3dToon);
+    createShaderAsync("3dtoon", "./shaders/vertex3d.glsl", "./shaders/toon_textured.glsl", programSettings3dToon);
 
     JEShaderProgramSettings programSettingsUI{};
     programSettingsUI.testDepth = true;
@@ -562,7 +610,7 @@ void gameSetup(){
     programSettingsUI.shaderInputCount = 2;
     programSettingsUI.shaderInputs = JEShaderInputUniformBit | (JEShaderInputTextureBit << 1);
 
-    createShader("ui", "./shaders/vertex2d.glsl", "./shaders/frag_tex.glsl", programSettingsUI);
+    createShaderAsync("ui", "./shaders/vertex2d.glsl", "./shaders/frag_tex.glsl", programSettingsUI);
 
     JEShaderProgramSettings programSettingsPhysBox{};
     programSettingsPhysBox.testDepth = true;
@@ -570,19 +618,22 @@ void gameSetup(){
     programSettingsPhysBox.transparencySupported = true;
     programSettingsPhysBox.shaderInputCount = 1;
     programSettingsPhysBox.shaderInputs = JEShaderInputUniformBit;
-    createShader("physBox", "./shaders/vertex3d.glsl", "./shaders/phys_hi.glsl", programSettingsPhysBox);
+    createShaderAsync("physBox", "./shaders/vertex3d.glsl", "./shaders/phys_hi.glsl", programSettingsPhysBox);
 
     setSkyboxEnabled(false);
     setFOV(90.0f); // TODO settings panel
 
     // Init resources
     srand(time(nullptr)); // Seed RNG with unix time! Very important!
-    createTexture("crosshair", "./textures/crosshair.png", "./tex_bundle.jbd");
-    createTexture("empty_specmis", "./textures/empty_specmis.png", "./tex_bundle.jbd");
-    createTexture("unlit_specmis", "./textures/unlit_specmis.png", "./tex_bundle.jbd");
-    jumpSfx = Sound(vec3(0), vec3(0), "./sounds/jump.ogg",  false, 3, 0.1, 2, 0.25);
-    dashSfx = Sound(vec3(0), vec3(0), "./sounds/dash.ogg",  false, 3, 0.1, 2, 0.25);
-    hitSfx  = Sound(vec3(0), vec3(0), "./sounds/punch.ogg", false, 3, 0.1, 2, 0.25);
+    for (const char* sfx : {"./sounds/jump.ogg", "./sounds/dash.ogg", "./sounds/punch.ogg", "./sounds/gunfire0.ogg", "./sounds/gunfire1.ogg"}) {
+        preloadOgg(sfx, "./sound_bundle.jbd");
+    }
+    createTextureAsync("crosshair", "./textures/crosshair.png", "./tex_bundle.jbd");
+    createTextureAsync("empty_specmis", "./textures/empty_specmis.png", "./tex_bundle.jbd");
+    createTextureAsync("unlit_specmis", "./textures/unlit_specmis.png", "./tex_bundle.jbd");
+    jumpSfx = Sound(vec3(0), vec3(0), "./sounds/jump.ogg",  false, 3, 0.1, 2, 0.25, "./sound_bundle.jbd");
+    dashSfx = Sound(vec3(0), vec3(0), "./sounds/dash.ogg",  false, 3, 0.1, 2, 0.25, "./sound_bundle.jbd");
+    hitSfx  = Sound(vec3(0), vec3(0), "./sounds/punch.ogg", false, 3, 0.1, 2, 0.25, "./sound_bundle.jbd");
 
     // Call misc game init functions
     uiInit();
@@ -593,6 +644,8 @@ void gameSetup(){
     registerOnUpdate(&detectDeath);
     registerOnUpdate(&countEnemies);
     registerOnUpdate(&waveUpdate);
+    scheduleAfter(0.05, &regenHealth);
+    scheduleAfter(0.1, &regenMovement);
     registerOnKey(&lockUnlock);
     registerOnKey(&keyboardClicks);
     registerOnMouse(&shoot);
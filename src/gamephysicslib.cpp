@@ -20,8 +20,16 @@
     return t1.scale.x + t2.scale.x > distance(t1.position, t2.position);
 }
 
-[[nodiscard]] bool pointCollidesWithAnyBoxes(const vec3& point, const std::vector<Transform>& colliders) {
-    return std::ranges::any_of(colliders.cbegin(), colliders.cend(), [&point](const Transform& box) {return testPoint(point, box);});
+// Sphere moving from -> to against a still one, closest point on the line it moved along
+[[nodiscard]] bool testSweptSpheres(const glm::vec3& from, const glm::vec3& to, const float& r1, const glm::vec3& p2, const float& r2) {
+    glm::vec3 motion = to - from;
+    float length2 = dot(motion, motion);
+    float t = length2 > 0 ? clamp(dot(p2 - from, motion) / length2, 0.0f, 1.0f) : 0.0f;
+    return testSpheres(from + motion * t, r1, p2, r2);
+}
+
+[[nodiscard]] bool pointCollidesWithAnyBoxes(const vec3& point, const JEColliderSet& colliders) {
+    return pointHitsAnyCollider(colliders, point);
 }
 
 [[nodiscard]] bool sphereCollidesWithAnySpheres(const Transform& t1, const std::vector<Transform>& colliders) {
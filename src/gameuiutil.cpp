@@ -33,10 +33,10 @@ void uiInit() {
     buttonProgramSettings.shaderInputCount = 1;
     buttonProgramSettings.shaderInputs = JEShaderInputUniformBit;
 
-    createTexture("fontTexture", "./textures/game_font.bmp", "./tex_bundle.jbd");
+    createTextureAsync("fontTexture", "./textures/game_font.bmp", "./tex_bundle.jbd");
 
-    createShader("textShader", "./shaders/vertex2d_font.glsl", "./shaders/font_texture.glsl", fontProgramSettings);
-    createShader("buttonShader", "./shaders/vertex2d.glsl", "./shaders/frag_button.glsl", buttonProgramSettings);
+    createShaderAsync("textShader", "./shaders/vertex2d_font.glsl", "./shaders/font_texture.glsl", fontProgramSettings);
+    createShaderAsync("buttonShader", "./shaders/vertex2d.glsl", "./shaders/frag_button.glsl", buttonProgramSettings);
 }
 
 std::vector<Renderable> stringToRenderables(std::string str, vec3 color){
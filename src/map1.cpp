@@ -13,48 +13,52 @@ std::vector<Transform>& getMap1BoxColliders() {
     return map1BoxColliders;
 }
 
+// The actual level geometry, so bullets and sight lines stop on what's drawn instead of the boxes roughly around it.
+// Baked on job workers, nothing collides with them until they're done.
+std::vector<JEMeshColliderLoad> map1MeshColliders{};
+
+std::vector<JEMeshColliderLoad>& getMap1MeshColliders() {
+    return map1MeshColliders;
+}
+
 void g1(GameObject* self){
     self->transform.position = vec3(0, -5, 0);
     self->transform.scale = vec3(1.5);
-    std::vector<Renderable> oogaboogashitfuck2 = loadObj("./models/m1_geo_v2.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m1_geo"), getTexture("empty_specmis")});
-    for (const Renderable& r : oogaboogashitfuck2) { self->renderables.push_back(r);}
+    self->renderables.push_back(loadObjAsync("./models/m1_geo_v2.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m1_geo"), getTexture("empty_specmis")}));
+    map1MeshColliders.push_back(loadMeshColliderAsync("./models/m1_geo_v2.obj", self->transform));
 }
 
 void f1(GameObject* self){
     self->transform.position = vec3(0, -5, 0);
     self->transform.scale = vec3(1.5);
-    std::vector<Renderable> oogaboogashitfuck1 = loadObj("./models/m1_floor.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m1_floor"), getTexture("empty_specmis")});
+    self->renderables.push_back(loadObjAsync("./models/m1_floor.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m1_floor"), getTexture("empty_specmis")}));
+    map1MeshColliders.push_back(loadMeshColliderAsync("./models/m1_floor.obj", self->transform));
     //std::vector<Renderable> oogaboogashitfuck2 = loadObj("./models/m1_geo_v2.obj",   getProgram("3dtoon"), {getUBOID(), getLBOID(), getTexture("m1_geo"), getTexture("m1_geo_specmis")});
-    for (const Renderable& r : oogaboogashitfuck1) { self->renderables.push_back(r);}
     //for (const Renderable& r : oogaboogashitfuck2) { self->renderables.push_back(r);}
 }
 
 void f2(GameObject* self){
     self->transform.position = vec3(-42, -7.5, 0);
     self->transform.scale = vec3(1);
-    std::vector<Renderable> oogaboogashitfuck1 = loadObj("./models/m1_floor.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m1_floor"), getTexture("m1_floor_specmis")});
-    for (const Renderable& r : oogaboogashitfuck1) { self->renderables.push_back(r);}
+    self->renderables.push_back(loadObjAsync("./models/m1_floor.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m1_floor"), getTexture("m1_floor_specmis")}));
 }
 
 void f3(GameObject* self){
     self->transform.position = vec3(42, -7.5, 0);
     self->transform.scale = vec3(1);
-    std::vector<Renderable> oogaboogashitfuck1 = loadObj("./models/m1_floor.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m1_floor"), getTexture("m1_floor_specmis")});
-    for (const Renderable& r : oogaboogashitfuck1) { self->renderables.push_back(r);}
+    self->renderables.push_back(loadObjAsync("./models/m1_floor.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m1_floor"), getTexture("m1_floor_specmis")}));
 }
 
 void f4(GameObject* self){
     self->transform.position = vec3(0, 0, 42);
     self->transform.scale = vec3(1);
-    std::vector<Renderable> oogaboogashitfuck1 = loadObj("./models/m1_floor.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m1_floor"), getTexture("m1_floor_specmis")});
-    for (const Renderable& r : oogaboogashitfuck1) { self->renderables.push_back(r);}
+    self->renderables.push_back(loadObjAsync("./models/m1_floor.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m1_floor"), getTexture("m1_floor_specmis")}));
 }
 
 void f5(GameObject* self){
     self->transform.position = vec3(0, 0, -42);
     self->transform.scale = vec3(1);
-    std::vector<Renderable> oogaboogashitfuck1 = loadObj("./models/m1_floor.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m1_floor"), getTexture("m1_floor_specmis")});
-    for (const Renderable& r : oogaboogashitfuck1) { self->renderables.push_back(r);}
+    self->renderables.push_back(loadObjAsync("./models/m1_floor.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m1_floor"), getTexture("m1_floor_specmis")}));
 }
 
 
@@ -75,28 +79,28 @@ void volcanoProp1(GameObject* self) {
     self->transform.position = glm::vec3(-400.000000, 0.000000, 0.000000);
     self->transform.rotation = glm::vec3(0.000000, 90.000000, 0.000000);
     self->transform.scale    = glm::vec3(75.000000, 50.000000, 75.000000);
-    self->renderables.push_back(loadObj("./models/volcano_prop.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m1_volcaner"), getTexture("m1_volcaner_specmis")})[0]);
+    self->renderables.push_back(loadObjAsync("./models/volcano_prop.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m1_volcaner"), getTexture("m1_volcaner_specmis")}));
 }
 
 void volcanoProp2(GameObject* self) {
     self->transform.position = glm::vec3(-200.000000, 0.000000, 500.000000);
     self->transform.rotation = glm::vec3(0.000000, -45.000000, 0.000000);
     self->transform.scale    = glm::vec3(50.000000, 75.000000, 50.000000);
-    self->renderables.push_back(loadObj("./models/volcano_prop.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m1_volcaner"), getTexture("m1_volcaner_specmis")})[0]);
+    self->renderables.push_back(loadObjAsync("./models/volcano_prop.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m1_volcaner"), getTexture("m1_volcaner_specmis")}));
 }
 
 void volcanoProp3(GameObject* self) {
     self->transform.position = glm::vec3(400.000000, 0.000000, 300.000000);
     self->transform.rotation = glm::vec3(0.000000, -89.000000, 0.000000);
     self->transform.scale    = glm::vec3(60.000000, 60.000000, 60.000000);
-    self->renderables.push_back(loadObj("./models/volcano_prop.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m1_volcaner"), getTexture("m1_volcaner_specmis")})[0]);
+    self->renderables.push_back(loadObjAsync("./models/volcano_prop.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m1_volcaner"), getTexture("m1_volcaner_specmis")}));
 }
 
 void volcanoProp4(GameObject* self) {
     self->transform.position = glm::vec3(90.000000, 0.000000, -300.000000);
     self->transform.rotation = glm::vec3(0.000000, 180.000000, 0.000000);
     self->transform.scale    = glm::vec3(60.000000, 60.000000, 60.000000);
-    self->renderables.push_back(loadObj("./models/volcano_prop.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m1_volcaner"), getTexture("m1_volcaner_specmis")})[0]);
+    self->renderables.push_back(loadObjAsync("./models/volcano_prop.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m1_volcaner"), getTexture("m1_volcaner_specmis")}));
 }
 // Auto generated physbox gameobjects
 void floor1_phys_box(GameObject* self){
@@ -105,7 +109,7 @@ void floor1_phys_box(GameObject* self){
     self->transform.scale    = glm::vec3(17.000000, 0.700000, 17.000000);
     map1BoxColliders.push_back(self->transform);
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 
@@ -115,7 +119,7 @@ void floor2_phys_box(GameObject* self){
     self->transform.scale    = glm::vec3(11.33333, 0.700000, 11.33333);
     map1BoxColliders.push_back(self->transform);
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 
@@ -125,7 +129,7 @@ void floor3_phys_box(GameObject* self){
     self->transform.scale    = glm::vec3(11.33333, 0.700000, 11.33333);
     map1BoxColliders.push_back(self->transform);
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 
@@ -135,7 +139,7 @@ void floor4_phys_box(GameObject* self){
     self->transform.scale    = glm::vec3(11.33333, 0.700000, 11.33333);
     map1BoxColliders.push_back(self->transform);
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 
@@ -145,7 +149,7 @@ void floor5_phys_box(GameObject* self){
     self->transform.scale    = glm::vec3(11.33333, 0.700000, 11.33333);
     map1BoxColliders.push_back(self->transform);
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 
@@ -155,7 +159,7 @@ void small_block_phys_box(GameObject* self){
     self->transform.scale    = glm::vec3(1.500000, 1.200000, 1.500000);
     map1BoxColliders.push_back(self->transform);
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 void med1_block_phys_box(GameObject* self){
@@ -164,7 +168,7 @@ void med1_block_phys_box(GameObject* self){
     self->transform.scale    = glm::vec3(1.400000, 2.300000, 1.500000);
     map1BoxColliders.push_back(self->transform);
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 void med2_block_phys_box(GameObject* self){
@@ -173,7 +177,7 @@ void med2_block_phys_box(GameObject* self){
     self->transform.scale    = glm::vec3(1.500000, 5.000000, 1.500000);
     map1BoxColliders.push_back(self->transform);
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 void tall_block_phys_box(GameObject* self){
@@ -182,7 +186,7 @@ void tall_block_phys_box(GameObject* self){
     self->transform.scale    = glm::vec3(1.450000, 7.000000, 1.450000);
     map1BoxColliders.push_back(self->transform);
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 void small_ramp_phys_box(GameObject* self){
@@ -191,7 +195,7 @@ void small_ramp_phys_box(GameObject* self){
     self->transform.scale    = glm::vec3(2.100000, 1.200000, 1.500000);
     map1BoxColliders.push_back(self->transform);
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 void elevated_phys_box(GameObject* self){
@@ -200,7 +204,7 @@ void elevated_phys_box(GameObject* self){
     self->transform.scale    = glm::vec3(16.299999, 5.000000, 2.600000);
     map1BoxColliders.push_back(self->transform);
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 void overhang_phys_box(GameObject* self){
@@ -209,7 +213,7 @@ void overhang_phys_box(GameObject* self){
     self->transform.scale    = glm::vec3(16.299999, 2.800000, 0.900000);
     map1BoxColliders.push_back(self->transform);
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 void big_ramp_phys_box(GameObject* self){
@@ -218,7 +222,7 @@ void big_ramp_phys_box(GameObject* self){
     self->transform.scale    = glm::vec3(4.000000, 4.000000, 13.000000);
     map1BoxColliders.push_back(self->transform);
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 void chunk_base_phys_box(GameObject* self){
@@ -227,7 +231,7 @@ void chunk_base_phys_box(GameObject* self){
     self->transform.scale    = glm::vec3(8.200000, 3.150000, 2.430000);
     map1BoxColliders.push_back(self->transform);
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 void chunk_tall_phys_box(GameObject* self){
@@ -236,11 +240,12 @@ void chunk_tall_phys_box(GameObject* self){
     self->transform.scale    = glm::vec3(3.950000, 1.300000, 3.600000);
     map1BoxColliders.push_back(self->transform);
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 
 void loadMap1(){
+    map1MeshColliders.clear();
     /* Moved to lava GameObject to prevent lighting early initialization
     setSunProperties(glm::vec3(0, -1, 0), glm::vec3(0.5f, 0.45f, 0.2f));
     setAmbient(0.0025f, 0.001f, 0.0005f);
@@ -249,12 +254,12 @@ void loadMap1(){
     setFogPlanes(-20, 500);
      */
 
-    createTexture("m1_floor",                   "./textures/m1_floor.png", "./tex_bundle.jbd");
+    createTextureAsync("m1_floor",                   "./textures/m1_floor.png", "./tex_bundle.jbd");
     //createTexture("m1_floor_specmis",           "./textures/m1_floor_specmis.png");
-    createTexture("m1_geo",                     "./textures/m1_geo.png", "./tex_bundle.jbd");
-    createTexture("m1_lava",                    "./textures/better_moldy_fanta.png", "./tex_bundle.jbd");
-    createTexture("m1_volcaner",                "./textures/volcaner_tex.png", "./tex_bundle.jbd");
-    createTexture("m1_volcaner_specmis",        "./textures/volcaner_specmis.png", "./tex_bundle.jbd");
+    createTextureAsync("m1_geo",                     "./textures/m1_geo.png", "./tex_bundle.jbd");
+    createTextureAsync("m1_lava",                    "./textures/better_moldy_fanta.png", "./tex_bundle.jbd");
+    createTextureAsync("m1_volcaner",                "./textures/volcaner_tex.png", "./tex_bundle.jbd");
+    createTextureAsync("m1_volcaner_specmis",        "./textures/volcaner_specmis.png", "./tex_bundle.jbd");
 
     putGameObject("geo1",               GameObject(&g1));
     putGameObject("floor1",             GameObject(&f1));
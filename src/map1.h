@@ -6,8 +6,10 @@
 #define JOSHENGINE_MAP1_H
 #include <vector>
 #include "engine/engine.h"
+#include "engine/phys/meshcolliderutil.h"
 
 void loadMap1();
 std::vector<Transform>& getMap1BoxColliders();
+std::vector<JEMeshColliderLoad>& getMap1MeshColliders();
 
 #endif //JOSHENGINE_MAP1_H
\ No newline at end of file
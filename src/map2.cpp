@@ -38,9 +38,9 @@ void walkboard0(GameObject* self){
     self->transform.rotation = glm::vec3(0.000000, 76.000000, 0.000000);
     self->transform.scale    = glm::vec3(1.500000, 0.250000, 7.000000);
     map2BoxColliders.push_back(self->transform);
-    self->renderables.push_back(loadObj("./models/plank_cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_walkboard"), getTexture("empty_specmis")})[0]);
+    self->renderables.push_back(loadObjAsync("./models/plank_cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_walkboard"), getTexture("empty_specmis")}));
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 
@@ -49,9 +49,9 @@ void walkboard1(GameObject* self){
     self->transform.rotation = glm::vec3(90.000000, 50.000000, 90.000000);
     self->transform.scale    = glm::vec3(2.000000, 0.500000, 8.000000);
     map2BoxColliders.push_back(self->transform);
-    self->renderables.push_back(loadObj("./models/plank_cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_walkboard"), getTexture("empty_specmis")})[0]);
+    self->renderables.push_back(loadObjAsync("./models/plank_cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_walkboard"), getTexture("empty_specmis")}));
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 
@@ -60,9 +60,9 @@ void building0_0(GameObject* self){
     self->transform.rotation = glm::vec3(0.000000, 0.000000, 0.000000);
     self->transform.scale    = glm::vec3(10.000000, 20.000000, 10.000000);
     map2BoxColliders.push_back(self->transform);
-    self->renderables.push_back(loadObj("./models/cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_building0"), getTexture("empty_specmis")})[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_building0"), getTexture("empty_specmis")}));
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 
@@ -71,9 +71,9 @@ void building0_1(GameObject* self){
     self->transform.rotation = glm::vec3(0.000000, 0.000000, 0.000000);
     self->transform.scale    = glm::vec3(10.000000, 40.000000, 10.000000);
     map2BoxColliders.push_back(self->transform);
-    self->renderables.push_back(loadObj("./models/cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_building0"), getTexture("empty_specmis")})[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_building0"), getTexture("empty_specmis")}));
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 
@@ -82,9 +82,9 @@ void building0_2(GameObject* self){
     self->transform.rotation = glm::vec3(0.000000, 0.000000, 0.000000);
     self->transform.scale    = glm::vec3(10.000000, 40.000000, 10.000000);
     map2BoxColliders.push_back(self->transform);
-    self->renderables.push_back(loadObj("./models/cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_building0"), getTexture("empty_specmis")})[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_building0"), getTexture("empty_specmis")}));
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 
@@ -93,9 +93,9 @@ void building0_3(GameObject* self){
     self->transform.rotation = glm::vec3(0.000000, 0.000000, 0.000000);
     self->transform.scale    = glm::vec3(10.000000, 50.000000, 10.000000);
     map2BoxColliders.push_back(self->transform);
-    self->renderables.push_back(loadObj("./models/cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_building0"), getTexture("empty_specmis")})[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_building0"), getTexture("empty_specmis")}));
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 
@@ -104,9 +104,9 @@ void building1_0(GameObject* self){
     self->transform.rotation = glm::vec3(0.000000, 0.000000, 0.000000);
     self->transform.scale    = glm::vec3(10.000000, 20.000000, 10.000000);
     map2BoxColliders.push_back(self->transform);
-    self->renderables.push_back(loadObj("./models/cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_building1"), getTexture("m2_building1_specmis")})[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_building1"), getTexture("m2_building1_specmis")}));
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 
@@ -115,9 +115,9 @@ void building1_1(GameObject* self){
     self->transform.rotation = glm::vec3(0.000000, 0.000000, 0.000000);
     self->transform.scale    = glm::vec3(10.000000, 20.000000, 10.000000);
     map2BoxColliders.push_back(self->transform);
-    self->renderables.push_back(loadObj("./models/cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_building1"), getTexture("m2_building1_specmis")})[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_building1"), getTexture("m2_building1_specmis")}));
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 
@@ -126,9 +126,9 @@ void building1_2(GameObject* self){
     self->transform.rotation = glm::vec3(0.000000, 0.000000, 0.000000);
     self->transform.scale    = glm::vec3(10.000000, 20.000000, 10.000000);
     map2BoxColliders.push_back(self->transform);
-    self->renderables.push_back(loadObj("./models/cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_building1"), getTexture("m2_building1_specmis")})[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_building1"), getTexture("m2_building1_specmis")}));
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 
@@ -137,9 +137,9 @@ void building1_3(GameObject* self){
     self->transform.rotation = glm::vec3(0.000000, 0.000000, 0.000000);
     self->transform.scale    = glm::vec3(10.000000, 20.000000, 10.000000);
     map2BoxColliders.push_back(self->transform);
-    self->renderables.push_back(loadObj("./models/cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_building1"), getTexture("m2_building1_specmis")})[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_building1"), getTexture("m2_building1_specmis")}));
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 
@@ -148,9 +148,9 @@ void building1_4(GameObject* self){
     self->transform.rotation = glm::vec3(0.000000, 0.000000, 0.000000);
     self->transform.scale    = glm::vec3(10.000000, 20.000000, 10.000000);
     map2BoxColliders.push_back(self->transform);
-    self->renderables.push_back(loadObj("./models/cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_building1"), getTexture("m2_building1_specmis")})[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getShader("3dtoon"), {getUBOID(), getLBOID(), getTexture("m2_building1"), getTexture("m2_building1_specmis")}));
 #ifdef SHOW_COLLIDER
-    self->renderables.push_back(loadObj("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true)[0]);
+    self->renderables.push_back(loadObjAsync("./models/cube.obj", getProgram("physBox"), {getUBOID()}, true));
 #endif
 }
 
@@ -163,11 +163,11 @@ void loadMap2(){
     setFogPlanes(10, 80);
      */
 
-    createTexture("m2_walkboard",        "./textures/m2_walkboard.png", "./tex_bundle.jbd");
-    createTexture("m2_building0",        "./textures/m2_building0.png", "./tex_bundle.jbd");
-    createTexture("m2_building1",        "./textures/m2_building1.png", "./tex_bundle.jbd");
-    createTexture("m2_building1_specmis","./textures/m2_building1_specmis.png", "./tex_bundle.jbd");
-    createTexture("m2_ground",           "./textures/m2_ground.png", "./tex_bundle.jbd");
+    createTextureAsync("m2_walkboard",        "./textures/m2_walkboard.png", "./tex_bundle.jbd");
+    createTextureAsync("m2_building0",        "./textures/m2_building0.png", "./tex_bundle.jbd");
+    createTextureAsync("m2_building1",        "./textures/m2_building1.png", "./tex_bundle.jbd");
+    createTextureAsync("m2_building1_specmis","./textures/m2_building1_specmis.png", "./tex_bundle.jbd");
+    createTextureAsync("m2_ground",           "./textures/m2_ground.png", "./tex_bundle.jbd");
 
     putGameObject("ground",       GameObject(&ground0));
     putGameObject("ground_under", GameObject(&ground1));
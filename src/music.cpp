@@ -7,20 +7,21 @@
 #include "engine/engine.h"
 #include "engine/sound/audioutil.h"
 
-std::vector<Sound> musicTracks{};
+// Streamed straight out of the bundle, so nothing gets decoded until a track actually plays.
+std::vector<StreamedSound> musicTracks{};
 
 void initMusic() {
-    musicTracks.emplace_back(vec3(0), vec3(0), "./sounds/automated-serenade.ogg", true, 3, 0.1, 2, 0.25);
-    musicTracks.emplace_back(vec3(0), vec3(0), "./sounds/slep.ogg", true, 3, 0.1, 2, 0.25);
+    musicTracks.emplace_back("./sounds/automated-serenade.ogg", true, 0.25, "./sound_bundle.jbd");
+    musicTracks.emplace_back("./sounds/slep.ogg", true, 0.25, "./sound_bundle.jbd");
 
-    musicTracks.emplace_back(vec3(0), vec3(0), "./sounds/real-stuff.ogg", true, 3, 0.1, 2, 0.25);
-    musicTracks.emplace_back(vec3(0), vec3(0), "./sounds/numis.ogg", true, 3, 0.1, 2, 0.25);
-    musicTracks.emplace_back(vec3(0), vec3(0), "./sounds/rush-hour.ogg", true, 3, 0.1, 2, 0.25);
-    musicTracks.emplace_back(vec3(0), vec3(0), "./sounds/clapstrike.ogg", true, 3, 0.1, 2, 0.25);
+    musicTracks.emplace_back("./sounds/real-stuff.ogg", true, 0.25, "./sound_bundle.jbd");
+    musicTracks.emplace_back("./sounds/numis.ogg", true, 0.25, "./sound_bundle.jbd");
+    musicTracks.emplace_back("./sounds/rush-hour.ogg", true, 0.25, "./sound_bundle.jbd");
+    musicTracks.emplace_back("./sounds/clapstrike.ogg", true, 0.25, "./sound_bundle.jbd");
 }
 
 void playTrack(MusicTrack track) {
-    for (auto t : musicTracks) {
+    for (const auto& t : musicTracks) {
         if (t.isPlaying()) t.stop(); // Just in case
     }
     musicTracks[track].play();
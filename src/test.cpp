@@ -175,19 +175,19 @@ void setupTest() {
     a.shaderInputs = JEShaderInputUniformBit | (JEShaderInputUniformBit << 1);
     a.shaderInputCount = 2;
 
-    createShader("toonNorm", "./shaders/vertex3d.glsl", "./shaders/toon_normals.glsl", a);
-    createShader("bnphColor", "./shaders/vertex3d.glsl", "./shaders/blinn-phong_color.glsl", a);
+    createShaderAsync("toonNorm", "./shaders/vertex3d.glsl", "./shaders/toon_normals.glsl", a);
+    createShaderAsync("bnphColor", "./shaders/vertex3d.glsl", "./shaders/blinn-phong_color.glsl", a);
 
     //               This means the layout will be {Uniform, Texture}.
     a.shaderInputs = JEShaderInputUniformBit | (JEShaderInputTextureBit << 1);
 
-    createShader("ui", "./shaders/vertex2d.glsl", "./shaders/frag_tex.glsl", a);
+    createShaderAsync("ui", "./shaders/vertex2d.glsl", "./shaders/frag_tex.glsl", a);
 
     //               This layout is {Uniform, Uniform, Texture}.
     a.shaderInputs = JEShaderInputUniformBit | (JEShaderInputUniformBit << 1) | (JEShaderInputTextureBit << 2);
     a.shaderInputCount = 3;
 
-    createShader("bnphTexture", "./shaders/vertex3d.glsl", "./shaders/blinn-phong_textured.glsl", a);
+    createShaderAsync("bnphTexture", "./shaders/vertex3d.glsl", "./shaders/blinn-phong_textured.glsl", a);
 
     JEShaderProgramSettings b{};
     b.testDepth = true;
@@ -195,7 +195,7 @@ void setupTest() {
     b.doubleSided = true;
     b.shaderInputs = JEShaderInputUniformBit | (JEShaderInputTextureBit << 1);
     b.shaderInputCount = 2;
-    createShader("basicTexture", "./shaders/vertex3d.glsl", "./shaders/frag_tex_transparent.glsl", b);
+    createShaderAsync("basicTexture", "./shaders/vertex3d.glsl", "./shaders/frag_tex_transparent.glsl", b);
 
     createTexture("uv_tex.png", "./textures/uv_tex.png");
     createTexture("logo.png", "./textures/logo.png");